@@ -49,7 +49,7 @@ except Exception:  # pragma: no cover
 
 from . import speechPlayer
 from ._dll_utils import findDllDir
-from ._frontend import NvspFrontend
+from ._frontend import IPAClause, NvspFrontend
 
 # --- nvspFrontend.dll (IPA -> Frames) ---
 #
@@ -195,6 +195,8 @@ voices = {
     "David": {
         "voicePitch_mul": 0.75,
         "endVoicePitch_mul": 0.75,
+        "midVoicePitch1_mul": 0.75,
+        "midVoicePitch2_mul": 0.75,
         "cf1_mul": 0.75,
         "cf2_mul": 0.85,
         "cf3_mul": 0.85,
@@ -372,21 +374,15 @@ class _AudioThread(threading.Thread):
 
             while self._keepAlive and self.isSpeaking:
                 try:
-                    data = self._player.synthesize(8192)
+                    # Rendered straight into a bytes object when the native extension is present, so nvwave gets it without a copy.
+                    audioBytes = self._player.synthesizeBytes(8192)
                 except Exception:
                     if not self._synthErrorLogged:
                         log.error("nvSpeechPlayer: speechPlayer.synthesize failed", exc_info=True)
                         self._synthErrorLogged = True
                     break
 
-                if data:
-                    n = int(getattr(data, "length", 0) or 0)
-                    if n <= 0:
-                        continue
-
-                    nbytes = n * ctypes.sizeof(ctypes.c_short)
-                    audioBytes = ctypes.string_at(ctypes.addressof(data), nbytes)
-
+                if audioBytes:
                     idx = int(self._player.getLastIndex())
                     s = self._synthRef()
 
@@ -624,6 +620,22 @@ class SynthDriver(SynthDriver):
             # However, on x64 this can cause access violations.
             log.debug("nvSpeechPlayer: failed to configure espeak_TextToPhonemes prototype", exc_info=True)
 
+        # Let the frontend chunk and phonemize text itself, through NVDA's already
+        # initialized eSpeak library, so each block of text is one native call.
+        # Falls back to phonemizing in Python if the library can't be shared.
+        self._nativeTextInput = False
+        try:
+            espeakPath = getattr(getattr(_espeak, "espeakDLL", None), "_name", None)
+            if espeakPath:
+                self._nativeTextInput = self._frontend.setPhonemizer(
+                    "espeak", path=espeakPath, phonemeMode=self._ESPEAK_PHONEME_MODE
+                )
+                if not self._nativeTextInput:
+                    log.debug(f"nvSpeechPlayer: frontend text input unavailable: {self._frontend.getLastError()}")
+        except Exception:
+            log.debug("nvSpeechPlayer: failed to set up frontend text input", exc_info=True)
+            self._nativeTextInput = False
+
         self._language = "en-us"
         self._curPitch = 50
         self._curVoice = "Adam"
@@ -758,6 +770,7 @@ class SynthDriver(SynthDriver):
                 for cand in candidates:
                     try:
                         if self._frontend.setLanguage(cand):
+                            self._noteFrontendPackLoaded(cand)
                             loaded = True
                             break
                     except Exception:
@@ -843,6 +856,7 @@ class SynthDriver(SynthDriver):
             try:
                 if self._frontend.setLanguage(cand):
                     self._frontendLangTag = cand
+                    self._noteFrontendPackLoaded(cand)
                     return True
             except Exception:
                 log.debug("nvSpeechPlayer: frontend.setLanguage failed for %r", cand, exc_info=True)
@@ -869,6 +883,42 @@ class SynthDriver(SynthDriver):
                 log.debug("nvSpeechPlayer: could not refresh language-pack cache after reload", exc_info=True)
         return ok
 
+    def _noteFrontendPackLoaded(self, tag: str) -> None:
+        """Remember which pack files the frontend just loaded (see getResidentLangPackSettings)."""
+        try:
+            from . import langPackYaml
+
+            packsDir = getattr(self, "_packsDir", None)
+            self._frontendPackSig = langPackYaml.langChainSignature(packsDir, tag) if packsDir else None
+        except Exception:
+            log.debug("nvSpeechPlayer: could not stat language-pack files", exc_info=True)
+            self._frontendPackSig = None
+
+    def getResidentLangPackSettings(self, langTag: str | None = None) -> dict | None:
+        """Return {key: (value, sourceTag)} from the packs the frontend has loaded.
+
+        Returns None when the frontend has a different language loaded, or when
+        the pack files changed on disk since it loaded them; callers should
+        then fall back to reading the YAML.
+        """
+        fe = getattr(self, "_frontend", None)
+        packsDir = getattr(self, "_packsDir", None)
+        if not fe or not packsDir:
+            return None
+        try:
+            from . import langPackYaml
+
+            tag = langPackYaml.normalizeLangTag(langTag or self._getCurrentLangTag())
+            if fe.langTag != tag:
+                return None
+            sig = getattr(self, "_frontendPackSig", None)
+            if sig is None or langPackYaml.langChainSignature(packsDir, tag) != sig:
+                return None
+            return fe.enumerateSettings()
+        except Exception:
+            log.debug("nvSpeechPlayer: could not read settings from the frontend", exc_info=True)
+            return None
+
     def _refreshLangPackSettingsCache(self) -> None:
         """Rebuild the cached effective YAML ``settings:`` map for the current language."""
         try:
@@ -879,10 +929,14 @@ class SynthDriver(SynthDriver):
                 self._langPackSettingsCache = {}
                 return
 
-            self._langPackSettingsCache = langPackYaml.getEffectiveSettings(
-                packsDir=packsDir,
-                langTag=self._getCurrentLangTag(),
-            )
+            resident = self.getResidentLangPackSettings()
+            if resident is not None:
+                self._langPackSettingsCache = {k: v for k, (v, _src) in resident.items()}
+            else:
+                self._langPackSettingsCache = langPackYaml.getEffectiveSettings(
+                    packsDir=packsDir,
+                    langTag=self._getCurrentLangTag(),
+                )
 
             # Clear previous error key on success.
             if getattr(self, "_lastLangPackCacheErrorKey", None) is not None:
@@ -963,8 +1017,11 @@ class SynthDriver(SynthDriver):
                 key=key,
                 value=value,
             )
-            # Reload so the frontend re-reads updated YAML.
-            self.reloadLanguagePack(langTag)
+            # Apply the new value to the loaded pack directly when possible;
+            # otherwise reload so the frontend re-reads the updated YAML.
+            fe = getattr(self, "_frontend", None)
+            if not (fe and fe.langTag == langTag and fe.overrideSetting(key, value)):
+                self.reloadLanguagePack(langTag)
         except Exception:
             log.error("nvSpeechPlayer: failed to update language-pack setting %s", key, exc_info=True)
 
@@ -1258,6 +1315,7 @@ class SynthDriver(SynthDriver):
         # (This is a user setting; reading it once avoids repeated getattr lookups
         # in the hot path and keeps pauses consistent within a single speak call.)
         pauseMode = str(getattr(self, "_pauseMode", "short") or "short").strip().lower()
+        nativeTextInput = bool(getattr(self, "_nativeTextInput", False))
 
         def _punctuationPauseMs(punctToken: str | None) -> float:
             """Return the pause duration in ms for a punctuation token.
@@ -1292,8 +1350,12 @@ class SynthDriver(SynthDriver):
             return 0.0
 
         for (text, indexesAfter, blockPitchOffset) in blocks:
-            # Speak text for this block.
-            if text:
+            # Convert every clause of the block to IPA first, then queue them all with
+            # one frontend call instead of one call per clause. With native text input
+            # the frontend does the clause splitting, phonemizing and punctuation pauses.
+            clauses = []
+            clausePauseMs = []
+            if text and not nativeTextInput:
                 for chunk in re_textPause.split(text):
                     if not chunk:
                         continue
@@ -1321,153 +1383,174 @@ class SynthDriver(SynthDriver):
                     else:
                         clauseType = None
 
-                    punctPauseMs = _punctuationPauseMs(punctToken)
-
                     ipaText = self._espeakTextToIPA(chunk)
                     if not ipaText:
                         # Nothing speakable, but don't drop indexes (they are queued after the block).
                         continue
 
-                    pitch = float(self._curPitch) + float(blockPitchOffset)
-                    basePitch = 25.0 + (21.25 * (pitch / 12.5))
-
-                    # nvspFrontend.dll: IPA -> frames.
-                    queuedCount = 0
-
-                    # Some generators (including nvspFrontend) may emit an initial silence
-                    # frame for each queued utterance. When NVDA feeds us multiple chunks
-                    # back-to-back (e.g. Say All reading "visual" lines), that redundant
-                    # leading silence can become a perceptible pause. Once we've already
-                    # queued real speech for this speak operation (or we're appending to
-                    # existing output), suppress those leading silence frames.
-                    suppressLeadingSilence = hadRealSpeech or bool(getattr(self._audio, "isSpeaking", False))
-                    sawRealFrameInThisUtterance = False
-                    sawSilenceAfterVoice = False
-
-                    # Pre-calculate extra parameter multipliers once per utterance.
-                    # This avoids repeated getattr(self, f"speechPlayer_{p}") lookups on every frame.
-                    extraParamMultipliers = ()
-                    if self.exposeExtraParams:
+                    clauses.append(IPAClause(ipaText, clauseType))
+                    clausePauseMs.append(_punctuationPauseMs(punctToken))
+
+            # Speak text for this block.
+            if clauses or (text and nativeTextInput):
+                pitch = float(self._curPitch) + float(blockPitchOffset)
+                basePitch = 25.0 + (21.25 * (pitch / 12.5))
+
+                # Pre-calculate extra parameter multipliers once per block.
+                # This avoids repeated getattr(self, f"speechPlayer_{p}") lookups on every frame.
+                extraParamMultipliers = ()
+                if self.exposeExtraParams:
+                    try:
+                        names = getattr(self, "_extraParamNames", ()) or ()
+                        attrNames = getattr(self, "_extraParamAttrNames", None)
+                        if not attrNames or len(attrNames) != len(names):
+                            attrNames = [f"speechPlayer_{x}" for x in names]
+
+                        pairs = []
+                        for paramName, attrName in zip(names, attrNames):
+                            try:
+                                ratio = float(getattr(self, attrName, 50)) / 50.0
+                            except Exception:
+                                continue
+                            # Skip default (ratio=1.0) to keep the per-frame hot path tiny.
+                            if ratio != 1.0:
+                                pairs.append((paramName, ratio))
+
+                        extraParamMultipliers = tuple(pairs)
+                    except Exception:
+                        extraParamMultipliers = ()
+
+                # Per-clause state. The frontend tags each frame with its clause index, so
+                # a change of index marks the end of one clause and the start of the next.
+                curClause = -1
+                queuedCount = 0
+                suppressLeadingSilence = False
+                sawRealFrameInThisUtterance = False
+                sawSilenceAfterVoice = False
+
+                def _endClause():
+                    nonlocal lastStreamWasVoiced
+                    # Optional punctuation pause (micro-silence) after the clause.
+                    # Insert only when we actually queued a voiced frame; otherwise we'd
+                    # be adding silence after silence.
+                    punctPauseMs = clausePauseMs[curClause] if curClause < len(clausePauseMs) else 0.0
+                    if queuedCount > 0 and punctPauseMs and sawRealFrameInThisUtterance:
                         try:
-                            names = getattr(self, "_extraParamNames", ()) or ()
-                            attrNames = getattr(self, "_extraParamAttrNames", None)
-                            if not attrNames or len(attrNames) != len(names):
-                                attrNames = [f"speechPlayer_{x}" for x in names]
-
-                            pairs = []
-                            for paramName, attrName in zip(names, attrNames):
-                                try:
-                                    ratio = float(getattr(self, attrName, 50)) / 50.0
-                                except Exception:
-                                    continue
-                                # Skip default (ratio=1.0) to keep the per-frame hot path tiny.
-                                if ratio != 1.0:
-                                    pairs.append((paramName, ratio))
-
-                            extraParamMultipliers = tuple(pairs)
+                            dur = float(min(float(punctPauseMs), 20.0))
+                            fd = float(min(float(minFadeOutMs), dur))
+                            self._player.queueFrame(None, dur, fd)
+                            lastStreamWasVoiced = False
                         except Exception:
-                            extraParamMultipliers = ()
-
-                    def _onFrame(framePtr, frameDuration, fadeDuration, idxToSet):
-                        nonlocal queuedCount, hadRealSpeech, sawRealFrameInThisUtterance, sawSilenceAfterVoice, lastStreamWasVoiced
-
-                        # Reduce redundant *leading* silence frames to reduce gaps between
-                        # consecutive chunks/lines.
-                        # Fully dropping them can cause audible pops on some systems, so keep a
-                        # tiny slice instead.
-                        if (not framePtr) and suppressLeadingSilence and (not sawRealFrameInThisUtterance):
-                            dur = min(float(frameDuration), float(leadingSilenceMs))
-                            if dur > 0:
-                                self._player.queueFrame(
-                                    None,
-                                    dur,
-                                    min(float(fadeDuration), dur),
-                                    userIndex=idxToSet,
-                                )
-                                queuedCount += 1
-                                lastStreamWasVoiced = False
-                            return
-
-                        # If this is a silence frame, queue it as a pause (NULL frame pointer).
-                        if not framePtr:
-                            # First silence *after* voiced audio: ensure a tiny ramp-down.
-                            if sawRealFrameInThisUtterance and (not sawSilenceAfterVoice):
-                                fd = max(float(fadeDuration), float(minFadeOutMs))
-                                # Fade can't be longer than the silence frame itself.
-                                if float(frameDuration) > 0:
-                                    fd = min(fd, float(frameDuration))
-                                else:
-                                    fd = 0.0
-                                fadeDuration = fd
-                                sawSilenceAfterVoice = True
-
-                            self._player.queueFrame(None, frameDuration, fadeDuration, userIndex=idxToSet)
+                            log.debug("nvSpeechPlayer: failed inserting punctuation pause", exc_info=True)
+
+                def _onFrame(clauseIdx, framePtr, frameDuration, fadeDuration):
+                    nonlocal curClause, queuedCount, suppressLeadingSilence, hadRealSpeech
+                    nonlocal sawRealFrameInThisUtterance, sawSilenceAfterVoice, lastStreamWasVoiced
+
+                    if clauseIdx != curClause:
+                        if curClause >= 0:
+                            _endClause()
+                        curClause = clauseIdx
+                        queuedCount = 0
+                        # Some generators (including nvspFrontend) may emit an initial silence
+                        # frame for each queued utterance. When NVDA feeds us multiple chunks
+                        # back-to-back (e.g. Say All reading "visual" lines), that redundant
+                        # leading silence can become a perceptible pause. Once we've already
+                        # queued real speech for this speak operation (or we're appending to
+                        # existing output), suppress those leading silence frames.
+                        suppressLeadingSilence = hadRealSpeech or bool(getattr(self._audio, "isSpeaking", False))
+                        sawRealFrameInThisUtterance = False
+                        sawSilenceAfterVoice = False
+
+                    # Reduce redundant *leading* silence frames to reduce gaps between
+                    # consecutive chunks/lines.
+                    # Fully dropping them can cause audible pops on some systems, so keep a
+                    # tiny slice instead.
+                    if (not framePtr) and suppressLeadingSilence and (not sawRealFrameInThisUtterance):
+                        dur = min(float(frameDuration), float(leadingSilenceMs))
+                        if dur > 0:
+                            self._player.queueFrame(None, dur, min(float(fadeDuration), dur))
                             queuedCount += 1
                             lastStreamWasVoiced = False
-                            return
+                        return
+
+                    # If this is a silence frame, queue it as a pause (NULL frame pointer).
+                    if not framePtr:
+                        # First silence *after* voiced audio: ensure a tiny ramp-down.
+                        if sawRealFrameInThisUtterance and (not sawSilenceAfterVoice):
+                            fd = max(float(fadeDuration), float(minFadeOutMs))
+                            # Fade can't be longer than the silence frame itself.
+                            if float(frameDuration) > 0:
+                                fd = min(fd, float(frameDuration))
+                            else:
+                                fd = 0.0
+                            fadeDuration = fd
+                            sawSilenceAfterVoice = True
+
+                        self._player.queueFrame(None, frameDuration, fadeDuration)
+                        queuedCount += 1
+                        lastStreamWasVoiced = False
+                        return
 
-                        # Ensure a small fade-in on the first voiced frame of each utterance.
-                        # This helps prevent tiny clicks on some output backends.
-                        if not sawRealFrameInThisUtterance:
-                            fadeDuration = max(float(fadeDuration), float(minFadeInMs))
+                    # Ensure a small fade-in on the first voiced frame of each utterance.
+                    # This helps prevent tiny clicks on some output backends.
+                    if not sawRealFrameInThisUtterance:
+                        fadeDuration = max(float(fadeDuration), float(minFadeInMs))
 
-                        sawRealFrameInThisUtterance = True
-                        hadRealSpeech = True
+                    sawRealFrameInThisUtterance = True
+                    hadRealSpeech = True
 
-                        # Copy the C frame into a Python-owned Frame.
-                        frame = speechPlayer.Frame()
-                        ctypes.memmove(ctypes.byref(frame), framePtr, ctypes.sizeof(speechPlayer.Frame))
+                    # Copy the C frame into a Python-owned Frame.
+                    frame = speechPlayer.Frame()
+                    ctypes.memmove(ctypes.byref(frame), framePtr, ctypes.sizeof(speechPlayer.Frame))
 
-                        applyVoiceToFrame(frame, self._curVoice)
+                    applyVoiceToFrame(frame, self._curVoice)
 
-                        if extraParamMultipliers:
-                            for paramName, ratio in extraParamMultipliers:
-                                setattr(frame, paramName, getattr(frame, paramName) * ratio)
+                    if extraParamMultipliers:
+                        for paramName, ratio in extraParamMultipliers:
+                            setattr(frame, paramName, getattr(frame, paramName) * ratio)
 
-                        frame.preFormantGain *= self._curVolume
+                    frame.preFormantGain *= self._curVolume
 
-                        # We intentionally do NOT attach NVDA indexes to the first speech frame here.
-                        # IndexCommands are emitted after blocks (see below), allowing us to coalesce
-                        # mid-sentence line breaks without adding audible gaps.
-                        self._player.queueFrame(frame, frameDuration, fadeDuration, userIndex=idxToSet)
-                        queuedCount += 1
-                        lastStreamWasVoiced = True
+                    # We intentionally do NOT attach NVDA indexes to the first speech frame here.
+                    # IndexCommands are emitted after blocks (see below), allowing us to coalesce
+                    # mid-sentence line breaks without adding audible gaps.
+                    self._player.queueFrame(frame, frameDuration, fadeDuration)
+                    queuedCount += 1
+                    lastStreamWasVoiced = True
 
-                    ok = False
-                    try:
-                        ok = self._frontend.queueIPA(
-                            ipaText,
+                # nvspFrontend.dll: text or IPA -> frames for the whole block. A clause that
+                # fails is skipped; the others are still queued.
+                ok = False
+                try:
+                    if nativeTextInput:
+                        ok = self._frontend.queueText(
+                            text,
                             speed=self._curRate,
                             basePitch=basePitch,
                             inflection=self._curInflection,
-                            clauseType=clauseType,
-                            userIndex=None,
+                            pauseMode=pauseMode,
                             onFrame=_onFrame,
                         )
-                    except Exception:
-                        log.error("nvSpeechPlayer: frontend queueIPA failed", exc_info=True)
-                        ok = False
-
-                    if not ok:
-                        err = self._frontend.getLastError()
-                        if err:
-                            log.error(f"nvSpeechPlayer: frontend error: {err}")
+                    else:
+                        ok = self._frontend.queueIPABatch(
+                            clauses,
+                            speed=self._curRate,
+                            basePitch=basePitch,
+                            inflection=self._curInflection,
+                            onFrame=_onFrame,
+                        )
+                except Exception:
+                    log.error("nvSpeechPlayer: frontend queue call failed", exc_info=True)
+                    ok = False
 
-                    # If the frontend fails or outputs nothing, keep going (indexes are still queued).
-                    if (not ok) or queuedCount <= 0:
-                        continue
+                if not ok:
+                    err = self._frontend.getLastError()
+                    if err:
+                        log.error(f"nvSpeechPlayer: frontend error: {err}")
 
-                    # Optional punctuation pause (micro-silence) after the clause.
-                    # Insert only when we actually queued a voiced frame; otherwise we'd
-                    # be adding silence after silence.
-                    if punctPauseMs and sawRealFrameInThisUtterance:
-                        try:
-                            dur = float(min(float(punctPauseMs), 20.0))
-                            fd = float(min(float(minFadeOutMs), dur))
-                            self._player.queueFrame(None, dur, fd)
-                            lastStreamWasVoiced = False
-                        except Exception:
-                            log.debug("nvSpeechPlayer: failed inserting punctuation pause", exc_info=True)
+                if curClause >= 0:
+                    _endClause()
 
             # Emit any IndexCommands that occurred after this block.
             if indexesAfter:
@@ -9,13 +9,99 @@ from __future__ import annotations
 
 import ctypes
 import os
-from typing import Optional
+from typing import Dict, NamedTuple, Optional, Sequence, Tuple
 
 from logHandler import log
 
 from . import speechPlayer
 
 
+def _yamlScalar(value: object) -> str:
+    """Format a Python value the way it would appear as a YAML scalar."""
+    if isinstance(value, bool):
+        return "true" if value else "false"
+    return str(value).strip()
+
+
+class FrameStats(ctypes.Structure):
+    """Mirrors nvspFrontend_FrameStats."""
+
+    _fields_ = [
+        ("framesGenerated", ctypes.c_ulonglong),
+        ("framesEmitted", ctypes.c_ulonglong),
+        ("durationMs", ctypes.c_double),
+    ]
+
+
+class ReplacementRule(ctypes.Structure):
+    """Mirrors nvspFrontend_ReplacementRule."""
+
+    _fields_ = [
+        ("fromUtf8", ctypes.c_char_p),
+        ("toUtf8", ctypes.POINTER(ctypes.c_char_p)),
+        ("toCount", ctypes.c_int),
+        ("atWordStart", ctypes.c_int),
+        ("atWordEnd", ctypes.c_int),
+        ("beforeClassUtf8", ctypes.c_char_p),
+        ("afterClassUtf8", ctypes.c_char_p),
+    ]
+
+
+class IPARecord(ctypes.Structure):
+    """Mirrors nvspFrontend_IPARecord."""
+
+    _fields_ = [
+        ("ipaUtf8", ctypes.c_char_p),
+        ("clauseTypeUtf8", ctypes.c_char_p),
+        ("userIndexBase", ctypes.c_int),
+        ("speed", ctypes.c_double),
+        ("basePitch", ctypes.c_double),
+        ("inflection", ctypes.c_double),
+    ]
+
+
+class IPAClause(NamedTuple):
+    """One clause for NvspFrontend.queueIPABatch().
+
+    speed/basePitch <= 0 and inflection < 0 use the values passed to the batch call.
+    """
+
+    ipaText: str
+    clauseType: Optional[str] = None
+    speed: float = 0.0
+    basePitch: float = 0.0
+    inflection: float = -1.0
+
+
+class PhonemizerConfig(ctypes.Structure):
+    """Mirrors nvspFrontend_PhonemizerConfig."""
+
+    _fields_ = [
+        ("backendUtf8", ctypes.c_char_p),
+        ("pathUtf8", ctypes.c_char_p),
+        ("dataPathUtf8", ctypes.c_char_p),
+        ("voiceUtf8", ctypes.c_char_p),
+        ("initialize", ctypes.c_int),
+        ("phonemeMode", ctypes.c_int),
+        ("timeoutMs", ctypes.c_int),
+    ]
+
+
+# Punctuation pause modes for queueText() (NVSP_FRONTEND_PAUSE_*).
+PAUSE_MODES = {"off": 0, "short": 1, "long": 2}
+
+
+def _optUtf8(value: Optional[str]) -> Optional[bytes]:
+    return value.encode("utf-8") if value else None
+
+
+def _clauseTypeUtf8(clauseType: Optional[str]) -> Optional[bytes]:
+    if not clauseType:
+        return None
+    # Frontend reads the first byte only.
+    return str(clauseType)[0].encode("ascii", errors="ignore") or b"."
+
+
 class NvspFrontend(object):
     """Thin ctypes wrapper around nvspFrontend.dll.
 
@@ -31,6 +117,7 @@ class NvspFrontend(object):
         self._packDir = packDir
         self._dll = None
         self._h = None
+        self._langTag: Optional[str] = None
         self._dllDirCookie = None
 
         # Python 3.8+ tightened Windows DLL search rules. If nvspFrontend.dll ever
@@ -106,6 +193,97 @@ class NvspFrontend(object):
         ]
         self._dll.nvspFrontend_queueIPA.restype = ctypes.c_int
 
+        # int nvspFrontend_queueIPABatch(handle, const nvspFrontend_IPARecord* records, int recordCount,
+        #                                double speed, double basePitch, double inflection, cb, userData);
+        self._dll.nvspFrontend_queueIPABatch.argtypes = [
+            ctypes.c_void_p,  # handle
+            ctypes.POINTER(IPARecord),  # records
+            ctypes.c_int,  # recordCount
+            ctypes.c_double,  # speed
+            ctypes.c_double,  # basePitch
+            ctypes.c_double,  # inflection
+            self._CBTYPE,  # cb
+            ctypes.c_void_p,  # userData
+        ]
+        self._dll.nvspFrontend_queueIPABatch.restype = ctypes.c_int
+
+        # Text input through a phonemizer backend.
+        self._dll.nvspFrontend_setPhonemizer.argtypes = [ctypes.c_void_p, ctypes.POINTER(PhonemizerConfig)]
+        self._dll.nvspFrontend_setPhonemizer.restype = ctypes.c_int
+        self._dll.nvspFrontend_phonemizeText.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_char_p,
+            ctypes.POINTER(ctypes.c_char_p),
+        ]
+        self._dll.nvspFrontend_phonemizeText.restype = ctypes.c_int
+        self._dll.nvspFrontend_queueText.argtypes = [
+            ctypes.c_void_p,  # handle
+            ctypes.c_char_p,  # textUtf8
+            ctypes.c_double,  # speed
+            ctypes.c_double,  # basePitch
+            ctypes.c_double,  # inflection
+            ctypes.c_int,  # pauseMode
+            ctypes.c_int,  # userIndexBase
+            self._CBTYPE,  # cb
+            ctypes.c_void_p,  # userData
+        ]
+        self._dll.nvspFrontend_queueText.restype = ctypes.c_int
+
+        # int nvspFrontend_getFrameStats(nvspFrontend_handle_t handle, nvspFrontend_FrameStats* outStats);
+        self._dll.nvspFrontend_getFrameStats.argtypes = [ctypes.c_void_p, ctypes.POINTER(FrameStats)]
+        self._dll.nvspFrontend_getFrameStats.restype = ctypes.c_int
+
+        # void nvspFrontend_resetFrameStats(nvspFrontend_handle_t handle);
+        self._dll.nvspFrontend_resetFrameStats.argtypes = [ctypes.c_void_p]
+        self._dll.nvspFrontend_resetFrameStats.restype = None
+
+        # int nvspFrontend_getSetting(handle, const char* keyUtf8, const char** outValue, const char** outSource);
+        self._dll.nvspFrontend_getSetting.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_char_p,
+            ctypes.POINTER(ctypes.c_char_p),
+            ctypes.POINTER(ctypes.c_char_p),
+        ]
+        self._dll.nvspFrontend_getSetting.restype = ctypes.c_int
+
+        # int nvspFrontend_enumerateSettings(handle, nvspFrontend_SettingCallback cb, void* userData);
+        self._SETTINGCBTYPE = ctypes.CFUNCTYPE(
+            None,
+            ctypes.c_void_p,  # userData
+            ctypes.c_char_p,  # keyUtf8
+            ctypes.c_char_p,  # valueUtf8
+            ctypes.c_char_p,  # sourceUtf8
+        )
+        self._dll.nvspFrontend_enumerateSettings.argtypes = [ctypes.c_void_p, self._SETTINGCBTYPE, ctypes.c_void_p]
+        self._dll.nvspFrontend_enumerateSettings.restype = ctypes.c_int
+
+        # Live-edit overrides. Each returns an override id, or 0 on failure.
+        self._dll.nvspFrontend_overridePhonemeField.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_char_p,
+            ctypes.c_char_p,
+            ctypes.c_char_p,
+        ]
+        self._dll.nvspFrontend_overridePhonemeField.restype = ctypes.c_int
+        self._dll.nvspFrontend_overrideSetting.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_char_p]
+        self._dll.nvspFrontend_overrideSetting.restype = ctypes.c_int
+        self._dll.nvspFrontend_overrideReplacement.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_int,
+            ctypes.POINTER(ReplacementRule),
+        ]
+        self._dll.nvspFrontend_overrideReplacement.restype = ctypes.c_int
+        self._dll.nvspFrontend_overrideRemoveReplacement.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_int,
+            ctypes.POINTER(ReplacementRule),
+        ]
+        self._dll.nvspFrontend_overrideRemoveReplacement.restype = ctypes.c_int
+        self._dll.nvspFrontend_revertOverride.argtypes = [ctypes.c_void_p, ctypes.c_int]
+        self._dll.nvspFrontend_revertOverride.restype = ctypes.c_int
+        self._dll.nvspFrontend_revertAllOverrides.argtypes = [ctypes.c_void_p]
+        self._dll.nvspFrontend_revertAllOverrides.restype = None
+
     def terminate(self) -> None:
         if self._dll and self._h:
             try:
@@ -134,13 +312,140 @@ class NvspFrontend(object):
             log.debug("nvSpeechPlayer: getLastError failed", exc_info=True)
             return ""
 
+    def getFrameStats(self) -> Optional[FrameStats]:
+        """Frames generated/emitted so far, to see what frame coalescing saves."""
+        if not self._dll or not self._h:
+            return None
+        stats = FrameStats()
+        if not self._dll.nvspFrontend_getFrameStats(self._h, ctypes.byref(stats)):
+            return None
+        return stats
+
+    def resetFrameStats(self) -> None:
+        if self._dll and self._h:
+            self._dll.nvspFrontend_resetFrameStats(self._h)
+
     def setLanguage(self, langTag: str) -> bool:
         if not self._dll or not self._h:
             return False
         tag = (langTag or "").strip().lower().replace("_", "-")
         ok = int(self._dll.nvspFrontend_setLanguage(self._h, tag.encode("utf-8")))
+        if ok:
+            self._langTag = tag or "default"
         return bool(ok)
 
+    @property
+    def langTag(self) -> Optional[str]:
+        """Tag passed to the last successful setLanguage() call, or None."""
+        return self._langTag
+
+    def getSetting(self, key: str) -> Optional[Tuple[str, str]]:
+        """Return (value, sourceTag) for a settings key of the loaded language, or None if unset."""
+        if not self._dll or not self._h:
+            return None
+        value = ctypes.c_char_p()
+        source = ctypes.c_char_p()
+        if not self._dll.nvspFrontend_getSetting(
+            self._h, (key or "").encode("utf-8"), ctypes.byref(value), ctypes.byref(source)
+        ):
+            return None
+        return (
+            (value.value or b"").decode("utf-8", errors="replace"),
+            (source.value or b"").decode("utf-8", errors="replace"),
+        )
+
+    def enumerateSettings(self) -> Optional[Dict[str, Tuple[str, str]]]:
+        """Return {key: (value, sourceTag)} for the loaded language, or None on failure.
+
+        This reads the settings the frontend already merged while loading the
+        pack, so no YAML is parsed on the caller's thread.
+        """
+        if not self._dll or not self._h:
+            return None
+        settings: Dict[str, Tuple[str, str]] = {}
+
+        @self._SETTINGCBTYPE
+        def _cb(userData, key, value, source):
+            settings[key.decode("utf-8", errors="replace")] = (
+                (value or b"").decode("utf-8", errors="replace"),
+                (source or b"").decode("utf-8", errors="replace"),
+            )
+
+        if self._dll.nvspFrontend_enumerateSettings(self._h, _cb, None) < 0:
+            return None
+        return settings
+
+    # ---- Live-edit overrides ----
+    #
+    # These patch the loaded language in memory, so the next queueIPA() call
+    # hears the change without writing or re-reading YAML. Each returns an
+    # override id (0 on failure) that can be passed to revertOverride().
+    # setLanguage() discards all overrides.
+
+    def overridePhonemeField(self, phonemeKey: str, field: str, value: Optional[object]) -> int:
+        """Set a phoneme field ("cf1") or flag ("_isVowel"); value None removes it."""
+        if not self._dll or not self._h:
+            return 0
+        raw = None if value is None else _yamlScalar(value).encode("utf-8")
+        return int(
+            self._dll.nvspFrontend_overridePhonemeField(
+                self._h, (phonemeKey or "").encode("utf-8"), (field or "").encode("utf-8"), raw
+            )
+        )
+
+    def overrideSetting(self, key: str, value: object) -> int:
+        """Set one ``settings:`` key, as if it were written to the YAML."""
+        if not self._dll or not self._h:
+            return 0
+        return int(
+            self._dll.nvspFrontend_overrideSetting(
+                self._h, (key or "").encode("utf-8"), _yamlScalar(value).encode("utf-8")
+            )
+        )
+
+    def overrideReplacement(
+        self,
+        fromText: str,
+        to,
+        *,
+        atWordStart: bool = False,
+        atWordEnd: bool = False,
+        beforeClass: str = "",
+        afterClass: str = "",
+        pre: bool = False,
+        remove: bool = False,
+    ) -> int:
+        """Add or change (or with remove=True, delete) a normalization replacement rule.
+
+        Rules are matched by ``from`` plus the ``when`` conditions. ``to`` is a
+        string or a list of candidates.
+        """
+        if not self._dll or not self._h:
+            return 0
+        if isinstance(to, str):
+            to = [to]
+        toArr = (ctypes.c_char_p * max(len(to or []), 1))(*[(t or "").encode("utf-8") for t in (to or [])])
+        rule = ReplacementRule(
+            (fromText or "").encode("utf-8"),
+            ctypes.cast(toArr, ctypes.POINTER(ctypes.c_char_p)),
+            len(to or []),
+            int(bool(atWordStart)),
+            int(bool(atWordEnd)),
+            (beforeClass or "").encode("utf-8"),
+            (afterClass or "").encode("utf-8"),
+        )
+        fn = self._dll.nvspFrontend_overrideRemoveReplacement if remove else self._dll.nvspFrontend_overrideReplacement
+        return int(fn(self._h, int(bool(pre)), ctypes.byref(rule)))
+
+    def revertOverride(self, overrideId: int) -> bool:
+        if not self._dll or not self._h:
+            return False
+        return bool(self._dll.nvspFrontend_revertOverride(self._h, int(overrideId)))
+
+    def revertAllOverrides(self) -> None:
+        if self._dll and self._h:
+            self._dll.nvspFrontend_revertAllOverrides(self._h)
+
     def queueIPA(
         self,
         ipaText: str,
@@ -157,10 +462,7 @@ class NvspFrontend(object):
             return False
 
         ipaUtf8 = (ipaText or "").encode("utf-8")
-        clauseUtf8 = None
-        if clauseType:
-            # Frontend reads the first byte only.
-            clauseUtf8 = str(clauseType)[0].encode("ascii", errors="ignore") or b"."
+        clauseUtf8 = _clauseTypeUtf8(clauseType)
 
         first = True
 
@@ -193,3 +495,182 @@ class NvspFrontend(object):
             )
         )
         return bool(ok)
+
+    def queueIPABatch(
+        self,
+        clauses: Sequence[IPAClause],
+        *,
+        speed: float,
+        basePitch: float,
+        inflection: float,
+        onFrame,
+    ) -> bool:
+        """Queue several clauses with one DLL call.
+
+        Calls onFrame(clauseIndex, framePtrOrNone, durationMs, fadeMs) for each frame, where
+        clauseIndex is the position in clauses. The frames are the same as calling queueIPA()
+        once per clause. Returns False if any clause failed; the others are still queued.
+        """
+        if not self._dll or not self._h:
+            return False
+        if not clauses:
+            return True
+
+        records = (IPARecord * len(clauses))()
+        for i, clause in enumerate(clauses):
+            rec = records[i]
+            # The structure keeps references to these bytes objects while records is alive.
+            rec.ipaUtf8 = (clause.ipaText or "").encode("utf-8")
+            rec.clauseTypeUtf8 = _clauseTypeUtf8(clause.clauseType)
+            rec.userIndexBase = i
+            rec.speed = float(clause.speed)
+            rec.basePitch = float(clause.basePitch)
+            rec.inflection = float(clause.inflection)
+
+        @self._CBTYPE
+        def _cb(userData, framePtr, durationMs, fadeMs, clauseIndex):
+            onFrame(int(clauseIndex), framePtr, float(durationMs), float(fadeMs))
+
+        ok = int(
+            self._dll.nvspFrontend_queueIPABatch(
+                self._h,
+                records,
+                len(clauses),
+                float(speed),
+                float(basePitch),
+                float(inflection),
+                _cb,
+                None,
+            )
+        )
+        return bool(ok)
+
+    def setPhonemizer(
+        self,
+        backend: Optional[str],
+        *,
+        path: Optional[str] = None,
+        dataPath: Optional[str] = None,
+        voice: Optional[str] = None,
+        initialize: bool = False,
+        phonemeMode: int = 0,
+        timeoutMs: int = 0,
+    ) -> bool:
+        """Select the text -> IPA backend used by queueText(): "espeak", "process" or "stub".
+
+        backend=None removes the phonemizer. See nvspFrontend.h for the meaning of the options.
+        """
+        if not self._dll or not self._h:
+            return False
+        if not backend:
+            return bool(self._dll.nvspFrontend_setPhonemizer(self._h, None))
+        cfg = PhonemizerConfig(
+            backendUtf8=backend.encode("utf-8"),
+            pathUtf8=_optUtf8(path),
+            dataPathUtf8=_optUtf8(dataPath),
+            voiceUtf8=_optUtf8(voice),
+            initialize=1 if initialize else 0,
+            phonemeMode=int(phonemeMode),
+            timeoutMs=int(timeoutMs),
+        )
+        return bool(self._dll.nvspFrontend_setPhonemizer(self._h, ctypes.byref(cfg)))
+
+    def phonemizeText(self, text: str) -> Optional[str]:
+        """Run the phonemizer on text and return the IPA, or None on failure."""
+        if not self._dll or not self._h:
+            return None
+        ipa = ctypes.c_char_p()
+        if not self._dll.nvspFrontend_phonemizeText(self._h, (text or "").encode("utf-8"), ctypes.byref(ipa)):
+            return None
+        return (ipa.value or b"").decode("utf-8", errors="replace")
+
+    def queueText(
+        self,
+        text: str,
+        *,
+        speed: float,
+        basePitch: float,
+        inflection: float,
+        pauseMode: str,
+        onFrame,
+    ) -> bool:
+        """Phonemize and queue plain text in one DLL call.
+
+        Calls onFrame(clauseIndex, framePtrOrNone, durationMs, fadeMs) for each frame, including
+        the punctuation pauses. Returns False if any clause failed; the others are still queued.
+        """
+        if not self._dll or not self._h:
+            return False
+
+        @self._CBTYPE
+        def _cb(userData, framePtr, durationMs, fadeMs, clauseIndex):
+            onFrame(int(clauseIndex), framePtr, float(durationMs), float(fadeMs))
+
+        ok = int(
+            self._dll.nvspFrontend_queueText(
+                self._h,
+                (text or "").encode("utf-8"),
+                float(speed),
+                float(basePitch),
+                float(inflection),
+                PAUSE_MODES.get(pauseMode, 1),
+                0,
+                _cb,
+                None,
+            )
+        )
+        return bool(ok)
+
+    def queueIPAFrames(
+        self,
+        ipaText: str,
+        *,
+        speed: float,
+        basePitch: float,
+        inflection: float,
+        clauseType: Optional[str],
+        userIndexBase: int = -1,
+        sampleRate: int,
+    ):
+        """Convert IPA to frames in one call, ready for SpeechPlayer.queueFrames().
+
+        Returns (frames, timings) with durations in samples at sampleRate, or None on failure.
+        With the native extension both are bytes built without any per-frame Python code;
+        otherwise they are Frame and FrameTiming arrays.
+        """
+        if not self._dll or not self._h:
+            return None
+        native = speechPlayer._nvspNative
+        if native:
+            # The extension takes str and does the UTF-8 encoding itself.
+            return native.frontendQueueIPA(
+                self._h, ipaText or "", float(speed), float(basePitch), float(inflection),
+                str(clauseType)[0] if clauseType else None, int(userIndexBase), int(sampleRate)
+            )
+        ipaUtf8 = (ipaText or "").encode("utf-8")
+        clauseUtf8 = _clauseTypeUtf8(clauseType)
+        frames = []
+        timings = []
+
+        @self._CBTYPE
+        def _cb(userData, framePtr, durationMs, fadeMs, userIndex):
+            frame = speechPlayer.Frame()
+            timing = speechPlayer.FrameTiming()
+            if framePtr:
+                ctypes.memmove(ctypes.byref(frame), framePtr, ctypes.sizeof(speechPlayer.Frame))
+            else:
+                timing.flags = speechPlayer.TIMING_SILENCE
+            timing.minFrameDuration = max(int(float(durationMs) * (sampleRate / 1000.0)), 0)
+            timing.fadeDuration = max(int(float(fadeMs) * (sampleRate / 1000.0)), 0)
+            timing.userIndex = int(userIndex)
+            frames.append(frame)
+            timings.append(timing)
+
+        ok = int(
+            self._dll.nvspFrontend_queueIPA(
+                self._h, ipaUtf8, float(speed), float(basePitch), float(inflection), clauseUtf8, int(userIndexBase), _cb, None
+            )
+        )
+        if not ok:
+            return None
+        return (speechPlayer.Frame * len(frames))(*frames), (speechPlayer.FrameTiming * len(timings))(*timings)
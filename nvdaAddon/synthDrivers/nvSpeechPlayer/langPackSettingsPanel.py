@@ -390,16 +390,35 @@ def _getPanelClass():
             self._updateQuickDisplays()
             self._updateGenericDisplay()
 
+        def _getResidentSettings(self, langTag: str):
+            """Settings the active NV Speech Player frontend already loaded for langTag, if any.
+
+            Returns {key: (value, sourceTag)}, or None if the YAML has to be read instead.
+            """
+            try:
+                import synthDriverHandler
+
+                synth = synthDriverHandler.getSynth()
+                if synth and synth.__class__.__module__.endswith("nvSpeechPlayer"):
+                    if hasattr(synth, "getResidentLangPackSettings"):
+                        return synth.getResidentLangPackSettings(langTag)
+            except Exception:
+                pass
+            return None
+
         def _updateQuickDisplays(self):
             # Populate quick fields based on current language tag.
             langTag = langPackYaml.normalizeLangTag(self.langTagCtrl.GetValue())
             pendingForLang = self._pending.get(langTag, {})
+            resident = self._getResidentSettings(langTag)
 
             self._isPopulating = True
             try:
                 for key, ctrl in self._quickCtrls.items():
                     if key in pendingForLang:
                         value = pendingForLang[key]
+                    elif resident is not None:
+                        value = resident.get(key, ("", None))[0]
                     else:
                         value = langPackYaml.getEffectiveSettingValue(self._packsDir, langTag, key)
                         if value is None:
@@ -425,8 +444,12 @@ def _getPanelClass():
                 value = pendingForLang[key]
                 source = _("(pending edit)")
             else:
-                value = langPackYaml.getEffectiveSettingValue(self._packsDir, langTag, key)
-                sourceTag = langPackYaml.getSettingSource(self._packsDir, langTag, key)
+                resident = self._getResidentSettings(langTag)
+                if resident is not None:
+                    value, sourceTag = resident.get(key, (None, None))
+                else:
+                    value = langPackYaml.getEffectiveSettingValue(self._packsDir, langTag, key)
+                    sourceTag = langPackYaml.getSettingSource(self._packsDir, langTag, key)
                 source = _(f"(from {sourceTag}.yaml)") if sourceTag else ""
                 if value is None:
                     value = ""
@@ -167,6 +167,22 @@ def getEffectiveSettings(packsDir: str, langTag: str) -> Dict[str, str]:
     return effective
 
 
+def langChainSignature(packsDir: str, langTag: str) -> Tuple[Tuple[str, int, int], ...]:
+    """Return (tag, mtime_ns, size) for each existing file in the inheritance chain.
+
+    Comparing signatures tells whether pack files changed on disk since the
+    frontend loaded them, using only ``stat`` calls.
+    """
+    sig: List[Tuple[str, int, int]] = []
+    for tag in iterLangTagChain(langTag):
+        try:
+            st = os.stat(langYamlPath(packsDir, tag))
+        except OSError:
+            continue
+        sig.append((tag, st.st_mtime_ns, st.st_size))
+    return tuple(sig)
+
+
 def getEffectiveSettingValue(packsDir: str, langTag: str, key: str) -> Optional[str]:
     """Return the effective value for a given setting key.
 
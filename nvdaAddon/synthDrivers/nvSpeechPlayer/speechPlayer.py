@@ -53,9 +53,39 @@ class Frame(Structure):
         "preFormantGain",
         "outputGain",
         "endVoicePitch",
+        "trillRate",
+        "trillDepth",
+        "trillClosureFraction",
+        "trillFricationFloor",
+        "midVoicePitch1",
+        "midVoicePitch2",
     ]]
 
 
+class FrameTiming(Structure):
+    # Mirrors nvspNative_timing_t in src/python/nvspNative.cpp; one per frame passed to SpeechPlayer.queueFrames().
+    # Durations are in samples; set TIMING_SILENCE in flags to queue a silence instead of the frame.
+    _fields_ = [
+        ("minFrameDuration", c_uint),
+        ("fadeDuration", c_uint),
+        ("userIndex", c_int),
+        ("flags", c_uint),
+    ]
+
+
+TIMING_SILENCE = 0x1
+
+
+class FrameRequest(Structure):
+    # Mirrors speechPlayer_frameRequest_t; durations are in samples.
+    _fields_ = [
+        ("frame", POINTER(Frame)),
+        ("minFrameDuration", c_uint),
+        ("fadeDuration", c_uint),
+        ("userIndex", c_int),
+    ]
+
+
 def _archFolderName() -> Optional[str]:
     """Return the subfolder name containing native DLLs for this Python process."""
     ptrSize = ctypes.sizeof(ctypes.c_void_p)
@@ -83,6 +113,81 @@ dllDir = getDllDir()
 dllPath = os.path.join(dllDir, "speechPlayer.dll")
 
 
+def _loadNative():
+    """Load the optional _nvspNative extension from the DLL directory, or return None to use ctypes only."""
+    import glob
+    import importlib.machinery
+    import importlib.util
+    for path in sorted(glob.glob(os.path.join(dllDir, "_nvspNative*.pyd"))):
+        try:
+            loader = importlib.machinery.ExtensionFileLoader("_nvspNative", path)
+            spec = importlib.util.spec_from_file_location("_nvspNative", path, loader=loader)
+            module = importlib.util.module_from_spec(spec)
+            loader.exec_module(module)
+        except (ImportError, OSError):
+            # Built for another Python version or bitness.
+            continue
+        if module.FRAME_SIZE == ctypes.sizeof(Frame) and module.TIMING_SIZE == ctypes.sizeof(FrameTiming):
+            return module
+    return None
+
+
+_nvspNative = _loadNative()
+
+# Flags for SpeechPlayer(sampleRate, flags); keep in sync with speechPlayer.h.
+INIT_SCALAR_CASCADE = 0x1
+INIT_FLOAT32 = 0x2
+INIT_FIXED_POINT = 0x4
+INIT_WAVEFRONT_CASCADE = 0x8
+
+
+def _makeFrameRequests(frames, sampleRate: int):
+    """Builds a FrameRequest array from (frame, minFrameDuration, fadeDuration[, userIndex]) tuples with durations in ms."""
+    requests = (FrameRequest * max(len(frames), 1))()
+    for request, args in zip(requests, frames):
+        frame, minFrameDuration, fadeDuration = args[:3]
+        request.frame = POINTER(Frame)(frame) if frame else None
+        request.minFrameDuration = max(int(float(minFrameDuration) * (sampleRate / 1000.0)), 0)
+        request.fadeDuration = max(int(float(fadeDuration) * (sampleRate / 1000.0)), 0)
+        request.userIndex = int(args[3]) if len(args) > 3 and args[3] is not None else -1
+    return requests
+
+
+def renderOffline(sampleRate: int, frames, flags: int = 0, noiseSeed: int = 0, numThreads: int = 0):
+    """Render a whole frame sequence to a c_short array, using several threads.
+
+    frames is a sequence of (frame, minFrameDuration, fadeDuration[, userIndex]) tuples as for
+    SpeechPlayer.preempt(). The sequence is split after every None frame and the pieces are
+    rendered concurrently; the result does not depend on numThreads (0 = one per processor).
+    """
+    dll = cdll.LoadLibrary(dllPath)
+    # sample* speechPlayer_renderOffline(int sampleRate, uint flags, FrameRequest* frames, uint count, uint noiseSeed, uint numThreads, uint* sampleCount);
+    dll.speechPlayer_renderOffline.argtypes = (c_int, c_uint, POINTER(FrameRequest), c_uint, c_uint, c_uint, POINTER(c_uint))
+    dll.speechPlayer_renderOffline.restype = POINTER(c_short)
+    # void speechPlayer_freeRendered(sample* buffer);
+    dll.speechPlayer_freeRendered.argtypes = (POINTER(c_short),)
+    dll.speechPlayer_freeRendered.restype = None
+    frames = list(frames)
+    requests = _makeFrameRequests(frames, int(sampleRate))
+    count = c_uint(0)
+    buf = dll.speechPlayer_renderOffline(
+        int(sampleRate),
+        c_uint(int(flags)),
+        requests,
+        c_uint(len(frames)),
+        c_uint(int(noiseSeed) & 0xFFFFFFFF),
+        c_uint(int(numThreads)),
+        byref(count),
+    )
+    try:
+        samples = (c_short * max(count.value, 1))()
+        ctypes.memmove(samples, buf, count.value * ctypes.sizeof(c_short))
+        samples.length = count.value
+        return samples
+    finally:
+        dll.speechPlayer_freeRendered(buf)
+
+
 class SpeechPlayer(object):
     """Thin ctypes wrapper over speechPlayer.dll.
 
@@ -90,7 +195,7 @@ class SpeechPlayer(object):
     The DLL expects durations in *samples*.
     """
 
-    def __init__(self, sampleRate: int):
+    def __init__(self, sampleRate: int, flags: int = 0, internalRate: Optional[int] = None):
         self.sampleRate = int(sampleRate)
 
         self._dllDirCookie = None
@@ -106,7 +211,15 @@ class SpeechPlayer(object):
         self._dll = cdll.LoadLibrary(dllPath)
         self._setupPrototypes()
 
-        self._speechHandle = self._dll.speechPlayer_initialize(self.sampleRate)
+        if internalRate and int(internalRate) != self.sampleRate:
+            # Synthesize at internalRate and let the engine resample to sampleRate.
+            self._speechHandle = self._dll.speechPlayer_initializeResampled(
+                self.sampleRate, int(internalRate), c_uint(int(flags))
+            )
+        elif flags:
+            self._speechHandle = self._dll.speechPlayer_initializeEx(self.sampleRate, c_uint(int(flags)))
+        else:
+            self._speechHandle = self._dll.speechPlayer_initialize(self.sampleRate)
         if not self._speechHandle:
             raise RuntimeError("speechPlayer_initialize failed")
 
@@ -115,6 +228,14 @@ class SpeechPlayer(object):
         self._dll.speechPlayer_initialize.argtypes = (c_int,)
         self._dll.speechPlayer_initialize.restype = c_void_p
 
+        # void* speechPlayer_initializeEx(int sampleRate, uint flags);
+        self._dll.speechPlayer_initializeEx.argtypes = (c_int, c_uint)
+        self._dll.speechPlayer_initializeEx.restype = c_void_p
+
+        # void* speechPlayer_initializeResampled(int outputRate, int internalRate, uint flags);
+        self._dll.speechPlayer_initializeResampled.argtypes = (c_int, c_int, c_uint)
+        self._dll.speechPlayer_initializeResampled.restype = c_void_p
+
         # void speechPlayer_queueFrame(void* handle, Frame* frame, uint minSamples, uint fadeSamples,
         #                              int userIndex, bool purgeQueue);
         # Use c_int for purgeQueue (0/1) for ABI safety.
@@ -132,6 +253,50 @@ class SpeechPlayer(object):
         self._dll.speechPlayer_synthesize.argtypes = (c_void_p, c_uint, POINTER(c_short))
         self._dll.speechPlayer_synthesize.restype = c_int
 
+        # int speechPlayer_preempt(void* handle, FrameRequest* frames, uint count, uint rampMs, uint unplayedSamples);
+        self._dll.speechPlayer_preempt.argtypes = (c_void_p, POINTER(FrameRequest), c_uint, c_uint, c_uint)
+        self._dll.speechPlayer_preempt.restype = c_int
+
+        # uint speechPlayer_prepare(void* handle, FrameRequest* frames, uint count);
+        self._dll.speechPlayer_prepare.argtypes = (c_void_p, POINTER(FrameRequest), c_uint)
+        self._dll.speechPlayer_prepare.restype = c_uint
+
+        # int speechPlayer_commit(void* handle, uint ticket, uint rampMs, uint unplayedSamples);
+        self._dll.speechPlayer_commit.argtypes = (c_void_p, c_uint, c_uint, c_uint)
+        self._dll.speechPlayer_commit.restype = c_int
+
+        # void speechPlayer_discard(void* handle, uint ticket);
+        self._dll.speechPlayer_discard.argtypes = (c_void_p, c_uint)
+        self._dll.speechPlayer_discard.restype = None
+
+        # void speechPlayer_setSpeculationLimits(void* handle, uint maxSpeculations, uint maxMs);
+        self._dll.speechPlayer_setSpeculationLimits.argtypes = (c_void_p, c_uint, c_uint)
+        self._dll.speechPlayer_setSpeculationLimits.restype = None
+
+        # void* speechPlayer_suspend(void* handle, uint unplayedSamples);
+        self._dll.speechPlayer_suspend.argtypes = (c_void_p, c_uint)
+        self._dll.speechPlayer_suspend.restype = c_void_p
+
+        # int speechPlayer_resume(void* handle, void* state, uint rampMs, uint unplayedSamples);
+        self._dll.speechPlayer_resume.argtypes = (c_void_p, c_void_p, c_uint, c_uint)
+        self._dll.speechPlayer_resume.restype = c_int
+
+        # void speechPlayer_freeState(void* state);
+        self._dll.speechPlayer_freeState.argtypes = (c_void_p,)
+        self._dll.speechPlayer_freeState.restype = None
+
+        # void speechPlayer_skip(void* handle, uint numSamples);
+        self._dll.speechPlayer_skip.argtypes = (c_void_p, c_uint)
+        self._dll.speechPlayer_skip.restype = None
+
+        # void speechPlayer_setRate(void* handle, double rate);
+        self._dll.speechPlayer_setRate.argtypes = (c_void_p, c_double)
+        self._dll.speechPlayer_setRate.restype = None
+
+        # void speechPlayer_setTimeCompression(void* handle, double factor);
+        self._dll.speechPlayer_setTimeCompression.argtypes = (c_void_p, c_double)
+        self._dll.speechPlayer_setTimeCompression.restype = None
+
         # int speechPlayer_getLastIndex(void* handle);
         self._dll.speechPlayer_getLastIndex.argtypes = (c_void_p,)
         self._dll.speechPlayer_getLastIndex.restype = c_int
@@ -172,6 +337,143 @@ class SpeechPlayer(object):
             return buf
         return None
 
+    def synthesizeInto(self, buffer) -> int:
+        """Render into a writable buffer of 16 bit samples (bytearray, memoryview, numpy int16 array, ...).
+
+        Returns the number of samples written; the buffer is not copied.
+        """
+        if _nvspNative:
+            return _nvspNative.synthesize(self._speechHandle, buffer)
+        view = memoryview(buffer).cast("B")
+        n = len(view) // ctypes.sizeof(c_short)
+        if n <= 0:
+            return 0
+        res = self._dll.speechPlayer_synthesize(self._speechHandle, c_uint(n), (c_short * n).from_buffer(view))
+        return max(int(res), 0)
+
+    def synthesizeBytes(self, numSamples: int) -> bytes:
+        """Render up to numSamples and return them as bytes, empty when nothing is queued.
+
+        With the native extension the samples are rendered straight into the bytes object.
+        """
+        n = int(numSamples)
+        if n <= 0:
+            return b""
+        if _nvspNative:
+            return _nvspNative.synthesizeBytes(self._speechHandle, n)
+        buf = (c_short * n)()
+        res = max(int(self._dll.speechPlayer_synthesize(self._speechHandle, c_uint(n), buf)), 0)
+        return ctypes.string_at(buf, res * ctypes.sizeof(c_short))
+
+    def queueFrames(self, frames, timings, purgeQueue: bool = False) -> int:
+        """Queue a batch of frames in one call.
+
+        frames is a contiguous array of Frame structs and timings a FrameTiming array of the same length,
+        e.g. ctypes arrays or the bytes returned by the frontend's queueIPAFrames(). Durations are in samples.
+        Returns the number of frames queued.
+        """
+        if _nvspNative:
+            return _nvspNative.queueFrames(self._speechHandle, frames, timings, bool(purgeQueue))
+        count = len(timings)
+        for i in range(count):
+            timing = timings[i]
+            framePtr = None if timing.flags & TIMING_SILENCE else byref(frames[i])
+            self._dll.speechPlayer_queueFrame(
+                self._speechHandle,
+                framePtr,
+                c_uint(timing.minFrameDuration),
+                c_uint(timing.fadeDuration),
+                c_int(timing.userIndex),
+                c_int(1 if purgeQueue and i == 0 else 0),
+            )
+        return count
+
+    def preempt(self, frames, rampMs: int = 5, unplayedSamples: int = 0) -> int:
+        """Replace all queued speech with frames, fading out what is playing over rampMs.
+
+        frames is a sequence of (frame, minFrameDuration, fadeDuration[, userIndex]) tuples,
+        with durations in milliseconds as for queueFrame(); frame may be None for silence.
+        unplayedSamples is how many synthesized samples are buffered but not yet played.
+        Returns how many of those to discard from the end of the buffer.
+        """
+        frames = list(frames)
+        requests = _makeFrameRequests(frames, self.sampleRate)
+        return int(self._dll.speechPlayer_preempt(
+            self._speechHandle,
+            requests,
+            c_uint(len(frames)),
+            c_uint(max(int(rampMs), 0)),
+            c_uint(max(int(unplayedSamples), 0)),
+        ))
+
+    def prepare(self, frames) -> int:
+        """Start rendering frames in the background for a later commit().
+
+        frames takes the same tuples as preempt(). The current rate and time compression are used.
+        Returns a ticket, or 0 if the speculation limit is reached.
+        """
+        frames = list(frames)
+        requests = _makeFrameRequests(frames, self.sampleRate)
+        return int(self._dll.speechPlayer_prepare(self._speechHandle, requests, c_uint(len(frames))))
+
+    def commit(self, ticket: int, rampMs: int = 5, unplayedSamples: int = 0) -> int:
+        """Replace all queued speech with a prepared utterance, as preempt() does.
+
+        Plays the pre-rendered audio if it is ready, otherwise renders the frames live.
+        Returns how many unplayed samples to discard, or -1 for an unknown ticket.
+        """
+        return int(self._dll.speechPlayer_commit(
+            self._speechHandle,
+            c_uint(int(ticket)),
+            c_uint(max(int(rampMs), 0)),
+            c_uint(max(int(unplayedSamples), 0)),
+        ))
+
+    def discard(self, ticket: int) -> None:
+        """Drop a prepared utterance that will not be spoken."""
+        self._dll.speechPlayer_discard(self._speechHandle, c_uint(int(ticket)))
+
+    def setSpeculationLimits(self, maxSpeculations: int, maxMs: int) -> None:
+        """Limit the prepared utterances held at once and the milliseconds of audio they hold together."""
+        self._dll.speechPlayer_setSpeculationLimits(self._speechHandle, c_uint(max(int(maxSpeculations), 0)), c_uint(max(int(maxMs), 0)))
+
+    def suspend(self, unplayedSamples: int = 0):
+        """Save the current speech, from the first of unplayedSamples on, for a later resume().
+
+        Nothing stops; follow with preempt() to play the interruption. Release the result with freeState().
+        """
+        return self._dll.speechPlayer_suspend(self._speechHandle, c_uint(max(int(unplayedSamples), 0)))
+
+    def resume(self, state, rampMs: int = 5, unplayedSamples: int = 0) -> int:
+        """Replace all queued speech, as preempt() does, with the speech saved by suspend().
+
+        Returns how many unplayed samples to discard from the end of the buffer.
+        """
+        return int(self._dll.speechPlayer_resume(
+            self._speechHandle,
+            state,
+            c_uint(max(int(rampMs), 0)),
+            c_uint(max(int(unplayedSamples), 0)),
+        ))
+
+    def freeState(self, state) -> None:
+        """Release a state returned by suspend()."""
+        if state:
+            self._dll.speechPlayer_freeState(state)
+
+    def skip(self, duration: float) -> None:
+        """Discard the next duration milliseconds of queued speech without synthesizing it."""
+        numSamples = max(int(float(duration) * (self.sampleRate / 1000.0)), 0)
+        self._dll.speechPlayer_skip(self._speechHandle, c_uint(numSamples))
+
+    def setRate(self, rate: float) -> None:
+        """Play all frames, including already queued ones, rate times faster from the next frame transition."""
+        self._dll.speechPlayer_setRate(self._speechHandle, c_double(float(rate)))
+
+    def setTimeCompression(self, factor: float) -> None:
+        """Speed up rendered audio by factor (1.0 = off) without changing pitch."""
+        self._dll.speechPlayer_setTimeCompression(self._speechHandle, c_double(float(factor)))
+
     def getLastIndex(self) -> int:
         return int(self._dll.speechPlayer_getLastIndex(self._speechHandle))
 
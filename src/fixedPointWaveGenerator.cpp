@@ -0,0 +1,550 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+/*
+Fixed point port of the scalar path in speechWaveGenerator.cpp.
+Every stage mirrors its floating point counterpart; only the number format differs.
+The FrameManager hands over both ends of each transition as doubles (see getCurrentTransition). They are converted to integers
+once per transition, and fades are done in Q16, so the only doubles read per sample are the fade position and the pitch.
+*/
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include "utils.h"
+#include "fixedPointWaveGenerator.h"
+
+// Signal and parameter format: signed 32 bit with 16 fractional bits, so intermediate resonator peaks have plenty of headroom.
+typedef int32_t q16;
+const int q16FracBits=16;
+const q16 q16One=1<<q16FracBits;
+
+// Resonator coefficient mantissas are kept below this many bits, so three 64 bit products can be summed without overflow.
+const int coefficientBits=30;
+const int maxCoefficientShift=46;
+// A two-pole resonator always has |b|<2, |c|<1 and a=1-b-c<4, so every resonator but the antiresonator can use this fixed shift.
+const int resonatorCoefficientShift=coefficientBits-2;
+
+const int sineTableBits=10;
+const int sineTableSize=1<<sineTableBits;
+const int pulseTableBits=10;
+const int pulseTableSize=1<<pulseTableBits;
+
+constexpr q16 q16Const(double value) {
+	return (q16)(value*q16One+((value<0)?-0.5:0.5));
+}
+
+inline q16 saturate(int64_t value) {
+	return (q16)((value>INT32_MAX)?INT32_MAX:((value<INT32_MIN)?INT32_MIN:value));
+}
+
+inline q16 toQ16(double value) {
+	double scaled=value*q16One;
+	if(!(scaled<2147483647.0)) return (scaled!=scaled)?0:INT32_MAX;
+	if(scaled<-2147483648.0) return INT32_MIN;
+	return (q16)(scaled+((scaled<0)?-0.5:0.5));
+}
+
+inline q16 mulQ16(q16 x, q16 y) {
+	return saturate(((int64_t)x*y+(1<<(q16FracBits-1)))>>q16FracBits);
+}
+
+inline q16 addQ16(q16 x, q16 y) {
+	return saturate((int64_t)x+y);
+}
+
+inline q16 subQ16(q16 x, q16 y) {
+	return saturate((int64_t)x-y);
+}
+
+// Fixed point calculateValueAtFadePosition.
+inline q16 fadeQ16(q16 oldVal, q16 newVal, q16 ratio) {
+	return saturate(oldVal+((((int64_t)newVal-oldVal)*ratio+(1<<(q16FracBits-1)))>>q16FracBits));
+}
+
+// Fixed point calculateTrillClosure, with cyclePos running from 0 to q16One over a cycle.
+inline q16 trillClosureQ16(q16 cyclePos, q16 rate, q16 closureFraction) {
+	if(closureFraction<=0) return 0;
+	if(closureFraction>q16One) closureFraction=q16One;
+	q16 edge=mulQ16(rate,q16Const(0.002));
+	if(edge>q16Const(0.12)) edge=q16Const(0.12);
+	if(edge>closureFraction/2) edge=closureFraction/2;
+	q16 closureStart=q16One-closureFraction;
+	if(cyclePos<closureStart) return 0;
+	if(cyclePos<closureStart+edge) return (q16)((((int64_t)cyclePos-closureStart)<<q16FracBits)/edge);
+	if(cyclePos<q16One-edge) return q16One;
+	return (q16)((((int64_t)q16One-cyclePos)<<q16FracBits)/edge);
+}
+
+/*
+The frame parameters the per-sample loop reads, converted from one end of a transition.
+Every field is 32 bits so a fade can walk the struct as an array, as the FrameManager does with frames.
+Frequencies are kept as phase steps (a full cycle is 2^32); everything else is Q16.
+*/
+struct FixedFrameParams {
+	int32_t vibratoPhaseStep;
+	q16 vibratoDepth; // vibratoPitchOffset*0.06
+	q16 voiceTurbulenceAmplitude;
+	q16 glottalOpenQuotient;
+	q16 voiceAmplitude;
+	q16 aspirationAmplitude;
+	q16 trillRate;
+	int32_t trillPhaseStep;
+	q16 trillDepth;
+	q16 trillClosureFraction;
+	q16 trillFricationFloor;
+	q16 caNP;
+	q16 fricationAmplitude;
+	q16 pa[6];
+	q16 parallelBypass;
+	q16 preFormantGain;
+	q16 outputGain;
+};
+
+const int fixedFrameParams_numParams=sizeof(FixedFrameParams)/sizeof(int32_t);
+
+inline int32_t toPhaseStep(double frequency, double phaseScale) {
+	double step=frequency*phaseScale;
+	if(!(step<2147483647.0)) return (step!=step)?0:INT32_MAX;
+	if(step<-2147483648.0) return INT32_MIN;
+	return (int32_t)step;
+}
+
+// A NaN in the frame being faded to keeps the value of the frame being faded from, as in calculateValueAtFadePosition.
+inline double fadeTarget(double newVal, double oldVal) {
+	return (newVal!=newVal)?oldVal:newVal;
+}
+
+inline void convertFrameParams(const speechPlayer_frame_t* frame, const speechPlayer_frame_t* fromFrame, double phaseScale, FixedFrameParams& params) {
+	params.vibratoPhaseStep=toPhaseStep(fadeTarget(frame->vibratoSpeed,fromFrame->vibratoSpeed),phaseScale);
+	params.vibratoDepth=toQ16(fadeTarget(frame->vibratoPitchOffset,fromFrame->vibratoPitchOffset)*0.06);
+	params.voiceTurbulenceAmplitude=toQ16(fadeTarget(frame->voiceTurbulenceAmplitude,fromFrame->voiceTurbulenceAmplitude));
+	params.glottalOpenQuotient=toQ16(fadeTarget(frame->glottalOpenQuotient,fromFrame->glottalOpenQuotient));
+	params.voiceAmplitude=toQ16(fadeTarget(frame->voiceAmplitude,fromFrame->voiceAmplitude));
+	params.aspirationAmplitude=toQ16(fadeTarget(frame->aspirationAmplitude,fromFrame->aspirationAmplitude));
+	params.trillRate=toQ16(fadeTarget(frame->trillRate,fromFrame->trillRate));
+	params.trillPhaseStep=toPhaseStep(fadeTarget(frame->trillRate,fromFrame->trillRate),phaseScale);
+	params.trillDepth=toQ16(fadeTarget(frame->trillDepth,fromFrame->trillDepth));
+	params.trillClosureFraction=toQ16(fadeTarget(frame->trillClosureFraction,fromFrame->trillClosureFraction));
+	params.trillFricationFloor=toQ16(fadeTarget(frame->trillFricationFloor,fromFrame->trillFricationFloor));
+	params.caNP=toQ16(fadeTarget(frame->caNP,fromFrame->caNP));
+	params.fricationAmplitude=toQ16(fadeTarget(frame->fricationAmplitude,fromFrame->fricationAmplitude));
+	const speechPlayer_frameParam_t* pa[6]={&frame->pa1,&frame->pa2,&frame->pa3,&frame->pa4,&frame->pa5,&frame->pa6};
+	const speechPlayer_frameParam_t* fromPa[6]={&fromFrame->pa1,&fromFrame->pa2,&fromFrame->pa3,&fromFrame->pa4,&fromFrame->pa5,&fromFrame->pa6};
+	for(int k=0;k<6;++k) params.pa[k]=toQ16(fadeTarget(*pa[k],*fromPa[k]));
+	params.parallelBypass=toQ16(fadeTarget(frame->parallelBypass,fromFrame->parallelBypass));
+	params.preFormantGain=toQ16(fadeTarget(frame->preFormantGain,fromFrame->preFormantGain));
+	params.outputGain=toQ16(fadeTarget(frame->outputGain,fromFrame->outputGain));
+}
+
+class FixedNoiseGenerator {
+	private:
+	// Scales rand() to [0, 1) in Q16 with a multiply and shift, whatever RAND_MAX is.
+	int64_t randScale;
+	q16 lastValue;
+	// Private random state, or NULL to use rand().
+	unsigned int* randomState;
+
+	public:
+	FixedNoiseGenerator(): randScale((((int64_t)1)<<48)/RAND_MAX), lastValue(0), randomState(NULL) {}
+
+	void setRandomState(unsigned int* state) {
+		randomState=state;
+		randScale=(((int64_t)1)<<48)/(state?nextRandomMax:RAND_MAX);
+	}
+
+	void reset() {
+		lastValue=0;
+	}
+
+	q16 getNext() {
+		int random=randomState?nextRandom(*randomState):rand();
+		q16 value=(q16)(((int64_t)random*randScale)>>32)-q16One/2;
+		lastValue=saturate(value+((3*(int64_t)lastValue)>>2));
+		return lastValue;
+	}
+
+};
+
+class FixedVoiceGenerator {
+	private:
+	// Phase accumulators: a full cycle is 2^32, so wrapping around is free.
+	uint32_t pitchPhase;
+	uint32_t vibratoPhase;
+	uint32_t trillPhase;
+	FixedNoiseGenerator aspirationGen;
+	q16 sineTable[sineTableSize+1];
+	// Glottal pulse over the open phase, already doubled as in the reference.
+	q16 pulseTable[pulseTableSize+1];
+
+	q16 lookupSine(uint32_t phase) {
+		int index=phase>>(32-sineTableBits);
+		int64_t frac=(phase>>(32-sineTableBits-q16FracBits))&(q16One-1);
+		return (q16)(sineTable[index]+(((sineTable[index+1]-sineTable[index])*frac)>>q16FracBits));
+	}
+
+	q16 lookupPulse(q16 phase) {
+		if(phase>=q16One) return pulseTable[pulseTableSize];
+		const int fracBits=q16FracBits-pulseTableBits;
+		int index=phase>>fracBits;
+		int frac=phase&((1<<fracBits)-1);
+		return (q16)(pulseTable[index]+(((int64_t)(pulseTable[index+1]-pulseTable[index])*frac)>>fracBits));
+	}
+
+	public:
+	bool glottisOpen;
+	// How far into a trill closure the last sample was, 0 when the frame has no trill.
+	q16 trillClosure;
+
+	FixedVoiceGenerator(): pitchPhase(0), vibratoPhase(0), trillPhase(0), aspirationGen(), glottisOpen(false), trillClosure(0) {
+		for(int i=0;i<=sineTableSize;++i) {
+			sineTable[i]=q16Const(sin(M_PI*2*i/sineTableSize));
+		}
+		for(int i=0;i<=pulseTableSize;++i) {
+			double phase=(double)i/pulseTableSize;
+			double voice;
+			if(phase<0.9) {
+				voice=0.5*(1-cos(phase*M_PI/0.9));
+			} else {
+				double v=(phase-0.9)*10;
+				voice=1-v*v;
+			}
+			pulseTable[i]=q16Const(voice*2);
+		}
+	}
+
+	void reset() {
+		pitchPhase=0;
+		vibratoPhase=0;
+		trillPhase=0;
+		aspirationGen.reset();
+		glottisOpen=false;
+		trillClosure=0;
+	}
+
+	void setRandomState(unsigned int* state) {
+		aspirationGen.setRandomState(state);
+	}
+
+	// pitchStep is the pitch as a phase step, the one parameter that is not faded linearly.
+	q16 getNext(const FixedFrameParams& params, int64_t pitchStep) {
+		vibratoPhase+=(uint32_t)params.vibratoPhaseStep;
+		q16 vibrato=q16One+mulQ16(lookupSine(vibratoPhase),params.vibratoDepth);
+		pitchPhase+=(uint32_t)((pitchStep*vibrato)>>q16FracBits);
+		q16 voice=(q16)(pitchPhase>>(32-q16FracBits));
+		q16 aspiration=mulQ16(aspirationGen.getNext(),q16Const(0.1));
+		q16 turbulence=mulQ16(aspiration,params.voiceTurbulenceAmplitude);
+		q16 effectiveOQ=params.glottalOpenQuotient;
+		if(effectiveOQ<=0) effectiveOQ=q16Const(0.7);
+		glottisOpen=voice>=effectiveOQ;
+		if(!glottisOpen) {
+			turbulence=mulQ16(turbulence,q16Const(0.01));
+			voice=0;
+		} else {
+			q16 openLen=q16One-effectiveOQ;
+			if(openLen<q16Const(0.0001)) openLen=q16Const(0.0001);
+			q16 phase=(q16)((((int64_t)voice-effectiveOQ)<<q16FracBits)/openLen);
+			voice=lookupPulse(phase);
+		}
+		voice=addQ16(voice,turbulence);
+		voice=mulQ16(voice,params.voiceAmplitude);
+		if(params.trillRate>0) {
+			trillPhase+=(uint32_t)params.trillPhaseStep;
+			trillClosure=trillClosureQ16((q16)(trillPhase>>(32-q16FracBits)),params.trillRate,params.trillClosureFraction);
+			voice=mulQ16(voice,subQ16(q16One,mulQ16(trillClosure,params.trillDepth)));
+		} else {
+			// Every trill starts at the open part of its first cycle.
+			trillPhase=0;
+			trillClosure=0;
+		}
+		aspiration=mulQ16(aspiration,params.aspirationAmplitude);
+		return addQ16(aspiration,voice);
+	}
+
+};
+
+/*
+All 14 resonators of a frame, structure-of-arrays.
+Each resonator has its own coefficient shift (block floating point). The nasal antiresonator inverts a small gain,
+so its coefficients can be large, and its shift is chosen from their size at both ends of each transition.
+Both ends are converted once per transition, and the coefficients in use are faded between them in integer arithmetic.
+*/
+class FixedResonators {
+	private:
+	int32_t fromA[speechPlayer_numResonators];
+	int32_t fromB[speechPlayer_numResonators];
+	int32_t fromC[speechPlayer_numResonators];
+	int32_t toA[speechPlayer_numResonators];
+	int32_t toB[speechPlayer_numResonators];
+	int32_t toC[speechPlayer_numResonators];
+	int transitionShift[speechPlayer_numResonators];
+	// Fade position the coefficients in use were taken at, or -1 when they belong to an earlier transition.
+	q16 appliedFadeRatio;
+	int32_t a[speechPlayer_numResonators];
+	int32_t b[speechPlayer_numResonators];
+	int32_t c[speechPlayer_numResonators];
+	int shift[speechPlayer_numResonators];
+	q16 p1[speechPlayer_numResonators];
+	q16 p2[speechPlayer_numResonators];
+
+	static int32_t toCoefficient(double value, double scale) {
+		return (int32_t)(value*scale+((value<0)?-0.5:0.5));
+	}
+
+	static int32_t fadeCoefficient(int32_t oldVal, int32_t newVal, q16 ratio) {
+		return (int32_t)(oldVal+((((int64_t)newVal-oldVal)*ratio+(1<<(q16FracBits-1)))>>q16FracBits));
+	}
+
+	public:
+	FixedResonators(): appliedFadeRatio(-1) {
+		for(int i=0;i<speechPlayer_numResonators;++i) {
+			fromA[i]=fromB[i]=fromC[i]=0;
+			toA[i]=toB[i]=toC[i]=0;
+			transitionShift[i]=0;
+			a[i]=b[i]=c[i]=0;
+			shift[i]=0;
+		}
+		reset();
+	}
+
+	void reset() {
+		for(int i=0;i<speechPlayer_numResonators;++i) {
+			p1[i]=0;
+			p2[i]=0;
+		}
+	}
+
+	// The coefficients in use are left alone until the next setFadePosition.
+	void setTransition(const speechPlayer_frameCoefficients_t* from, const speechPlayer_frameCoefficients_t* to) {
+		for(int i=0;i<speechPlayer_numResonators;++i) {
+			const speechPlayer_resonatorCoefficients_t& f=from->resonators[i];
+			const speechPlayer_resonatorCoefficients_t& t=to->resonators[i];
+			double ta=fadeTarget(t.a,f.a), tb=fadeTarget(t.b,f.b), tc=fadeTarget(t.c,f.c);
+			int s=resonatorCoefficientShift;
+			if(i==speechPlayer_resonator_cfN0) {
+				// Every point of the fade is a mix of the two ends, so it is no larger than the larger of them.
+				double maxAbs=fabs(f.a);
+				if(fabs(f.b)>maxAbs) maxAbs=fabs(f.b);
+				if(fabs(f.c)>maxAbs) maxAbs=fabs(f.c);
+				if(fabs(ta)>maxAbs) maxAbs=fabs(ta);
+				if(fabs(tb)>maxAbs) maxAbs=fabs(tb);
+				if(fabs(tc)>maxAbs) maxAbs=fabs(tc);
+				int exponent=0;
+				frexp(maxAbs,&exponent);
+				s=coefficientBits-exponent;
+				if(s<0) s=0;
+				if(s>maxCoefficientShift) s=maxCoefficientShift;
+			}
+			double scale=(double)(((int64_t)1)<<s);
+			transitionShift[i]=s;
+			fromA[i]=toCoefficient(f.a,scale);
+			fromB[i]=toCoefficient(f.b,scale);
+			fromC[i]=toCoefficient(f.c,scale);
+			toA[i]=toCoefficient(ta,scale);
+			toB[i]=toCoefficient(tb,scale);
+			toC[i]=toCoefficient(tc,scale);
+		}
+		appliedFadeRatio=-1;
+	}
+
+	void setFadePosition(q16 ratio) {
+		if(ratio==appliedFadeRatio) return;
+		appliedFadeRatio=ratio;
+		for(int i=0;i<speechPlayer_numResonators;++i) {
+			shift[i]=transitionShift[i];
+			a[i]=fadeCoefficient(fromA[i],toA[i],ratio);
+			b[i]=fadeCoefficient(fromB[i],toB[i],ratio);
+			c[i]=fadeCoefficient(fromC[i],toC[i],ratio);
+		}
+	}
+
+	q16 resonate(int i, q16 in) {
+		int64_t acc=(int64_t)a[i]*in+(int64_t)b[i]*p1[i]+(int64_t)c[i]*p2[i];
+		q16 out=saturate((acc+((((int64_t)1)<<shift[i])>>1))>>shift[i]);
+		p2[i]=p1[i];
+		p1[i]=(i==speechPlayer_resonator_cfN0)?in:out;
+		return out;
+	}
+
+	// Runs the first numFormants parallel formants on the same input. The lanes are independent, so this loop vectorizes.
+	q16 resonateParallel(q16 in, const q16* amplitudes, int numFormants) {
+		q16 out[6];
+		for(int k=0;k<numFormants;++k) {
+			int i=speechPlayer_resonator_pf1+k;
+			int64_t acc=(int64_t)a[i]*in+(int64_t)b[i]*p1[i]+(int64_t)c[i]*p2[i];
+			out[k]=saturate((acc+((((int64_t)1)<<shift[i])>>1))>>shift[i]);
+			p2[i]=p1[i];
+			p1[i]=out[k];
+		}
+		int64_t sum=0;
+		for(int k=0;k<numFormants;++k) {
+			sum+=((((int64_t)out[k]-in)*amplitudes[k])+(1<<(q16FracBits-1)))>>q16FracBits;
+		}
+		return saturate(sum);
+	}
+
+};
+
+class FixedPointWaveGeneratorImpl: public FixedPointWaveGenerator {
+	private:
+	FixedVoiceGenerator voiceGenerator;
+	FixedNoiseGenerator fricGenerator;
+	FixedResonators resonators;
+	// Formants above this are never rendered at this sample rate (see calculateAudibleFormants).
+	int numFormants;
+	FrameManager* frameManager;
+	// The FrameManager's transition, the parameters at both of its ends, and the parameters at the current fade position.
+	speechPlayer_frameTransition_t transition;
+	unsigned int convertedSerial;
+	FixedFrameParams fromParams;
+	FixedFrameParams toParams;
+	FixedFrameParams params;
+	// Fade position params was taken at, or -1 when it belongs to an earlier transition.
+	q16 paramsFadeRatio;
+	double phaseScale;
+	q16 lastInput;
+	q16 lastOutput;
+	q16 lastVoiceInput;
+	q16 lastVoiceOutput;
+	bool wasSilence;
+	double lastVoicePitch;
+	unsigned int noiseState;
+
+	void beginTransition() {
+		convertedSerial=transition.serial;
+		convertFrameParams(&transition.fromFrame,&transition.fromFrame,phaseScale,fromParams);
+		if(transition.fading) {
+			convertFrameParams(&transition.toFrame,&transition.fromFrame,phaseScale,toParams);
+			resonators.setTransition(&transition.fromCoefficients,&transition.toCoefficients);
+		} else {
+			toParams=fromParams;
+			resonators.setTransition(&transition.fromCoefficients,&transition.fromCoefficients);
+		}
+		paramsFadeRatio=-1;
+	}
+
+	void setFadePosition(q16 ratio) {
+		paramsFadeRatio=ratio;
+		const int32_t* from=(const int32_t*)&fromParams;
+		const int32_t* to=(const int32_t*)&toParams;
+		for(int k=0;k<fixedFrameParams_numParams;++k) {
+			((int32_t*)&params)[k]=fadeQ16(from[k],to[k],ratio);
+		}
+	}
+
+	q16 getNextVoice(int64_t pitchStep) {
+		q16 rawVoice=voiceGenerator.getNext(params,pitchStep);
+		q16 voice=addQ16(subQ16(rawVoice,lastVoiceInput),mulQ16(lastVoiceOutput,q16Const(0.995)));
+		lastVoiceInput=rawVoice;
+		lastVoiceOutput=voice;
+		return voice;
+	}
+
+	q16 getNextCascade(q16 input) {
+		input>>=1;
+		q16 n0Output=resonators.resonate(speechPlayer_resonator_cfN0,input);
+		q16 output=fadeQ16(input,resonators.resonate(speechPlayer_resonator_cfNP,n0Output),params.caNP);
+		for(int i=speechPlayer_resonator_cf1+numFormants-1;i>=speechPlayer_resonator_cf1;--i) {
+			output=resonators.resonate(i,output);
+		}
+		return output;
+	}
+
+	q16 getNextParallel() {
+		q16 fricationAmplitude=params.fricationAmplitude;
+		if(voiceGenerator.trillClosure>0&&params.trillFricationFloor>fricationAmplitude) {
+			fricationAmplitude=fadeQ16(fricationAmplitude,params.trillFricationFloor,voiceGenerator.trillClosure);
+		}
+		q16 fric=mulQ16(mulQ16(fricGenerator.getNext(),q16Const(0.175)),fricationAmplitude);
+		q16 input=mulQ16(fric,params.preFormantGain)>>1;
+		q16 output=resonators.resonateParallel(input,params.pa,numFormants);
+		return fadeQ16(output,input,params.parallelBypass);
+	}
+
+	sampleVal mixOutput(q16 cascadeOut, q16 parallelOut, q16 outputGain) {
+		q16 out=mulQ16(addQ16(cascadeOut,parallelOut),outputGain);
+		q16 filteredOut=addQ16(subQ16(out,lastInput),mulQ16(lastOutput,q16Const(0.999)));
+		lastInput=out;
+		lastOutput=filteredOut;
+		int64_t scaled=((int64_t)filteredOut*4000)/q16One;
+		return (sampleVal)((scaled>32000)?32000:((scaled<-32000)?-32000:scaled));
+	}
+
+	public:
+	FixedPointWaveGeneratorImpl(int sr): voiceGenerator(), fricGenerator(), numFormants(calculateAudibleFormants(sr)), frameManager(NULL), transition(), convertedSerial(0), fromParams(), toParams(), params(), paramsFadeRatio(-1), phaseScale(4294967296.0/sr), lastInput(0), lastOutput(0), lastVoiceInput(0), lastVoiceOutput(0), wasSilence(true), lastVoicePitch(0), noiseState(0) {
+	}
+
+	void reset() {
+		voiceGenerator.reset();
+		fricGenerator.reset();
+		resonators.reset();
+		lastInput=0;
+		lastOutput=0;
+		lastVoiceInput=0;
+		lastVoiceOutput=0;
+		wasSilence=false;
+	}
+
+	unsigned int generate(const unsigned int sampleCount, sample* sampleBuf) {
+		if(!frameManager) return 0;
+		for(unsigned int i=0;i<sampleCount;++i) {
+			if(!frameManager->getCurrentTransition(&transition)) {
+				wasSilence=true;
+				return i;
+			}
+			if(wasSilence) reset();
+			if(transition.serial!=convertedSerial) beginTransition();
+			q16 fadeRatio=transition.fading?toQ16(transition.fadeRatio):0;
+			if(fadeRatio!=paramsFadeRatio) setFadePosition(fadeRatio);
+			lastVoicePitch=transition.voicePitch;
+			q16 voice=getNextVoice((int64_t)(transition.voicePitch*phaseScale));
+			// As in the reference, coefficients only change while the glottis is closed.
+			if(!voiceGenerator.glottisOpen) resonators.setFadePosition(fadeRatio);
+			q16 cascadeOut=getNextCascade(mulQ16(voice,params.preFormantGain));
+			q16 parallelOut=getNextParallel();
+			sampleBuf[i].value=mixOutput(cascadeOut,parallelOut,params.outputGain);
+		}
+		return sampleCount;
+	}
+
+	void setFrameManager(FrameManager* frameManager) {
+		this->frameManager=frameManager;
+	}
+
+	double getLastVoicePitch() {
+		return lastVoicePitch;
+	}
+
+	// The copy keeps pointing its noise generators at this generator's noiseState, so it is only good for restoring into this generator.
+	WaveGeneratorState* saveState() {
+		return new WaveGeneratorCopy<FixedPointWaveGeneratorImpl>(*this);
+	}
+
+	void restoreState(const WaveGeneratorState* state) {
+		*this=static_cast<const WaveGeneratorCopy<FixedPointWaveGeneratorImpl>*>(state)->generator;
+	}
+
+	void setNoiseSeed(unsigned int seed) {
+		noiseState=seed;
+		voiceGenerator.setRandomState(&noiseState);
+		fricGenerator.setRandomState(&noiseState);
+	}
+
+};
+
+FixedPointWaveGenerator* FixedPointWaveGenerator::create(int sampleRate) {
+	return new FixedPointWaveGeneratorImpl(sampleRate);
+}
@@ -0,0 +1,31 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#ifndef SPEECHPLAYER_FIXEDPOINTWAVEGENERATOR_H
+#define SPEECHPLAYER_FIXEDPOINTWAVEGENERATOR_H
+
+#include "speechWaveGenerator.h"
+
+/**
+ * Integer implementation of the synthesizer, for CPUs with weak floating point.
+ * Signals are 32 bit Q16 values, resonators accumulate in 64 bits with saturation,
+ * and the voice source runs on phase accumulators and lookup tables instead of fmod, sin and cos.
+ * It follows the scalar reference path sample for sample and produces the same int16 output format.
+ */
+class FixedPointWaveGenerator: public SpeechWaveGenerator {
+	public:
+	static FixedPointWaveGenerator* create(int sampleRate);
+};
+
+#endif
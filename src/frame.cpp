@@ -12,115 +12,292 @@ This license can be found at:
 http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
 */
 
+#include <cmath>
 #include <queue>
+#include <vector>
 #include <cstring>
 #include "utils.h"
 #include "frame.h"
 
 using namespace std;
 
+const int frameCoefficients_numParams=sizeof(speechPlayer_frameCoefficients_t)/sizeof(double);
+
+void speechPlayer_calculateFrameCoefficients(int sampleRate, const speechPlayer_frame_t* frame, speechPlayer_frameCoefficients_t* coefficients) {
+	const speechPlayer_frameParam_t* frequencies[speechPlayer_numResonators]={&frame->cf1,&frame->cf2,&frame->cf3,&frame->cf4,&frame->cf5,&frame->cf6,&frame->cfN0,&frame->cfNP,&frame->pf1,&frame->pf2,&frame->pf3,&frame->pf4,&frame->pf5,&frame->pf6};
+	const speechPlayer_frameParam_t* bandwidths[speechPlayer_numResonators]={&frame->cb1,&frame->cb2,&frame->cb3,&frame->cb4,&frame->cb5,&frame->cb6,&frame->cbN0,&frame->cbNP,&frame->pb1,&frame->pb2,&frame->pb3,&frame->pb4,&frame->pb5,&frame->pb6};
+	for(int i=0;i<speechPlayer_numResonators;++i) {
+		speechPlayer_resonatorCoefficients_t& r=coefficients->resonators[i];
+		calculateResonatorCoefficients(sampleRate,*frequencies[i],*bandwidths[i],i==speechPlayer_resonator_cfN0,r.a,r.b,r.c);
+	}
+}
+
 struct frameRequest_t {
 	unsigned int minNumSamples;
 	unsigned int numFadeSamples;
 	bool NULLFrame;
 	speechPlayer_frame_t frame;
+	speechPlayer_frameCoefficients_t coefficients;
 	double voicePitchInc; 
+	// Pitch contours add a curve to the glide: the offset from voicePitch after s samples is voicePitchInc*s+voicePitchQuadratic*s^2+voicePitchCubic*s^3.
+	double voicePitchQuadratic;
+	double voicePitchCubic;
 	int userIndex;
 };
 
+// How far the pitch of a request has moved from its voicePitch after numSamples.
+inline double calculatePitchOffset(const frameRequest_t* frameRequest, double numSamples) {
+	return frameRequest->voicePitchInc*numSamples+(frameRequest->voicePitchQuadratic+frameRequest->voicePitchCubic*numSamples)*numSamples*numSamples;
+}
+
+// Everything a FrameManagerImpl needs to continue from where it was saved; requests are held by value.
+struct frameManagerState_t: public FrameManagerState {
+	vector<frameRequest_t> queuedRequests;
+	frameRequest_t oldFrameRequest;
+	bool hasNewFrameRequest;
+	frameRequest_t newFrameRequest;
+	speechPlayer_frame_t curFrame;
+	speechPlayer_frameCoefficients_t curCoefficients;
+	bool curFrameIsNULL;
+	double sampleCounter;
+	double curRate;
+	double pitchStep;
+	double pitchStep2;
+	double pitchStep3;
+	int lastUserIndex;
+};
+
 class FrameManagerImpl: public FrameManager {
 	private:
+	int sampleRate;
 	LockableObject frameLock;
 	queue<frameRequest_t*> frameRequestQueue;
 	frameRequest_t* oldFrameRequest;
 	frameRequest_t* newFrameRequest;
 	speechPlayer_frame_t curFrame;
+	speechPlayer_frameCoefficients_t curCoefficients;
 	bool curFrameIsNULL;
-	unsigned int sampleCounter;
+	// Counts in source samples, advancing by curRate per output sample.
+	double sampleCounter;
+	double rate;
+	double curRate;
+	// Forward differences of the held frame's pitch, one call at curRate apart, so a contour costs two extra adds per sample.
+	double pitchStep;
+	double pitchStep2;
+	double pitchStep3;
 	int lastUserIndex;
+	// Bumped whenever either end of the transition changes, so getCurrentTransition only copies frames when it has to.
+	unsigned int transitionSerial;
+	// Set while a fade is being left to the caller of getCurrentTransition: only curFrame.voicePitch is current.
+	bool curFrameStale;
 
-	void updateCurrentFrame() {
-		sampleCounter++;
+	void finishFade() {
+		delete oldFrameRequest;
+		oldFrameRequest=newFrameRequest;
+		newFrameRequest=NULL;
+		++transitionSerial;
+		// Ensure curFrame is updated even when numFadeSamples==0.
+		memcpy(&curFrame, &(oldFrameRequest->frame), sizeof(speechPlayer_frame_t));
+		memcpy(&curCoefficients, &(oldFrameRequest->coefficients), sizeof(speechPlayer_frameCoefficients_t));
+		curFrameStale=false;
+		// The hold picks up the glide where the fade aimed it, numFadeSamples into the frame.
+		double s=oldFrameRequest->numFadeSamples;
+		double h=curRate;
+		pitchStep=oldFrameRequest->voicePitchInc*h+oldFrameRequest->voicePitchQuadratic*(2*s+h)*h+oldFrameRequest->voicePitchCubic*((3*s+3*h)*s+h*h)*h;
+		pitchStep2=oldFrameRequest->voicePitchQuadratic*2*h*h+oldFrameRequest->voicePitchCubic*6*(s+h)*h*h;
+		pitchStep3=oldFrameRequest->voicePitchCubic*6*h*h*h;
+	}
+
+	// Moves the held frame's pitch on by numSteps calls.
+	void advancePitch(double numSteps) {
+		double pairs=numSteps*(numSteps-1)/2;
+		curFrame.voicePitch+=pitchStep*numSteps+pitchStep2*pairs+pitchStep3*(pairs*(numSteps-2)/3);
+		pitchStep+=pitchStep2*numSteps+pitchStep3*pairs;
+		pitchStep2+=pitchStep3*numSteps;
+		oldFrameRequest->frame.voicePitch=curFrame.voicePitch;
+	}
+
+	void setFadePosition(double curFadeRatio) {
+		for(int i=0;i<speechPlayer_frame_numParams;++i) {
+			((speechPlayer_frameParam_t*)&curFrame)[i]=calculateValueAtFadePosition(((speechPlayer_frameParam_t*)&(oldFrameRequest->frame))[i],((speechPlayer_frameParam_t*)&(newFrameRequest->frame))[i],curFadeRatio);
+		}
+		// Blending the coefficients directly keeps the fade down to multiply-adds.
+		// Each set of pole coefficients is stable, and so is any linear mix of two of them.
+		for(int i=0;i<frameCoefficients_numParams;++i) {
+			((double*)&curCoefficients)[i]=calculateValueAtFadePosition(((double*)&(oldFrameRequest->coefficients))[i],((double*)&(newFrameRequest->coefficients))[i],curFadeRatio);
+		}
+		curFrameStale=false;
+	}
+
+	// Brings curFrame and curCoefficients up to date after getCurrentTransition left a fade to its caller.
+	void syncCurrentFrame() {
+		if(curFrameStale&&newFrameRequest) setFadePosition(sampleCounter/(newFrameRequest->numFadeSamples));
+		curFrameStale=false;
+	}
+
+	// Called once the current frame has been held for its minimum duration.
+	void beginNextTransition() {
+		++transitionSerial;
+		if(!frameRequestQueue.empty()) {
+			curFrameIsNULL=false;
+			newFrameRequest=frameRequestQueue.front();
+			frameRequestQueue.pop();
+			if(newFrameRequest->NULLFrame) {
+				memcpy(&(newFrameRequest->frame),&(oldFrameRequest->frame),sizeof(speechPlayer_frame_t));
+				memcpy(&(newFrameRequest->coefficients),&(oldFrameRequest->coefficients),sizeof(speechPlayer_frameCoefficients_t));
+				newFrameRequest->frame.preFormantGain=0;
+				newFrameRequest->frame.voicePitch=curFrame.voicePitch;
+				newFrameRequest->voicePitchInc=0;
+				newFrameRequest->voicePitchQuadratic=0;
+				newFrameRequest->voicePitchCubic=0;
+			} else if(oldFrameRequest->NULLFrame) {
+				memcpy(&(oldFrameRequest->frame),&(newFrameRequest->frame),sizeof(speechPlayer_frame_t));
+				memcpy(&(oldFrameRequest->coefficients),&(newFrameRequest->coefficients),sizeof(speechPlayer_frameCoefficients_t));
+				oldFrameRequest->frame.preFormantGain=0;
+			}
+			if(newFrameRequest) {
+				if(newFrameRequest->userIndex!=-1) lastUserIndex=newFrameRequest->userIndex;
+				sampleCounter=0;
+				// A new rate only takes effect from the start of a transition.
+				curRate=rate;
+				// Process the start of the transition immediately (sample 0), so the
+				// first sample of a new segment can't use stale/garbage parameters.
+				memcpy(&curFrame, &(oldFrameRequest->frame), sizeof(speechPlayer_frame_t));
+				memcpy(&curCoefficients, &(oldFrameRequest->coefficients), sizeof(speechPlayer_frameCoefficients_t));
+				curFrameStale=false;
+				newFrameRequest->frame.voicePitch+=calculatePitchOffset(newFrameRequest,newFrameRequest->numFadeSamples);
+			}
+		} else {
+			curFrameIsNULL=true;
+		}
+	}
+
+	// With fadeFrame false, a fade only keeps curFrame.voicePitch current and leaves the rest to the caller of getCurrentTransition.
+	void updateCurrentFrame(bool fadeFrame) {
+		sampleCounter+=curRate;
 		if(newFrameRequest) {
 			if(sampleCounter>(newFrameRequest->numFadeSamples)) {
-				delete oldFrameRequest;
-				oldFrameRequest=newFrameRequest;
-				newFrameRequest=NULL;
-				// Ensure curFrame is updated even when numFadeSamples==0.
-				memcpy(&curFrame, &(oldFrameRequest->frame), sizeof(speechPlayer_frame_t));
+				finishFade();
+			} else if(fadeFrame) {
+				setFadePosition((double)sampleCounter/(newFrameRequest->numFadeSamples));
 			} else {
-				double curFadeRatio=(double)sampleCounter/(newFrameRequest->numFadeSamples);
-				for(int i=0;i<speechPlayer_frame_numParams;++i) {
-					((speechPlayer_frameParam_t*)&curFrame)[i]=calculateValueAtFadePosition(((speechPlayer_frameParam_t*)&(oldFrameRequest->frame))[i],((speechPlayer_frameParam_t*)&(newFrameRequest->frame))[i],curFadeRatio);
-				}
+				curFrame.voicePitch=calculateValueAtFadePosition(oldFrameRequest->frame.voicePitch,newFrameRequest->frame.voicePitch,(double)sampleCounter/(newFrameRequest->numFadeSamples));
+				curFrameStale=true;
 			}
 		} else if(sampleCounter>(oldFrameRequest->minNumSamples)) {
-			if(!frameRequestQueue.empty()) {
-				curFrameIsNULL=false;
-				newFrameRequest=frameRequestQueue.front();
-				frameRequestQueue.pop();
-				if(newFrameRequest->NULLFrame) {
-					memcpy(&(newFrameRequest->frame),&(oldFrameRequest->frame),sizeof(speechPlayer_frame_t));
-					newFrameRequest->frame.preFormantGain=0;
-					newFrameRequest->frame.voicePitch=curFrame.voicePitch;
-					newFrameRequest->voicePitchInc=0;
-				} else if(oldFrameRequest->NULLFrame) {
-					memcpy(&(oldFrameRequest->frame),&(newFrameRequest->frame),sizeof(speechPlayer_frame_t));
-					oldFrameRequest->frame.preFormantGain=0;
-				}
-				if(newFrameRequest) {
-					if(newFrameRequest->userIndex!=-1) lastUserIndex=newFrameRequest->userIndex;
-					sampleCounter=0;
-					// Process the start of the transition immediately (sample 0), so the
-					// first sample of a new segment can't use stale/garbage parameters.
-					memcpy(&curFrame, &(oldFrameRequest->frame), sizeof(speechPlayer_frame_t));
-					newFrameRequest->frame.voicePitch+=(newFrameRequest->voicePitchInc*newFrameRequest->numFadeSamples);
-				}
-			} else {
-				curFrameIsNULL=true;
-			}
+			beginNextTransition();
 		} else {
-			curFrame.voicePitch+=oldFrameRequest->voicePitchInc;
+			curFrame.voicePitch+=pitchStep;
+			pitchStep+=pitchStep2;
+			pitchStep2+=pitchStep3;
 			oldFrameRequest->frame.voicePitch=curFrame.voicePitch;
 		}
 	}
 
+	// Same end state as numSamples calls to updateCurrentFrame, but jumps straight to each frame boundary.
+	void skipSamples(unsigned int numSamples) {
+		while(numSamples>0) {
+			if(newFrameRequest) {
+				// Calls until sampleCounter passes the end of the fade.
+				double steps=floor((newFrameRequest->numFadeSamples-sampleCounter)/curRate)+1;
+				if(steps>numSamples) {
+					sampleCounter+=numSamples*curRate;
+					setFadePosition(sampleCounter/(newFrameRequest->numFadeSamples));
+					return;
+				}
+				sampleCounter+=steps*curRate;
+				numSamples-=(unsigned int)steps;
+				finishFade();
+			} else if(frameRequestQueue.empty()&&sampleCounter>(oldFrameRequest->minNumSamples)) {
+				// Already idle: nothing changes but the counter.
+				curFrameIsNULL=true;
+				sampleCounter+=numSamples*curRate;
+				return;
+			} else {
+				// The first steps-1 calls hold the frame and glide its pitch; the last one starts the next transition.
+				double steps=(sampleCounter>(oldFrameRequest->minNumSamples))?1:floor((oldFrameRequest->minNumSamples-sampleCounter)/curRate)+1;
+				double holdSteps=((steps>numSamples)?numSamples:steps-1);
+				advancePitch(holdSteps);
+				if(steps>numSamples) {
+					sampleCounter+=numSamples*curRate;
+					return;
+				}
+				sampleCounter+=steps*curRate;
+				numSamples-=(unsigned int)steps;
+				beginNextTransition();
+			}
+		}
+	}
 
-	public:
-
-	FrameManagerImpl(): curFrame(), curFrameIsNULL(true), sampleCounter(0), newFrameRequest(NULL), lastUserIndex(-1)  {
+	// Puts the current state back to a silent NULL frame with nothing fading in.
+	void setSilent() {
 		// speechPlayer_frame_t is a plain C struct; ensure it starts from a known state.
 		memset(&curFrame, 0, sizeof(speechPlayer_frame_t));
-		oldFrameRequest=new frameRequest_t();
+		speechPlayer_calculateFrameCoefficients(sampleRate,&curFrame,&curCoefficients);
+		curFrameStale=false;
+		++transitionSerial;
+		curFrameIsNULL=true;
+		sampleCounter=0;
 		oldFrameRequest->minNumSamples=0;
 		oldFrameRequest->numFadeSamples=0;
 		oldFrameRequest->NULLFrame=true;
 		memset(&(oldFrameRequest->frame), 0, sizeof(speechPlayer_frame_t));
+		memcpy(&(oldFrameRequest->coefficients),&curCoefficients,sizeof(speechPlayer_frameCoefficients_t));
 		oldFrameRequest->voicePitchInc=0;
+		oldFrameRequest->voicePitchQuadratic=0;
+		oldFrameRequest->voicePitchCubic=0;
+		pitchStep=0;
+		pitchStep2=0;
+		pitchStep3=0;
 		oldFrameRequest->userIndex=-1;
 	}
 
+	public:
+
+	FrameManagerImpl(int sampleRate): sampleRate(sampleRate), curFrame(), curFrameIsNULL(true), sampleCounter(0), rate(1.0), curRate(1.0), newFrameRequest(NULL), lastUserIndex(-1), transitionSerial(0), curFrameStale(false)  {
+		oldFrameRequest=new frameRequest_t();
+		setSilent();
+	}
+
 	void queueFrame(speechPlayer_frame_t* frame, unsigned int minNumSamples, unsigned int numFadeSamples, int userIndex, bool purgeQueue) {
-		frameLock.acquire();
+		// Everything about the new request, including the expensive coefficient design, is prepared on the caller's thread before taking the lock.
 		frameRequest_t* frameRequest=new frameRequest_t;
 		frameRequest->minNumSamples=minNumSamples; //max(minNumSamples,1);
 		frameRequest->numFadeSamples=numFadeSamples; //max(numFadeSamples,1);
 		if(frame) {
 			frameRequest->NULLFrame=false;
 			memcpy(&(frameRequest->frame),frame,sizeof(speechPlayer_frame_t));
+			speechPlayer_calculateFrameCoefficients(sampleRate,frame,&(frameRequest->coefficients));
 			frameRequest->voicePitchInc=(frameRequest->minNumSamples>0)?((frame->endVoicePitch-frame->voicePitch)/frameRequest->minNumSamples):0;
+			frameRequest->voicePitchQuadratic=0;
+			frameRequest->voicePitchCubic=0;
+			if(frameRequest->minNumSamples>0&&frame->midVoicePitch1>0&&frame->midVoicePitch2>0) {
+				// Cubic through the four pitches at 0, 1/3, 2/3 and 1 of the frame length, rescaled from fractions of the frame to samples.
+				double y0=frame->voicePitch, y1=frame->midVoicePitch1, y2=frame->midVoicePitch2, y3=frame->endVoicePitch;
+				double length=frameRequest->minNumSamples;
+				frameRequest->voicePitchInc=((-11*y0+18*y1-9*y2+2*y3)/2)/length;
+				frameRequest->voicePitchQuadratic=((18*y0-45*y1+36*y2-9*y3)/2)/(length*length);
+				frameRequest->voicePitchCubic=((-9*y0+27*y1-27*y2+9*y3)/2)/(length*length*length);
+			}
 		} else {
 			frameRequest->NULLFrame=true;
 			memset(&(frameRequest->frame), 0, sizeof(speechPlayer_frame_t));
+			memset(&(frameRequest->coefficients), 0, sizeof(speechPlayer_frameCoefficients_t));
 			frameRequest->voicePitchInc=0;
+			frameRequest->voicePitchQuadratic=0;
+			frameRequest->voicePitchCubic=0;
 		}
 		frameRequest->userIndex=userIndex;
+		frameLock.acquire();
 		if(purgeQueue) {
 			for(;!frameRequestQueue.empty();frameRequestQueue.pop()) delete frameRequestQueue.front();
+			syncCurrentFrame();
+			++transitionSerial;
 			sampleCounter=oldFrameRequest->minNumSamples;
 			if(newFrameRequest) {
 				oldFrameRequest->NULLFrame=newFrameRequest->NULLFrame;
 				memcpy(&(oldFrameRequest->frame),&curFrame,sizeof(speechPlayer_frame_t));
+				memcpy(&(oldFrameRequest->coefficients),&curCoefficients,sizeof(speechPlayer_frameCoefficients_t));
 				delete newFrameRequest;
 				newFrameRequest=NULL;
 			}
@@ -129,17 +306,120 @@ class FrameManagerImpl: public FrameManager {
 		frameLock.release();
 	}
 
+	void setRate(double rate) {
+		if(!(rate>0)) return;
+		frameLock.acquire();
+		this->rate=rate;
+		frameLock.release();
+	}
+
+	void reset() {
+		frameLock.acquire();
+		for(;!frameRequestQueue.empty();frameRequestQueue.pop()) delete frameRequestQueue.front();
+		if(newFrameRequest) {
+			delete newFrameRequest;
+			newFrameRequest=NULL;
+		}
+		setSilent();
+		frameLock.release();
+	}
+
+	void skip(unsigned int numSamples) {
+		frameLock.acquire();
+		skipSamples(numSamples);
+		frameLock.release();
+	}
+
+	FrameManagerState* saveState() {
+		frameManagerState_t* state=new frameManagerState_t;
+		frameLock.acquire();
+		syncCurrentFrame();
+		// The queue can only be walked by popping it, so it is rotated once through itself.
+		for(size_t i=frameRequestQueue.size();i>0;--i) {
+			frameRequest_t* frameRequest=frameRequestQueue.front();
+			frameRequestQueue.pop();
+			state->queuedRequests.push_back(*frameRequest);
+			frameRequestQueue.push(frameRequest);
+		}
+		state->oldFrameRequest=*oldFrameRequest;
+		state->hasNewFrameRequest=(newFrameRequest!=NULL);
+		if(newFrameRequest) state->newFrameRequest=*newFrameRequest;
+		state->curFrame=curFrame;
+		state->curCoefficients=curCoefficients;
+		state->curFrameIsNULL=curFrameIsNULL;
+		state->sampleCounter=sampleCounter;
+		state->curRate=curRate;
+		state->pitchStep=pitchStep;
+		state->pitchStep2=pitchStep2;
+		state->pitchStep3=pitchStep3;
+		state->lastUserIndex=lastUserIndex;
+		frameLock.release();
+		return state;
+	}
+
+	void restoreState(const FrameManagerState* savedState) {
+		const frameManagerState_t* state=static_cast<const frameManagerState_t*>(savedState);
+		frameLock.acquire();
+		for(;!frameRequestQueue.empty();frameRequestQueue.pop()) delete frameRequestQueue.front();
+		for(size_t i=0;i<state->queuedRequests.size();++i) frameRequestQueue.push(new frameRequest_t(state->queuedRequests[i]));
+		*oldFrameRequest=state->oldFrameRequest;
+		if(newFrameRequest) {
+			delete newFrameRequest;
+			newFrameRequest=NULL;
+		}
+		if(state->hasNewFrameRequest) newFrameRequest=new frameRequest_t(state->newFrameRequest);
+		curFrame=state->curFrame;
+		curCoefficients=state->curCoefficients;
+		curFrameStale=false;
+		++transitionSerial;
+		curFrameIsNULL=state->curFrameIsNULL;
+		sampleCounter=state->sampleCounter;
+		curRate=state->curRate;
+		pitchStep=state->pitchStep;
+		pitchStep2=state->pitchStep2;
+		pitchStep3=state->pitchStep3;
+		lastUserIndex=state->lastUserIndex;
+		frameLock.release();
+	}
+
 	const int getLastIndex() {
 		return lastUserIndex;
 	}
 
 	const speechPlayer_frame_t* const getCurrentFrame() {
 		frameLock.acquire();
-		updateCurrentFrame();
+		updateCurrentFrame(true);
 		frameLock.release();
 		return curFrameIsNULL?NULL:&curFrame;
 	}
 
+	bool getCurrentTransition(speechPlayer_frameTransition_t* transition) {
+		frameLock.acquire();
+		updateCurrentFrame(false);
+		bool isNULL=curFrameIsNULL;
+		if(!isNULL) {
+			if(transition->serial!=transitionSerial) {
+				transition->serial=transitionSerial;
+				transition->fading=(newFrameRequest!=NULL);
+				memcpy(&(transition->fromFrame),&(oldFrameRequest->frame),sizeof(speechPlayer_frame_t));
+				memcpy(&(transition->fromCoefficients),&(oldFrameRequest->coefficients),sizeof(speechPlayer_frameCoefficients_t));
+				if(newFrameRequest) {
+					memcpy(&(transition->toFrame),&(newFrameRequest->frame),sizeof(speechPlayer_frame_t));
+					memcpy(&(transition->toCoefficients),&(newFrameRequest->coefficients),sizeof(speechPlayer_frameCoefficients_t));
+				}
+			}
+			// A transition starts at sample 0 of its fade, even when the fade has no length.
+			transition->fadeRatio=(newFrameRequest&&newFrameRequest->numFadeSamples>0)?sampleCounter/(newFrameRequest->numFadeSamples):0;
+			transition->voicePitch=curFrame.voicePitch;
+		}
+		frameLock.release();
+		return !isNULL;
+	}
+
+	const speechPlayer_frameCoefficients_t* const getCurrentCoefficients() {
+		return &curCoefficients;
+	}
+
 	~FrameManagerImpl() {
 		if(oldFrameRequest) delete oldFrameRequest;
 		if(newFrameRequest) delete newFrameRequest;
@@ -147,4 +427,4 @@ class FrameManagerImpl: public FrameManager {
 
 };
 
-FrameManager* FrameManager::create() { return new FrameManagerImpl(); }
+FrameManager* FrameManager::create(int sampleRate) { return new FrameManagerImpl(sampleRate); }
@@ -40,15 +40,74 @@ typedef struct {
 	speechPlayer_frameParam_t preFormantGain; // amplitude from 0 to 1 of all vocal tract sound (voicing, frication) before entering formant resonators. Useful for stopping/starting speech
 	speechPlayer_frameParam_t outputGain; // amplitude from 0 to 1 of final output (master volume) 
 	speechPlayer_frameParam_t endVoicePitch; //  pitch of voice at the end of the frame length 
+	// Trill: a per-frame amplitude modulation of the voice source, so a trill needs one frame instead of a train of short ones.
+	speechPlayer_frameParam_t trillRate; // closures per second, 0 for no trill
+	speechPlayer_frameParam_t trillDepth; // fraction from 0 to 1 by which voicing is reduced during a closure
+	speechPlayer_frameParam_t trillClosureFraction; // fraction from 0 to 1 of each trill cycle spent in closure
+	speechPlayer_frameParam_t trillFricationFloor; // minimum fricationAmplitude during a closure
+	// Pitch contour: when both are set, pitch follows a cubic through voicePitch, these two and endVoicePitch, evenly spaced over the frame length.
+	speechPlayer_frameParam_t midVoicePitch1; // pitch of voice a third of the way through the frame length, 0 for a straight glide
+	speechPlayer_frameParam_t midVoicePitch2; // pitch of voice two thirds of the way through the frame length, 0 for a straight glide
 } speechPlayer_frame_t;
 
 const int speechPlayer_frame_numParams=sizeof(speechPlayer_frame_t)/sizeof(speechPlayer_frameParam_t);
 
+// Filter coefficients of one resonator (see calculateResonatorCoefficients in utils.h)
+typedef struct {
+	double a, b, c;
+} speechPlayer_resonatorCoefficients_t;
+
+// Index of each resonator in speechPlayer_frameCoefficients_t
+enum {
+	speechPlayer_resonator_cf1, speechPlayer_resonator_cf2, speechPlayer_resonator_cf3, speechPlayer_resonator_cf4, speechPlayer_resonator_cf5, speechPlayer_resonator_cf6,
+	speechPlayer_resonator_cfN0, speechPlayer_resonator_cfNP,
+	speechPlayer_resonator_pf1, speechPlayer_resonator_pf2, speechPlayer_resonator_pf3, speechPlayer_resonator_pf4, speechPlayer_resonator_pf5, speechPlayer_resonator_pf6,
+	speechPlayer_numResonators
+};
+
+// Coefficients for all resonators of a frame, calculated when the frame is queued
+typedef struct {
+	speechPlayer_resonatorCoefficients_t resonators[speechPlayer_numResonators];
+} speechPlayer_frameCoefficients_t;
+
+// Both ends of the transition a frame manager is in, for generators that do the fading themselves (see FrameManager::getCurrentTransition)
+typedef struct {
+	unsigned int serial; // changes whenever either end is replaced
+	bool fading; // false while a frame is held, in which case toFrame and toCoefficients are not filled in
+	speechPlayer_frame_t fromFrame;
+	speechPlayer_frameCoefficients_t fromCoefficients;
+	speechPlayer_frame_t toFrame; // fields that are NaN keep their fromFrame value, as in calculateValueAtFadePosition
+	speechPlayer_frameCoefficients_t toCoefficients;
+	double fadeRatio; // 0 at fromFrame, 1 at toFrame
+	double voicePitch; // pitch for this sample, which follows the frame's glide rather than the fade
+} speechPlayer_frameTransition_t;
+
+// Opaque copy of a frame manager's queue and position, made by FrameManager::saveState.
+class FrameManagerState {
+	public:
+	virtual ~FrameManagerState() {};
+};
+
+void speechPlayer_calculateFrameCoefficients(int sampleRate, const speechPlayer_frame_t* frame, speechPlayer_frameCoefficients_t* coefficients);
+
 class FrameManager {
 	public:
-	static FrameManager* create(); //factory function
+	static FrameManager* create(int sampleRate); //factory function
 	virtual void queueFrame(speechPlayer_frame_t* frame, unsigned int minNumSamples, unsigned int numFadeSamples, int userIndex, bool purgeQueue)=0;
 	virtual const speechPlayer_frame_t* const getCurrentFrame()=0;
+	// Resonator coefficients matching the frame last returned by getCurrentFrame (interpolated during fades)
+	virtual const speechPlayer_frameCoefficients_t* const getCurrentCoefficients()=0;
+	// Advances by one sample like getCurrentFrame, but leaves the interpolation to the caller: the ends of the transition are copied into transition only when its serial is out of date, and the fade position and pitch are updated every call. Returns false during silence.
+	virtual bool getCurrentTransition(speechPlayer_frameTransition_t* transition)=0;
+	// Plays queued frames rate times faster (durations and pitch glides alike), starting with the next frame transition
+	virtual void setRate(double rate)=0;
+	// Discards every queued frame and returns to silence immediately, as if newly created (the rate is kept)
+	virtual void reset()=0;
+	// Advances the queue by numSamples without producing frames, walking from one frame boundary to the next
+	virtual void skip(unsigned int numSamples)=0;
+	// Copies the queue, the current frame and fade position and the last index (the rate is a setting and is not saved)
+	virtual FrameManagerState* saveState()=0;
+	virtual void restoreState(const FrameManagerState* state)=0;
 	virtual const int getLastIndex()=0; 
 	virtual ~FrameManager()=0 {};
 };
@@ -0,0 +1,41 @@
+#include "conversion_arena.h"
+
+namespace nvsp_frontend {
+
+// Enough for a typical sentence-length clause.
+static constexpr size_t kInitialBufferSize = 64 * 1024;
+// A one-off huge clause still works, but we don't keep a buffer that big.
+static constexpr size_t kMaxBufferSize = 4 * 1024 * 1024;
+
+void* ConversionArena::OverflowResource::do_allocate(size_t n, size_t alignment) {
+  bytes += n;
+  return std::pmr::new_delete_resource()->allocate(n, alignment);
+}
+
+void ConversionArena::OverflowResource::do_deallocate(void* p, size_t n, size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(p, n, alignment);
+}
+
+bool ConversionArena::OverflowResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+ConversionArena::ConversionArena()
+  : buffer_(new std::byte[kInitialBufferSize]), bufferSize_(kInitialBufferSize) {
+  arena_.emplace(buffer_.get(), bufferSize_, &overflow_);
+}
+
+void ConversionArena::reset() {
+  // Destroying the monotonic resource hands any overflow back to the heap.
+  arena_.reset();
+  if (overflow_.bytes > 0 && bufferSize_ < kMaxBufferSize) {
+    size_t grown = bufferSize_ + overflow_.bytes;
+    if (grown > kMaxBufferSize) grown = kMaxBufferSize;
+    buffer_.reset(new std::byte[grown]);
+    bufferSize_ = grown;
+  }
+  overflow_.bytes = 0;
+  arena_.emplace(buffer_.get(), bufferSize_, &overflow_);
+}
+
+} // namespace nvsp_frontend
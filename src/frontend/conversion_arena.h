@@ -0,0 +1,50 @@
+#ifndef NVSP_FRONTEND_CONVERSION_ARENA_H
+#define NVSP_FRONTEND_CONVERSION_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace nvsp_frontend {
+
+// Per-handle memory for the temporaries of one conversion (tokens, normalized
+// text, scratch vectors). Allocation is a pointer bump into one buffer and
+// freeing is a no-op; reset() drops everything at once.
+//
+// When a conversion needs more than the buffer holds, the rest comes from the
+// heap, and the next reset() grows the buffer by that much. So once a handle
+// has seen its longest clause, converting does not touch the heap at all.
+class ConversionArena {
+public:
+  ConversionArena();
+  ConversionArena(const ConversionArena&) = delete;
+  ConversionArena& operator=(const ConversionArena&) = delete;
+
+  std::pmr::memory_resource* resource() { return &*arena_; }
+
+  // Invalidates everything allocated from resource() since the last reset.
+  void reset();
+
+private:
+  // Heap memory used past the end of the buffer, counted so reset() knows how
+  // far to grow.
+  class OverflowResource : public std::pmr::memory_resource {
+  public:
+    size_t bytes = 0;
+
+  private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+  };
+
+  std::unique_ptr<std::byte[]> buffer_;
+  size_t bufferSize_ = 0;
+  OverflowResource overflow_;
+  std::optional<std::pmr::monotonic_buffer_resource> arena_;
+};
+
+} // namespace nvsp_frontend
+
+#endif
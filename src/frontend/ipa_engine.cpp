@@ -4,7 +4,9 @@
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <type_traits>
+#include <utility>
 #include <sstream>
 
 namespace nvsp_frontend {
@@ -83,8 +85,8 @@ static inline bool isStressMark(char32_t c) {
   return c == U'ˈ' || c == U'ˌ';
 }
 
-static void collapseWhitespace(std::u32string& s) {
-  std::u32string out;
+static void collapseWhitespace(std::pmr::u32string& s) {
+  std::pmr::u32string out(s.get_allocator());
   out.reserve(s.size());
   bool inSpace = true; // trim leading
   for (char32_t c : s) {
@@ -103,8 +105,8 @@ static void collapseWhitespace(std::u32string& s) {
   s.swap(out);
 }
 
-static void removeDelimitedTags(std::u32string& s, char32_t open, char32_t close) {
-  std::u32string out;
+static void removeDelimitedTags(std::pmr::u32string& s, char32_t open, char32_t close) {
+  std::pmr::u32string out(s.get_allocator());
   out.reserve(s.size());
   bool skipping = false;
   for (char32_t c : s) {
@@ -123,9 +125,9 @@ static void removeDelimitedTags(std::u32string& s, char32_t open, char32_t close
   s.swap(out);
 }
 
-static void replaceAll(std::u32string& s, const std::u32string& from, const std::u32string& to) {
+static void replaceAll(std::pmr::u32string& s, std::u32string_view from, std::u32string_view to) {
   if (from.empty()) return;
-  std::u32string out;
+  std::pmr::u32string out(s.get_allocator());
   out.reserve(s.size());
 
   size_t i = 0;
@@ -144,7 +146,7 @@ static void replaceAll(std::u32string& s, const std::u32string& from, const std:
 
 static bool classContainsNext(const std::unordered_map<std::string, std::vector<std::u32string>>& classes,
                               const std::string& className,
-                              const std::u32string& text,
+                              std::u32string_view text,
                               size_t nextIndex) {
   if (className.empty()) return true;
   auto it = classes.find(className);
@@ -170,7 +172,7 @@ static bool classContainsNext(const std::unordered_map<std::string, std::vector<
 
 static bool classContainsPrev(const std::unordered_map<std::string, std::vector<std::u32string>>& classes,
                               const std::string& className,
-                              const std::u32string& text,
+                              std::u32string_view text,
                               size_t prevIndex) {
   if (className.empty()) return true;
   auto it = classes.find(className);
@@ -197,12 +199,12 @@ static bool classContainsPrev(const std::unordered_map<std::string, std::vector<
   return false;
 }
 
-static bool isWordBoundaryBefore(const std::u32string& text, size_t pos) {
+static bool isWordBoundaryBefore(std::u32string_view text, size_t pos) {
   if (pos == 0) return true;
   return text[pos - 1] == U' ';
 }
 
-static bool isWordBoundaryAfter(const std::u32string& text, size_t posAfter) {
+static bool isWordBoundaryAfter(std::u32string_view text, size_t posAfter) {
   // posAfter is index immediately after the match
   if (posAfter >= text.size()) return true;
   return text[posAfter] == U' ';
@@ -215,7 +217,7 @@ static inline bool isTieBar(char32_t c) {
 // Match a pattern at text[pos], treating IPA tie bars as optional on both sides.
 // This lets pack rules written as "a͡ɪ" match both "a͡ɪ" and "aɪ" (and similarly for affricates).
 // outConsumed is the number of codepoints consumed from *text*.
-static bool matchAtLooseTie(const std::u32string& text, size_t pos,
+static bool matchAtLooseTie(std::u32string_view text, size_t pos,
                             const std::u32string& pat,
                             size_t& outConsumed) {
   outConsumed = 0;
@@ -246,16 +248,16 @@ static bool matchAtLooseTie(const std::u32string& text, size_t pos,
   return true;
 }
 
-static std::u32string chooseReplacementTarget(const PackSet& pack, const std::vector<std::u32string>& candidates) {
+static std::u32string_view chooseReplacementTarget(const PackSet& pack, const std::vector<std::u32string>& candidates) {
   for (const auto& c : candidates) {
     if (c.empty()) return c;
     if (hasPhoneme(pack, c)) return c;
   }
   // If none exist, still return the first so the rule is deterministic.
-  return candidates.empty() ? std::u32string{} : candidates.front();
+  return candidates.empty() ? std::u32string_view{} : std::u32string_view(candidates.front());
 }
 
-static void applyRules(std::u32string& text, const PackSet& pack, const std::vector<ReplacementRule>& rules) {
+static void applyRules(std::pmr::u32string& text, const PackSet& pack, const std::vector<ReplacementRule>& rules) {
   const bool textHasTie = (text.find(U'͡') != std::u32string::npos) || (text.find(U'͜') != std::u32string::npos);
 
   for (const auto& rule : rules) {
@@ -273,7 +275,7 @@ static void applyRules(std::u32string& text, const PackSet& pack, const std::vec
       }
     } else if (patHasTie) {
       // If the pattern has a tie bar, also check the no-tie variant.
-      std::u32string noTie;
+      std::pmr::u32string noTie(text.get_allocator());
       noTie.reserve(rule.from.size());
       for (char32_t c : rule.from) {
         if (!isTieBar(c)) noTie.push_back(c);
@@ -289,9 +291,9 @@ static void applyRules(std::u32string& text, const PackSet& pack, const std::vec
       }
     }
 
-    const auto to = chooseReplacementTarget(pack, rule.to);
+    const std::u32string_view to = chooseReplacementTarget(pack, rule.to);
 
-    std::u32string out;
+    std::pmr::u32string out(text.get_allocator());
     out.reserve(text.size());
 
     size_t i = 0;
@@ -345,12 +347,12 @@ static void applyRules(std::u32string& text, const PackSet& pack, const std::vec
   }
 }
 
-static void applyAliases(std::u32string& text, const PackSet& pack) {
+static void applyAliases(std::pmr::u32string& text, const PackSet& pack) {
   // Apply longest-first so more specific tokens win.
-  std::vector<std::pair<std::u32string, std::u32string>> items;
+  std::pmr::vector<std::pair<std::u32string_view, std::u32string_view>> items(text.get_allocator());
   items.reserve(pack.lang.aliases.size());
   for (const auto& kv : pack.lang.aliases) {
-    items.push_back(kv);
+    items.emplace_back(kv.first, kv.second);
   }
   std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) {
     return a.first.size() > b.first.size();
@@ -361,8 +363,8 @@ static void applyAliases(std::u32string& text, const PackSet& pack) {
   }
 }
 
-static std::u32string normalizeIpaText(const PackSet& pack, const std::string& ipaUtf8) {
-  std::u32string t = utf8ToU32(ipaUtf8);
+static void normalizeIpaText(const PackSet& pack, std::string_view ipaUtf8, std::pmr::u32string& t) {
+  utf8ToU32(ipaUtf8, t);
 
   // Normalize tie bar variants early so pack rules can match reliably.
   replaceAll(t, U"͜", U"͡");
@@ -381,18 +383,14 @@ static std::u32string normalizeIpaText(const PackSet& pack, const std::string& i
   removeDelimitedTags(t, U'{', U'}');
 
   // Remove wrapper punctuation.
-  for (char32_t c : std::u32string(U"[](){}\\/")) {
-    std::u32string from;
-    from.push_back(c);
-    replaceAll(t, from, U"");
+  for (const char32_t& c : std::u32string_view(U"[](){}\\/")) {
+    replaceAll(t, std::u32string_view(&c, 1), U"");
   }
 
   // eSpeak utility codes.
   replaceAll(t, U"||", U" ");
-  for (char32_t c : std::u32string(U"|%=")) {
-    std::u32string from;
-    from.push_back(c);
-    replaceAll(t, from, U"");
+  for (const char32_t& c : std::u32string_view(U"|%=")) {
+    replaceAll(t, std::u32string_view(&c, 1), U"");
   }
 
   // Pause/separators.
@@ -424,9 +422,7 @@ static std::u32string normalizeIpaText(const PackSet& pack, const std::string& i
         continue;
       }
       if (d == U'2') {
-        std::u32string from;
-        from.push_back(d);
-        replaceAll(t, from, U"");
+        replaceAll(t, std::u32string_view(&d, 1), U"");
       }
     }
   }
@@ -438,10 +434,9 @@ static std::u32string normalizeIpaText(const PackSet& pack, const std::string& i
   applyRules(t, pack, pack.lang.replacements);
 
   collapseWhitespace(t);
-  return t;
 }
 
-static void correctCopyAdjacent(std::vector<Token>& tokens) {
+static void correctCopyAdjacent(std::pmr::vector<Token>& tokens) {
   const int n = static_cast<int>(tokens.size());
   for (int i = 0; i < n; ++i) {
     Token& cur = tokens[i];
@@ -476,7 +471,7 @@ static void correctCopyAdjacent(std::vector<Token>& tokens) {
   }
 }
 
-static void applyTransforms(const LanguagePack& lang, std::vector<Token>& tokens) {
+static void applyTransforms(const LanguagePack& lang, std::pmr::vector<Token>& tokens) {
   for (Token& t : tokens) {
     if (!t.def || t.silence) continue;
 
@@ -532,7 +527,7 @@ static void applyTransforms(const LanguagePack& lang, std::vector<Token>& tokens
   }
 }
 
-static void calculateTimes(std::vector<Token>& tokens, const PackSet& pack, double baseSpeed) {
+static void calculateTimes(std::pmr::vector<Token>& tokens, const PackSet& pack, double baseSpeed) {
   const LanguagePack& lang = pack.lang;
   Token* last = nullptr;
   int syllableStress = 0;
@@ -746,7 +741,7 @@ static void setPitchFields(Token& t, double startPitch, double endPitch) {
   t.setMask |= (1ull << evp);
 }
 
-static void applyPitchPath(std::vector<Token>& tokens, int startIndex, int endIndex,
+static void applyPitchPath(std::pmr::vector<Token>& tokens, int startIndex, int endIndex,
                            double basePitch, double inflection, int startPct, int endPct) {
   if (startIndex >= endIndex) return;
 
@@ -865,7 +860,7 @@ static const IntonationClause& getClauseParams(const LanguagePack& lang, char cl
 
 
 
-static void calculatePitchesLegacy(std::vector<Token>& tokens, const PackSet& pack,
+static void calculatePitchesLegacy(std::pmr::vector<Token>& tokens, const PackSet& pack,
                                   double speed, double basePitch, double inflection, char clauseType) {
   // Port of ipa-older.py calculatePhonemePitches().
   //
@@ -1009,7 +1004,7 @@ static void calculatePitchesLegacy(std::vector<Token>& tokens, const PackSet& pa
   }
 }
 
-static void calculatePitches(std::vector<Token>& tokens, const PackSet& pack, double speed, double basePitch, double inflection, char clauseType) {
+static void calculatePitches(std::pmr::vector<Token>& tokens, const PackSet& pack, double speed, double basePitch, double inflection, char clauseType) {
   if (pack.lang.legacyPitchMode) {
     calculatePitchesLegacy(tokens, pack, speed, basePitch, inflection, clauseType);
     return;
@@ -1073,7 +1068,8 @@ static void calculatePitches(std::vector<Token>& tokens, const PackSet& pack, do
     int lastHeadUnstressedRunStart = -1;
     int stressEndPitch = headEndPitch;
 
-    const std::vector<int>& steps = params.headSteps.empty() ? std::vector<int>{100,75,50,25,0} : params.headSteps;
+    static const std::vector<int> kDefaultHeadSteps{100, 75, 50, 25, 0};
+    const std::vector<int>& steps = params.headSteps.empty() ? kDefaultHeadSteps : params.headSteps;
     const int extendFrom = std::min(std::max(params.headExtendFrom, 0), static_cast<int>(steps.size()));
 
     int stepIndex = 0;
@@ -1116,13 +1112,15 @@ static void calculatePitches(std::vector<Token>& tokens, const PackSet& pack, do
   }
 }
 
-static void applyToneContours(std::vector<Token>& tokens, const PackSet& pack, double basePitch, double inflection) {
+static void applyToneContours(std::pmr::vector<Token>& tokens, const PackSet& pack, double basePitch, double inflection) {
   const LanguagePack& lang = pack.lang;
   if (!lang.tonal) return;
   if (lang.toneContours.empty()) return;
 
+  std::pmr::memory_resource* mem = tokens.get_allocator().resource();
+
   // Build syllable start indices.
-  std::vector<int> syllStarts;
+  std::pmr::vector<int> syllStarts(mem);
   for (int i = 0; i < static_cast<int>(tokens.size()); ++i) {
     if (tokens[i].syllableStart) syllStarts.push_back(i);
   }
@@ -1138,7 +1136,7 @@ static void applyToneContours(std::vector<Token>& tokens, const PackSet& pack, d
     int start = syllStarts[si];
     int end = (si + 1 < syllStarts.size()) ? syllStarts[si + 1] : static_cast<int>(tokens.size());
 
-    const std::u32string& toneKey = tokens[start].tone;
+    const std::u32string_view toneKey = tokens[start].tone;
     if (toneKey.empty()) continue;
 
     auto it = lang.toneContours.find(toneKey);
@@ -1152,7 +1150,7 @@ static void applyToneContours(std::vector<Token>& tokens, const PackSet& pack, d
     const double baselinePct = percentFromPitch(basePitch, inflection, baselinePitch);
 
     // Convert contour points to target percents.
-    std::vector<double> targetPct;
+    std::pmr::vector<double> targetPct(mem);
     targetPct.reserve(contour.size());
 
     const bool absolute = lang.toneContoursAbsolute;
@@ -1164,7 +1162,8 @@ static void applyToneContours(std::vector<Token>& tokens, const PackSet& pack, d
       targetPct.push_back(clampPct(v));
     }
 
-    // Piecewise-linear over voiced duration.
+    // Piecewise-linear over voiced duration (smoothed within each token when the
+    // contour has more than two points, see below).
     double voicedDuration = 0.0;
     for (int i = start; i < end; ++i) {
       if (tokenIsVoiced(tokens[i])) voicedDuration += tokens[i].durationMs;
@@ -1201,6 +1200,19 @@ static void applyToneContours(std::vector<Token>& tokens, const PackSet& pack, d
         double p1 = pctAt(tEnd);
         startPitch = pitchFromPercent(basePitch, inflection, p0);
         endPitch = pitchFromPercent(basePitch, inflection, p1);
+
+        // Contours with a turning point get two more points per token, so
+        // speechPlayer follows the curve inside a long vowel instead of
+        // gliding straight from start to end.
+        if (segCount > 1) {
+          const double span = tEnd - tStart;
+          const int mp1 = static_cast<int>(FieldId::midVoicePitch1);
+          const int mp2 = static_cast<int>(FieldId::midVoicePitch2);
+          t.field[mp1] = pitchFromPercent(basePitch, inflection, pctAt(tStart + span / 3.0));
+          t.field[mp2] = pitchFromPercent(basePitch, inflection, pctAt(tStart + span * 2.0 / 3.0));
+          t.setMask |= (1ull << mp1);
+          t.setMask |= (1ull << mp2);
+        }
       }
 
       setPitchFields(t, startPitch, endPitch);
@@ -1226,7 +1238,22 @@ static void setDefaultVoiceFields(const LanguagePack& lang, Token& t) {
   setIfUnset(FieldId::outputGain, lang.defaultOutputGain);
 }
 
-static bool parseToTokens(const PackSet& pack, const std::u32string& text, std::vector<Token>& outTokens, std::string& outError) {
+// Neighbouring phonemes for parsing one word of a clause on its own.
+struct WordParseContext {
+  // Last phoneme of the previous word, or null at the start of the clause.
+  const PhonemeDef* prevLast = nullptr;
+  // Stress mark still pending from the previous word.
+  int carryStress = 0;
+  // First phoneme of the next word, or null at the end of the clause.
+  const PhonemeDef* nextFirst = nullptr;
+};
+
+// With ctx, the output starts with a stand-in token for ctx->prevLast (if any)
+// and ends with the tokens produced for ctx->nextFirst, starting at
+// *outSuffixStart. outPendingStress receives the stress mark left pending at
+// the end of text.
+static bool parseToTokens(const PackSet& pack, std::u32string_view text, std::pmr::vector<Token>& outTokens, std::string& outError,
+                          const WordParseContext* ctx = nullptr, int* outPendingStress = nullptr, size_t* outSuffixStart = nullptr) {
   const LanguagePack& lang = pack.lang;
 
   bool newWord = true;
@@ -1248,7 +1275,7 @@ static bool parseToTokens(const PackSet& pack, const std::u32string& text, std::
     outTokens[syllableStartIndex].tone.push_back(toneChar);
   };
 
-  auto attachToneStringToSyllable = [&](const std::u32string& toneStr) {
+  auto attachToneStringToSyllable = [&](std::u32string_view toneStr) {
     if (!lang.tonal) return;
     if (syllableStartIndex < 0) return;
     if (syllableStartIndex >= static_cast<int>(outTokens.size())) return;
@@ -1259,92 +1286,8 @@ static bool parseToTokens(const PackSet& pack, const std::u32string& text, std::
   // Reserve a bit extra because we sometimes insert gaps/aspiration.
   outTokens.reserve(n * 2);
 
-  for (size_t i = 0; i < n; ++i) {
-    const char32_t c = text[i];
-
-    if (c == U' ') {
-      newWord = true;
-      continue;
-    }
-
-    // Primary/secondary stress.
-    if (c == U'\u02C8') { // ˈ
-      pendingStress = 1;
-      continue;
-    }
-    if (c == U'\u02CC') { // ˌ
-      pendingStress = 2;
-      continue;
-    }
-
-    // Tone markers (only when tonal is enabled).
-    if (lang.tonal) {
-      if (isToneLetter(c)) {
-        // Collect run of tone letters.
-        std::u32string run;
-        run.push_back(c);
-        while (i + 1 < n && isToneLetter(text[i + 1])) {
-          run.push_back(text[++i]);
-        }
-        attachToneStringToSyllable(run);
-        continue;
-      }
-      if (lang.toneDigitsEnabled && (c >= U'1' && c <= U'5')) {
-        attachToneToSyllable(c);
-        continue;
-      }
-    }
-
-    const bool isLengthened = (i + 1 < n && text[i + 1] == U'\u02D0'); // ː
-    const bool isTiedTo = (i + 1 < n && text[i + 1] == U'\u0361');     // ͡
-    const bool isTiedFrom = (i > 0 && text[i - 1] == U'\u0361');       // ͡
-
-    const PhonemeDef* def = nullptr;
-    bool tiedTo = false;
-    bool lengthened = false;
-
-    if (isTiedTo) {
-      // Try combined key (char + tie + next char).
-      if (i + 2 < n) {
-        std::u32string k;
-        k.push_back(text[i]);
-        k.push_back(text[i + 1]);
-        k.push_back(text[i + 2]);
-        def = findPhoneme(pack, k);
-        if (def) {
-          // consume tie + next
-          i += 2;
-          tiedTo = true;
-        } else {
-          // consume only tie (leave the next char to be parsed separately)
-          i += 1;
-          tiedTo = true;
-        }
-      } else {
-        // dangling tie bar, ignore it
-        continue;
-      }
-    } else if (isLengthened) {
-      std::u32string k;
-      k.push_back(text[i]);
-      k.push_back(text[i + 1]);
-      def = findPhoneme(pack, k);
-      if (def) {
-        i += 1;
-        lengthened = true;
-      }
-    }
-
-    if (!def) {
-      std::u32string k;
-      k.push_back(c);
-      def = findPhoneme(pack, k);
-      if (!def) {
-        // Unknown char: drop it (safe default).
-        continue;
-      }
-    }
-
+  // Append one phoneme, plus any aspiration or gap inserted before it.
+  auto appendPhoneme = [&](const PhonemeDef* def, char32_t c, bool isTiedFrom, bool tiedTo, bool lengthened) {
     Token t;
     t.def = def;
     t.setMask = def->setMask;
@@ -1355,7 +1298,7 @@ static bool parseToTokens(const PackSet& pack, const std::u32string& text, std::
     t.baseChar = c;
     t.tiedFrom = isTiedFrom;
     t.tiedTo = tiedTo;
-    t.lengthened = (lengthened || isLengthened);
+    t.lengthened = lengthened;
 
     const int stress = pendingStress;
     pendingStress = 0;
@@ -1488,6 +1431,116 @@ static bool parseToTokens(const PackSet& pack, const std::u32string& text, std::
     }
 
     lastIndex = curIndex;
+  };
+
+  if (ctx) {
+    if (ctx->prevLast) {
+      Token last;
+      last.def = ctx->prevLast;
+      last.setMask = ctx->prevLast->setMask;
+      for (int f = 0; f < kFrameFieldCount; ++f) last.field[f] = ctx->prevLast->field[f];
+      if (!ctx->prevLast->key.empty()) last.baseChar = ctx->prevLast->key[0];
+      outTokens.push_back(last);
+      lastIndex = 0;
+    }
+    pendingStress = ctx->carryStress;
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    const char32_t c = text[i];
+
+    if (c == U' ') {
+      newWord = true;
+      continue;
+    }
+
+    // Primary/secondary stress.
+    if (c == U'\u02C8') { // ˈ
+      pendingStress = 1;
+      continue;
+    }
+    if (c == U'\u02CC') { // ˌ
+      pendingStress = 2;
+      continue;
+    }
+
+    // Tone markers (only when tonal is enabled).
+    if (lang.tonal) {
+      if (isToneLetter(c)) {
+        // Collect run of tone letters.
+        const size_t runStart = i;
+        while (i + 1 < n && isToneLetter(text[i + 1])) {
+          ++i;
+        }
+        attachToneStringToSyllable(text.substr(runStart, i + 1 - runStart));
+        continue;
+      }
+      if (lang.toneDigitsEnabled && (c >= U'1' && c <= U'5')) {
+        attachToneToSyllable(c);
+        continue;
+      }
+    }
+
+    const bool isLengthened = (i + 1 < n && text[i + 1] == U'\u02D0'); // ː
+    const bool isTiedTo = (i + 1 < n && text[i + 1] == U'\u0361');     // ͡
+    const bool isTiedFrom = (i > 0 && text[i - 1] == U'\u0361');       // ͡
+
+    const PhonemeDef* def = nullptr;
+    bool tiedTo = false;
+    bool lengthened = false;
+
+    if (isTiedTo) {
+      // Try combined key (char + tie + next char).
+      if (i + 2 < n) {
+        std::u32string k;
+        k.push_back(text[i]);
+        k.push_back(text[i + 1]);
+        k.push_back(text[i + 2]);
+        def = findPhoneme(pack, k);
+        if (def) {
+          // consume tie + next
+          i += 2;
+          tiedTo = true;
+        } else {
+          // consume only tie (leave the next char to be parsed separately)
+          i += 1;
+          tiedTo = true;
+        }
+      } else {
+        // dangling tie bar, ignore it
+        continue;
+      }
+    } else if (isLengthened) {
+      std::u32string k;
+      k.push_back(text[i]);
+      k.push_back(text[i + 1]);
+      def = findPhoneme(pack, k);
+      if (def) {
+        i += 1;
+        lengthened = true;
+      }
+    }
+
+    if (!def) {
+      std::u32string k;
+      k.push_back(c);
+      def = findPhoneme(pack, k);
+      if (!def) {
+        // Unknown char: drop it (safe default).
+        continue;
+      }
+    }
+
+    appendPhoneme(def, c, isTiedFrom, tiedTo, lengthened || isLengthened);
+  }
+
+  if (outPendingStress) *outPendingStress = pendingStress;
+
+  if (ctx && ctx->nextFirst) {
+    if (outSuffixStart) *outSuffixStart = outTokens.size();
+    newWord = true;
+    pendingStress = 0;
+    appendPhoneme(ctx->nextFirst, ctx->nextFirst->key.empty() ? U'\0' : ctx->nextFirst->key[0], false, false, false);
   }
 
   (void)outError;
@@ -1553,7 +1606,7 @@ static const PhonemeDef* mapOffglideToSemivowel(const PackSet& pack, char32_t vo
   return findPhoneme(pack, k);
 }
 
-static void autoTieDiphthongs(const PackSet& pack, std::vector<Token>& tokens) {
+static void autoTieDiphthongs(const PackSet& pack, std::pmr::vector<Token>& tokens) {
   if (!pack.lang.autoTieDiphthongs) return;
 
   int prevReal = -1;
@@ -1594,7 +1647,7 @@ static void autoTieDiphthongs(const PackSet& pack, std::vector<Token>& tokens) {
 
 
 
-static bool wordLooksLikeSpelling(const std::vector<Token>& tokens, size_t start, size_t end) {
+static bool wordLooksLikeSpelling(const std::pmr::vector<Token>& tokens, size_t start, size_t end) {
   int syllables = 0;
   int stressed = 0;
 
@@ -1614,7 +1667,7 @@ static bool wordLooksLikeSpelling(const std::vector<Token>& tokens, size_t start
   return true;
 }
 
-static void applySpellingDiphthongMode(const PackSet& pack, std::vector<Token>& tokens) {
+static void applySpellingDiphthongMode(const PackSet& pack, std::pmr::vector<Token>& tokens) {
   const LanguagePack& lang = pack.lang;
   if (lang.spellingDiphthongMode != "monophthong") return;
 
@@ -1684,7 +1737,7 @@ static void applySpellingDiphthongMode(const PackSet& pack, std::vector<Token>&
                 t.tiedFrom = false;
 
                 // Erase the offglide token.
-                tokens.erase(tokens.begin() + static_cast<std::vector<Token>::difference_type>(j));
+                tokens.erase(tokens.begin() + static_cast<std::pmr::vector<Token>::difference_type>(j));
                 --wordEnd;
 
                 // Do not advance pos; re-evaluate with the new neighbor.
@@ -1702,15 +1755,196 @@ static void applySpellingDiphthongMode(const PackSet& pack, std::vector<Token>&
     i = wordEnd;
   }
 }
+// Steps 2-5 of convertIpaToTokens, after parsing.
+static void applyWordLevelPasses(const PackSet& pack, std::pmr::vector<Token>& tokens) {
+  if (tokens.empty()) return;
+
+  // Optional: auto-tie diphthongs when IPA does not include an explicit tie-bar.
+  autoTieDiphthongs(pack, tokens);
+
+  // Optional: spelling diphthong handling (e.g. acronym letter names).
+  applySpellingDiphthongMode(pack, tokens);
+
+  // Copy-adjacent correction (h, inserted aspirations, etc.).
+  correctCopyAdjacent(tokens);
+
+  // Transforms (language-specific tuning for aspiration, fricatives, etc.).
+  applyTransforms(pack.lang, tokens);
+
+  // Ensure voice defaults (vibrato, GOQ, gains) exist.
+  for (Token& t : tokens) {
+    if (!t.def || t.silence) continue;
+    setDefaultVoiceFields(pack.lang, t);
+  }
+}
+
+size_t WordTokenCache::KeyHash::operator()(const Key& k) const {
+  size_t h = std::hash<std::u32string_view>()(k.word);
+  auto mix = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2); };
+  mix(std::hash<const void*>()(k.prevLast));
+  mix(std::hash<const void*>()(k.nextFirst));
+  mix(static_cast<size_t>(k.carryStress));
+  return h;
+}
+
+void WordTokenCache::clear() {
+  lru_.clear();
+  index_.clear();
+  shapes_.clear();
+  shapeWords_.clear();
+}
+
+void WordTokenCache::setCapacity(size_t capacity) {
+  capacity_ = capacity;
+  while (lru_.size() > capacity_) {
+    index_.erase(lru_.back().key);
+    lru_.pop_back();
+  }
+  if (capacity_ == 0) {
+    shapes_.clear();
+    shapeWords_.clear();
+  }
+}
+
+const WordTokenCache::Shape* WordTokenCache::findShape(std::u32string_view word) const {
+  auto it = shapes_.find(word);
+  return (it == shapes_.end()) ? nullptr : &it->second;
+}
+
+void WordTokenCache::addShape(std::u32string_view word, const Shape& shape) {
+  // Shapes are tiny and cheap to rebuild, so just start over when full.
+  if (shapes_.size() >= capacity_) {
+    shapes_.clear();
+    shapeWords_.clear();
+  }
+  shapeWords_.emplace_back(word);
+  shapes_[shapeWords_.back()] = shape;
+}
+
+const std::vector<Token>* WordTokenCache::find(const Key& key) {
+  auto it = index_.find(key);
+  if (it == index_.end()) return nullptr;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return &it->second->tokens;
+}
+
+void WordTokenCache::insert(const Key& key, std::vector<Token> tokens) {
+  if (capacity_ == 0) return;
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->tokens = std::move(tokens);
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+  lru_.emplace_front();
+  Entry& e = lru_.front();
+  e.word.assign(key.word);
+  e.key = key;
+  e.key.word = e.word;
+  e.tokens = std::move(tokens);
+  index_.emplace(e.key, lru_.begin());
+  while (lru_.size() > capacity_) {
+    index_.erase(lru_.back().key);
+    lru_.pop_back();
+  }
+}
+
+// Parse and run the word-level passes one word at a time, reusing cached runs.
+// Each word is parsed between a stand-in for the previous word's last phoneme
+// and the next word's first phoneme, so everything those passes can see across
+// the boundary is there; the neighbours' tokens are then dropped.
+//
+// Returns false if some word can't be handled on its own (its last phoneme
+// copies from its neighbour, or it ends in a tie bar); the caller then
+// converts the clause as a whole.
+static bool buildTokensFromWordCache(const PackSet& pack, std::u32string_view text, WordTokenCache& cache,
+                                     std::pmr::vector<Token>& outTokens, std::string& outError) {
+  std::pmr::memory_resource* mem = outTokens.get_allocator().resource();
+
+  std::pmr::vector<std::u32string_view> words(mem);
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find(U' ', start);
+    if (end == std::u32string_view::npos) end = text.size();
+    if (end > start) words.push_back(text.substr(start, end - start));
+    start = end + 1;
+  }
+
+  std::pmr::vector<WordTokenCache::Shape> shapes(mem);
+  shapes.reserve(words.size());
+  std::pmr::vector<Token> scratch(mem);
+  for (std::u32string_view word : words) {
+    if (const WordTokenCache::Shape* known = cache.findShape(word)) {
+      shapes.push_back(*known);
+    } else {
+      WordTokenCache::Shape shape;
+      scratch.clear();
+      if (!parseToTokens(pack, word, scratch, outError, nullptr, &shape.trailingStress)) return false;
+      for (const Token& t : scratch) {
+        if (!t.def || t.silence) continue;
+        if (!shape.first) shape.first = t.def;
+        shape.last = t.def;
+      }
+      shape.cacheable = !(shape.last && (shape.last->flags & kCopyAdjacent)) && word.back() != U'\u0361';
+      cache.addShape(word, shape);
+      shapes.push_back(shape);
+    }
+    if (!shapes.back().cacheable) return false;
+  }
+
+  std::pmr::vector<const PhonemeDef*> nextFirst(words.size(), nullptr, mem);
+  for (size_t w = words.size(); w-- > 1;) {
+    nextFirst[w - 1] = shapes[w].first ? shapes[w].first : nextFirst[w];
+  }
+
+  const PhonemeDef* prevLast = nullptr;
+  int carryStress = 0;
+  for (size_t w = 0; w < words.size(); ++w) {
+    const WordTokenCache::Shape& shape = shapes[w];
+    if (!shape.first) {
+      // No phonemes: only a stress mark can pass through to the next word.
+      if (shape.trailingStress != 0) carryStress = shape.trailingStress;
+      continue;
+    }
+
+    const WordTokenCache::Key key{words[w], prevLast, carryStress, nextFirst[w]};
+    if (const std::vector<Token>* run = cache.find(key)) {
+      outTokens.insert(outTokens.end(), run->begin(), run->end());
+    } else {
+      WordParseContext ctx;
+      ctx.prevLast = prevLast;
+      ctx.carryStress = carryStress;
+      ctx.nextFirst = nextFirst[w];
+
+      scratch.clear();
+      size_t suffixStart = 0;
+      if (!parseToTokens(pack, words[w], scratch, outError, &ctx, nullptr, &suffixStart)) return false;
+      // The passes never remove the stand-in or the next word's tokens.
+      const size_t suffixLen = ctx.nextFirst ? (scratch.size() - suffixStart) : 0;
+      applyWordLevelPasses(pack, scratch);
+
+      const auto first = scratch.begin() + (prevLast ? 1 : 0);
+      const auto last = scratch.end() - static_cast<std::ptrdiff_t>(suffixLen);
+      outTokens.insert(outTokens.end(), first, last);
+      cache.insert(key, std::vector<Token>(first, last));
+    }
+
+    prevLast = shape.last;
+    carryStress = shape.trailingStress;
+  }
+  return true;
+}
+
 bool convertIpaToTokens(
   const PackSet& pack,
-  const std::string& ipaUtf8,
+  std::string_view ipaUtf8,
   double speed,
   double basePitch,
   double inflection,
   char clauseType,
-  std::vector<Token>& outTokens,
-  std::string& outError
+  std::pmr::vector<Token>& outTokens,
+  std::string& outError,
+  WordTokenCache* wordCache
 ) {
   outTokens.clear();
 
@@ -1727,37 +1961,25 @@ bool convertIpaToTokens(
   const double infl = inflection * inflScale;
   if (clauseType == 0) clauseType = '.';
 
-  const std::u32string normalized = normalizeIpaText(pack, ipaUtf8);
+  std::pmr::u32string normalized(outTokens.get_allocator());
+  normalizeIpaText(pack, ipaUtf8, normalized);
   if (normalized.empty()) {
     return true;
   }
 
-  if (!parseToTokens(pack, normalized, outTokens, outError)) {
-    return false;
+  const bool useCache = wordCache && wordCache->capacity() > 0 && !pack.lang.tonal;
+  if (!useCache || !buildTokensFromWordCache(pack, normalized, *wordCache, outTokens, outError)) {
+    outTokens.clear();
+    if (!parseToTokens(pack, normalized, outTokens, outError)) {
+      return false;
+    }
+    applyWordLevelPasses(pack, outTokens);
   }
 
   if (outTokens.empty()) {
     return true;
   }
 
-  // Optional: auto-tie diphthongs when IPA does not include an explicit tie-bar.
-  autoTieDiphthongs(pack, outTokens);
-
-  // Optional: spelling diphthong handling (e.g. acronym letter names).
-  applySpellingDiphthongMode(pack, outTokens);
-
-  // Copy-adjacent correction (h, inserted aspirations, etc.).
-  correctCopyAdjacent(outTokens);
-
-  // Transforms (language-specific tuning for aspiration, fricatives, etc.).
-  applyTransforms(pack.lang, outTokens);
-
-  // Ensure voice defaults (vibrato, GOQ, gains) exist.
-  for (Token& t : outTokens) {
-    if (!t.def || t.silence) continue;
-    setDefaultVoiceFields(pack.lang, t);
-  }
-
   // Timing.
   calculateTimes(outTokens, pack, speed);
 
@@ -1770,12 +1992,116 @@ bool convertIpaToTokens(
   return true;
 }
 
+// Sits between emitFrames and the callback. With coalescing off it passes
+// frames straight through; with it on, it holds back the latest frame until it
+// knows the next one cannot be merged into it.
+class FrameCoalescer {
+public:
+  FrameCoalescer(const LanguagePack& lang, int userIndex, nvspFrontend_FrameCallback cb, void* userData,
+                 nvspFrontend_FrameStats* stats, std::pmr::memory_resource* mem)
+    : enabled_(lang.frameCoalescingEnabled),
+      tolerance_(lang.frameCoalescingTolerance > 0.0 ? lang.frameCoalescingTolerance : 0.0),
+      userIndex_(userIndex), cb_(cb), userData_(userData), stats_(stats), junctions_(mem) {}
+
+  // fieldsOrNull: kFrameFieldCount doubles, or nullptr for silence.
+  void push(const double* fieldsOrNull, double durationMs, double fadeMs) {
+    if (stats_) stats_->framesGenerated++;
+    if (!enabled_) {
+      send(fieldsOrNull, durationMs, fadeMs);
+      return;
+    }
+    if (hasPending_ && canMerge(fieldsOrNull, durationMs)) {
+      if (fieldsOrNull) {
+        junctions_.push_back({pendingDurationMs_, pending_[evp_]});
+        pending_[evp_] = fieldsOrNull[evp_];
+      }
+      pendingDurationMs_ += durationMs;
+      return;
+    }
+    flush();
+    hasPending_ = true;
+    pendingSilence_ = (fieldsOrNull == nullptr);
+    if (fieldsOrNull) std::memcpy(pending_, fieldsOrNull, sizeof(pending_));
+    pendingDurationMs_ = durationMs;
+    pendingFadeMs_ = fadeMs;
+    junctions_.clear();
+  }
+
+  void flush() {
+    if (!hasPending_) return;
+    hasPending_ = false;
+    send(pendingSilence_ ? nullptr : pending_, pendingDurationMs_, pendingFadeMs_);
+  }
+
+private:
+  static constexpr int vp_ = static_cast<int>(FieldId::voicePitch);
+  static constexpr int evp_ = static_cast<int>(FieldId::endVoicePitch);
+  static constexpr int mp1_ = static_cast<int>(FieldId::midVoicePitch1);
+  static constexpr int mp2_ = static_cast<int>(FieldId::midVoicePitch2);
+
+  bool close(double a, double b) const {
+    return std::fabs(a - b) <= tolerance_ * std::max(std::fabs(a), std::fabs(b));
+  }
+
+  bool canMerge(const double* next, double nextDurationMs) const {
+    if (pendingSilence_ || !next) return pendingSilence_ && !next;
+    // Contours are fitted to one frame's length, so they can't be stretched.
+    if (pending_[mp1_] != 0.0 || pending_[mp2_] != 0.0 || next[mp1_] != 0.0 || next[mp2_] != 0.0) return false;
+    for (int f = 0; f < kFrameFieldCount; ++f) {
+      if (f == vp_ || f == evp_) continue;
+      if (!close(pending_[f], next[f])) return false;
+    }
+    if (!close(pending_[evp_], next[vp_])) return false;
+    // The merged frame glides straight from the first start pitch to the last
+    // end pitch, so every junction it passes must stay near that line.
+    const double totalMs = pendingDurationMs_ + nextDurationMs;
+    if (totalMs <= 0.0) return true;
+    const double startPitch = pending_[vp_];
+    const double slope = (next[evp_] - startPitch) / totalMs;
+    if (!close(startPitch + slope * pendingDurationMs_, pending_[evp_])) return false;
+    for (const auto& j : junctions_) {
+      if (!close(startPitch + slope * j.first, j.second)) return false;
+    }
+    return true;
+  }
+
+  void send(const double* fieldsOrNull, double durationMs, double fadeMs) {
+    if (stats_) {
+      stats_->framesEmitted++;
+      stats_->durationMs += durationMs;
+    }
+    if (!fieldsOrNull) {
+      cb_(userData_, nullptr, durationMs, fadeMs, userIndex_);
+      return;
+    }
+    nvspFrontend_Frame frame;
+    std::memcpy(&frame, fieldsOrNull, sizeof(frame));
+    cb_(userData_, &frame, durationMs, fadeMs, userIndex_);
+  }
+
+  bool enabled_;
+  double tolerance_;
+  int userIndex_;
+  nvspFrontend_FrameCallback cb_;
+  void* userData_;
+  nvspFrontend_FrameStats* stats_;
+
+  bool hasPending_ = false;
+  bool pendingSilence_ = false;
+  double pending_[kFrameFieldCount] = {};
+  double pendingDurationMs_ = 0.0;
+  double pendingFadeMs_ = 0.0;
+  // (ms from the start of the pending frame, pitch) where merged frames met.
+  std::pmr::vector<std::pair<double, double>> junctions_;
+};
+
 void emitFrames(
   const PackSet& pack,
-  const std::vector<Token>& tokens,
+  const std::pmr::vector<Token>& tokens,
   int userIndexBase,
   nvspFrontend_FrameCallback cb,
-  void* userData
+  void* userData,
+  nvspFrontend_FrameStats* stats
 ) {
   if (!cb) return;
 
@@ -1790,31 +2116,29 @@ void emitFrames(
 
   const bool trillEnabled = (pack.lang.trillModulationMs > 0.0);
 
-  const int vp = static_cast<int>(FieldId::voicePitch);
-  const int evp = static_cast<int>(FieldId::endVoicePitch);
-  const int va = static_cast<int>(FieldId::voiceAmplitude);
   const int fa = static_cast<int>(FieldId::fricationAmplitude);
+  const int tr = static_cast<int>(FieldId::trillRate);
+  const int td = static_cast<int>(FieldId::trillDepth);
+  const int tcf = static_cast<int>(FieldId::trillClosureFraction);
+  const int tff = static_cast<int>(FieldId::trillFricationFloor);
 
   // Trill modulation constants.
   //
-  // We implement the trill as an amplitude modulation on voiceAmplitude using a
-  // sequence of short frames (micro-frames). This keeps the speechPlayer.dll ABI
-  // stable (no extra fields) while avoiding pack-level hacks such as duplicating
-  // phoneme tokens.
+  // The trill is an amplitude modulation of voiceAmplitude, rendered by the
+  // trill LFO in speechPlayer.dll, so a trill is still a single frame.
   //
   // These constants were chosen to produce an audible trill without introducing
-  // clicks or an overly "tremolo" sound. Packs can tune the trill duration and
-  // micro-frame fade via settings, but not the depth (kept fixed for simplicity).
+  // clicks or an overly "tremolo" sound. Packs can tune the trill duration via
+  // settings, but not the depth (kept fixed for simplicity).
   constexpr double kTrillCloseFactor = 0.22;   // voiceAmplitude multiplier during closure
   constexpr double kTrillCloseFrac = 0.28;     // fraction of cycle spent in closure
   constexpr double kTrillFricFloor = 0.12;     // minimum fricationAmplitude during closure (if frication is present)
-  // Minimum phase duration for the trill micro-frames. Keep this small so
-  // very fast modulation settings (e.g. 2ms cycles) still behave as expected.
-  constexpr double kMinPhaseMs = 0.25;
+
+  FrameCoalescer out(pack.lang, userIndexBase, cb, userData, stats, tokens.get_allocator().resource());
 
   for (const Token& t : tokens) {
     if (t.silence || !t.def) {
-      cb(userData, nullptr, t.durationMs, t.fadeMs, userIndexBase);
+      out.push(nullptr, t.durationMs, t.fadeMs);
       continue;
     }
 
@@ -1829,8 +2153,6 @@ void emitFrames(
 
     // Optional trill modulation (only when `_isTrill` is true for the phoneme).
     if (trillEnabled && tokenIsTrill(t) && t.durationMs > 0.0) {
-      double totalDur = t.durationMs;
-
       // Trill flutter speed is hardcoded to a natural-sounding ~35Hz.
       // The pack setting (trillModulationMs) controls the *total duration* via calculateTimes().
       constexpr double kFixedTrillCycleMs = 28.0;
@@ -1838,100 +2160,19 @@ void emitFrames(
       double cycleMs = kFixedTrillCycleMs;
 
       // For short trills, compress the cycle so we still get at least one closure dip.
-      if (cycleMs > totalDur) cycleMs = totalDur;
-
-      // Split the cycle into an "open" and "closure" phase.
-      double closeMs = cycleMs * kTrillCloseFrac;
-      double openMs = cycleMs - closeMs;
-
-      // Keep both phases non-trivial (prevents zero-length frames).
-      if (openMs < kMinPhaseMs) {
-        openMs = kMinPhaseMs;
-        closeMs = std::max(kMinPhaseMs, cycleMs - openMs);
-      }
-      if (closeMs < kMinPhaseMs) {
-        closeMs = kMinPhaseMs;
-        openMs = std::max(kMinPhaseMs, cycleMs - closeMs);
-      }
-
-      // Fade between micro-frames. If not configured, choose a small default
-      // relative to the cycle.
-      double microFadeMs = pack.lang.trillModulationFadeMs;
-      if (microFadeMs <= 0.0) {
-        microFadeMs = std::min(2.0, cycleMs * 0.12);
-      }
-
-      const bool hasVoiceAmp = ((mask & (1ull << va)) != 0);
-      const bool hasFricAmp = ((mask & (1ull << fa)) != 0);
-      const double baseVoiceAmp = base[va];
-      const double baseFricAmp = base[fa];
-
-      const double startPitch = base[vp];
-      const double endPitch = base[evp];
-      const double pitchDelta = endPitch - startPitch;
-
-      double remaining = totalDur;
-      double pos = 0.0;
-      bool highPhase = true;
-      bool firstPhase = true;
-
-      while (remaining > 1e-9) {
-        double phaseDur = highPhase ? openMs : closeMs;
-        if (phaseDur > remaining) phaseDur = remaining;
-
-        // Interpolate pitch over the original token's duration so pitch remains continuous.
-        double t0 = (totalDur > 0.0) ? (pos / totalDur) : 0.0;
-        double t1 = (totalDur > 0.0) ? ((pos + phaseDur) / totalDur) : 1.0;
-
-        double seg[kFrameFieldCount];
-        std::memcpy(seg, base, sizeof(seg));
-
-        seg[vp] = startPitch + pitchDelta * t0;
-        seg[evp] = startPitch + pitchDelta * t1;
-
-        if (!highPhase) {
-          if (hasVoiceAmp) {
-            seg[va] = baseVoiceAmp * kTrillCloseFactor;
-          }
-          // Add a small noise burst on closure to make the trill more perceptible,
-          // but only if the phoneme already has a frication path.
-          if (hasFricAmp && baseFricAmp > 0.0) {
-            seg[fa] = std::max(baseFricAmp, kTrillFricFloor);
-          }
-        }
-
-        nvspFrontend_Frame frame;
-        std::memcpy(&frame, seg, sizeof(frame));
-
-        // In speechPlayer.dll, the fade duration belongs to the *incoming* frame
-        // (it's the crossfade from the previous frame to this one). Preserve the
-        // token's original fade on entry to the trill, then use microFadeMs for
-        // the internal micro-frame boundaries.
-        double fadeIn = firstPhase ? t.fadeMs : microFadeMs;
-        if (fadeIn <= 0.0) fadeIn = microFadeMs;
-
-        // Prevent fade dominating very short micro-frames.
-        if (fadeIn > phaseDur) fadeIn = phaseDur;
-
-        cb(userData, &frame, phaseDur, fadeIn, userIndexBase);
-
-        remaining -= phaseDur;
-        pos += phaseDur;
-        highPhase = !highPhase;
-        firstPhase = false;
-
-        // If the remaining duration is too small to fit another phase, let the loop
-        // handle it naturally by truncating phaseDur above.
-      }
-
-      continue;
+      if (cycleMs > t.durationMs) cycleMs = t.durationMs;
+
+      base[tr] = 1000.0 / cycleMs;
+      base[td] = 1.0 - kTrillCloseFactor;
+      base[tcf] = kTrillCloseFrac;
+      // Add a small noise burst on closure to make the trill more perceptible,
+      // but only if the phoneme already has a frication path.
+      base[tff] = ((mask & (1ull << fa)) != 0 && base[fa] > 0.0) ? kTrillFricFloor : 0.0;
     }
 
-    nvspFrontend_Frame frame;
-    std::memcpy(&frame, base, sizeof(frame));
-
-    cb(userData, &frame, t.durationMs, t.fadeMs, userIndexBase);
+    out.push(base, t.durationMs, t.fadeMs);
   }
+  out.flush();
 }
 
 } // namespace nvsp_frontend
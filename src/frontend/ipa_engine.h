@@ -1,7 +1,14 @@
 #ifndef NVSP_FRONTEND_IPA_ENGINE_H
 #define NVSP_FRONTEND_IPA_ENGINE_H
 
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "pack.h"
@@ -40,7 +47,77 @@ struct Token {
   double fadeMs = 0.0;
 
   // Tonal marker captured for this syllable start (UTF-32 string), if any.
-  std::u32string tone;
+  std::pmr::u32string tone;
+
+  // Allocator-aware, so tone lives in the same arena as the token vector.
+  using allocator_type = std::pmr::polymorphic_allocator<char32_t>;
+  Token() = default;
+  explicit Token(const allocator_type& alloc) : tone(alloc) {}
+  Token(const Token& other, const allocator_type& alloc) : tone(alloc) { *this = other; }
+  Token(Token&& other, const allocator_type& alloc) : tone(alloc) { *this = std::move(other); }
+};
+
+// Per-handle cache of pre-prosody token runs, one entry per word in context.
+//
+// Parsing, auto-tied diphthongs, spelling mode, copy-adjacent correction,
+// transforms and voice defaults only look across a word boundary at the
+// neighbouring phonemes. So a word's token run is fully determined by its
+// text, the last phoneme of the previous word, a stress mark carried over
+// from it, and the first phoneme of the next word. That is the cache key.
+//
+// The cache holds raw PhonemeDef pointers, so it must be cleared whenever the
+// pack it was filled from changes.
+class WordTokenCache {
+public:
+  // word only needs to outlive the call it is passed to.
+  struct Key {
+    std::u32string_view word;
+    const PhonemeDef* prevLast = nullptr;
+    int carryStress = 0;
+    const PhonemeDef* nextFirst = nullptr;
+
+    bool operator==(const Key& o) const {
+      return prevLast == o.prevLast && nextFirst == o.nextFirst && carryStress == o.carryStress && word == o.word;
+    }
+  };
+
+  // What a word looks like on its own: enough to build its neighbours' keys.
+  struct Shape {
+    const PhonemeDef* first = nullptr; // null if the word has no phonemes
+    const PhonemeDef* last = nullptr;
+    int trailingStress = 0; // stress mark after the last phoneme, carried into the next word
+    bool cacheable = true;
+  };
+
+  void clear();
+
+  // Most-recently-used entries are kept; 0 disables the cache.
+  void setCapacity(size_t capacity);
+  size_t capacity() const { return capacity_; }
+
+  const Shape* findShape(std::u32string_view word) const;
+  void addShape(std::u32string_view word, const Shape& shape);
+
+  // Returns null on a miss. A hit becomes the most recently used entry.
+  const std::vector<Token>* find(const Key& key);
+  void insert(const Key& key, std::vector<Token> tokens);
+
+private:
+  struct KeyHash {
+    size_t operator()(const Key& k) const;
+  };
+  // Keys point into the owned word, so lookups don't have to copy the word.
+  struct Entry {
+    std::u32string word;
+    Key key;
+    std::vector<Token> tokens;
+  };
+
+  size_t capacity_ = 0;
+  std::list<Entry> lru_;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+  std::deque<std::u32string> shapeWords_;
+  std::unordered_map<std::u32string_view, Shape> shapes_;
 };
 
 // Convert IPA -> tokens.
@@ -53,24 +130,31 @@ struct Token {
 //  6) timing + pitch
 //
 // On success, tokens are ready to be converted to nvspFrontend_Frame.
+// Temporaries are allocated from outTokens' memory resource.
+// With wordCache (and a non-zero wordTokenCacheSize), steps 2-5 are taken
+// from the cache word by word where possible; the result is the same.
 bool convertIpaToTokens(
   const PackSet& pack,
-  const std::string& ipaUtf8,
+  std::string_view ipaUtf8,
   double speed,
   double basePitch,
   double inflection,
   char clauseType,
-  std::vector<Token>& outTokens,
-  std::string& outError
+  std::pmr::vector<Token>& outTokens,
+  std::string& outError,
+  WordTokenCache* wordCache = nullptr
 );
 
 // Convert tokens -> callback frames.
+// If the pack enables frame coalescing, near-identical consecutive frames are
+// merged before they reach the callback. stats (optional) is added to.
 void emitFrames(
   const PackSet& pack,
-  const std::vector<Token>& tokens,
+  const std::pmr::vector<Token>& tokens,
   int userIndexBase,
   nvspFrontend_FrameCallback cb,
-  void* userData
+  void* userData,
+  nvspFrontend_FrameStats* stats = nullptr
 );
 
 } // namespace nvsp_frontend
@@ -1,15 +1,27 @@
 #include "nvspFrontend.h"
 
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <new>
 #include <string>
 #include <vector>
 
+#include "conversion_arena.h"
 #include "ipa_engine.h"
 #include "pack.h"
+#include "text_input.h"
+#include "text_phonemizer.h"
 
 namespace nvsp_frontend {
 
+// One live edit made through the override API.
+struct PackOverride {
+  int id = 0;
+  std::function<bool(PackSet&, std::string&)> apply;
+};
+
 struct Handle {
   std::string packDir;
   PackSet pack;
@@ -21,6 +33,21 @@ struct Handle {
   // (vowel or semivowel). Used to avoid inserting boundary pauses inside
   // vowel-to-vowel transitions (e.g. diphthongs split across chunks).
   bool lastEndsVowelLike = false;
+  // Frame counts for nvspFrontend_getFrameStats.
+  nvspFrontend_FrameStats stats = {};
+  // The pack as loaded from YAML, kept once the first override is made so
+  // overrides can be reverted. pack is basePack with the overrides applied.
+  std::unique_ptr<PackSet> basePack;
+  std::vector<PackOverride> overrides;
+  int nextOverrideId = 1;
+  // Backs each conversion's temporaries; reset at the start of every chunk.
+  ConversionArena arena;
+  // Token runs of recently spoken words. Holds pointers into pack, so it is
+  // cleared whenever pack is replaced or edited.
+  WordTokenCache wordCache;
+  // Text -> IPA stage for nvspFrontend_queueText (null until setPhonemizer).
+  std::unique_ptr<TextPhonemizer> phonemizer;
+  std::string phonemizedText;
   std::string langTag;
   std::string lastError;
   std::mutex mu;
@@ -35,57 +62,53 @@ static void setError(Handle* h, const std::string& msg) {
   h->lastError = msg;
 }
 
-} // namespace nvsp_frontend
-
-extern "C" {
-
-NVSP_FRONTEND_API nvspFrontend_handle_t nvspFrontend_create(const char* packDirUtf8) {
-  using namespace nvsp_frontend;
-  try {
-    auto* h = new Handle();
-    h->packDir = packDirUtf8 ? std::string(packDirUtf8) : std::string();
-    h->lastError.clear();
-    return reinterpret_cast<nvspFrontend_handle_t>(h);
-  } catch (...) {
-    return nullptr;
-  }
-}
-
-NVSP_FRONTEND_API void nvspFrontend_destroy(nvspFrontend_handle_t handle) {
-  using namespace nvsp_frontend;
-  Handle* h = asHandle(handle);
-  delete h;
+static void dropOverrides(Handle* h) {
+  h->basePack.reset();
+  h->overrides.clear();
 }
 
-NVSP_FRONTEND_API int nvspFrontend_setLanguage(nvspFrontend_handle_t handle, const char* langTagUtf8) {
-  using namespace nvsp_frontend;
-  Handle* h = asHandle(handle);
-  if (!h) return 0;
-
-  std::lock_guard<std::mutex> lock(h->mu);
-
+// Apply a new override to the live pack and remember it. Caller holds h->mu.
+static int addOverride(Handle* h, std::function<bool(PackSet&, std::string&)> apply) {
   h->lastError.clear();
-  const std::string lang = langTagUtf8 ? std::string(langTagUtf8) : std::string();
-
-  PackSet pack;
+  if (!h->packLoaded) {
+    setError(h, "No language loaded");
+    return 0;
+  }
+  // Keep the pack as loaded the first time it is edited.
+  if (!h->basePack) h->basePack = std::make_unique<PackSet>(h->pack);
   std::string err;
-  if (!loadPackSet(h->packDir, lang, pack, err)) {
-    setError(h, err.empty() ? "Failed to load pack set" : err);
+  h->wordCache.clear();
+  if (!apply(h->pack, err)) {
+    if (h->overrides.empty()) h->basePack.reset();
+    setError(h, err.empty() ? "Override failed" : err);
     return 0;
   }
+  PackOverride o;
+  o.id = h->nextOverrideId++;
+  o.apply = std::move(apply);
+  h->overrides.push_back(std::move(o));
+  return h->overrides.back().id;
+}
 
+// Load the default language if the caller never called setLanguage. Caller holds h->mu.
+static bool ensurePackLoaded(Handle* h) {
+  if (h->packLoaded) return true;
+  PackSet pack;
+  std::string err;
+  if (!loadPackSet(h->packDir, "default", pack, err)) {
+    setError(h, err.empty() ? "No language loaded and default load failed" : err);
+    return false;
+  }
   h->pack = std::move(pack);
   h->packLoaded = true;
-  // Treat language change as the start of a new stream, so we don't
-  // insert a segment boundary gap before the first chunk in the new language.
-  h->streamHasSpeech = false;
-  h->lastEndsVowelLike = false;
-  h->langTag = normalizeLangTag(lang);
-  return 1;
+  h->wordCache.clear();
+  h->langTag = "default";
+  return true;
 }
 
-NVSP_FRONTEND_API int nvspFrontend_queueIPA(
-  nvspFrontend_handle_t handle,
+// Convert one chunk and emit its frames. Caller holds h->mu and has loaded a pack.
+static bool queueChunk(
+  Handle* h,
   const char* ipaUtf8,
   double speed,
   double basePitch,
@@ -93,28 +116,10 @@ NVSP_FRONTEND_API int nvspFrontend_queueIPA(
   const char* clauseTypeUtf8,
   int userIndexBase,
   nvspFrontend_FrameCallback cb,
-  void* userData
+  void* userData,
+  bool* outHadSpeech = nullptr
 ) {
-  using namespace nvsp_frontend;
-  Handle* h = asHandle(handle);
-  if (!h) return 0;
-
-  std::lock_guard<std::mutex> lock(h->mu);
-  h->lastError.clear();
-
-  if (!h->packLoaded) {
-    // Default to "default" language if the caller didn't call setLanguage.
-    PackSet pack;
-    std::string err;
-    if (!loadPackSet(h->packDir, "default", pack, err)) {
-      setError(h, err.empty() ? "No language loaded and default load failed" : err);
-      return 0;
-    }
-    h->pack = std::move(pack);
-    h->packLoaded = true;
-    h->langTag = "default";
-  }
-
+  if (outHadSpeech) *outHadSpeech = false;
   if (!ipaUtf8) ipaUtf8 = "";
 
   char clauseType = '.';
@@ -122,11 +127,13 @@ NVSP_FRONTEND_API int nvspFrontend_queueIPA(
     clauseType = clauseTypeUtf8[0];
   }
 
-  std::vector<Token> tokens;
+  h->arena.reset();
+  std::pmr::vector<Token> tokens(h->arena.resource());
   std::string err;
-  if (!convertIpaToTokens(h->pack, ipaUtf8, speed, basePitch, inflection, clauseType, tokens, err)) {
+  h->wordCache.setCapacity(static_cast<size_t>(std::max(0, h->pack.lang.wordTokenCacheSize)));
+  if (!convertIpaToTokens(h->pack, ipaUtf8, speed, basePitch, inflection, clauseType, tokens, err, &h->wordCache)) {
     setError(h, err.empty() ? "IPA conversion failed" : err);
-    return 0;
+    return false;
   }
 
   // Determine whether this chunk starts/ends with a vowel-like phoneme.
@@ -180,15 +187,292 @@ NVSP_FRONTEND_API int nvspFrontend_queueIPA(
       if (!skip) {
         const double spd = (speed > 0.0) ? speed : 1.0;
         cb(userData, nullptr, gapMs / spd, fadeMs / spd, userIndexBase);
+        h->stats.framesGenerated++;
+        h->stats.framesEmitted++;
+        h->stats.durationMs += gapMs / spd;
       }
     }
   }
 
-  emitFrames(h->pack, tokens, userIndexBase, cb, userData);
+  emitFrames(h->pack, tokens, userIndexBase, cb, userData, &h->stats);
+  if (outHadSpeech) *outHadSpeech = hasRealPhoneme;
   if (hasRealPhoneme) {
     h->streamHasSpeech = true;
     h->lastEndsVowelLike = endsVowelLike;
   }
+  return true;
+}
+
+static bool toRule(const nvspFrontend_ReplacementRule* in, ReplacementRule& out, std::string& outError) {
+  if (!in || !in->fromUtf8 || !in->fromUtf8[0]) {
+    outError = "Replacement rule needs a 'from' value";
+    return false;
+  }
+  out.from = utf8ToU32(in->fromUtf8);
+  for (int i = 0; in->toUtf8 && i < in->toCount; ++i) {
+    if (in->toUtf8[i]) out.to.push_back(utf8ToU32(in->toUtf8[i]));
+  }
+  out.when.atWordStart = in->atWordStart != 0;
+  out.when.atWordEnd = in->atWordEnd != 0;
+  if (in->beforeClassUtf8) out.when.beforeClass = in->beforeClassUtf8;
+  if (in->afterClassUtf8) out.when.afterClass = in->afterClassUtf8;
+  return true;
+}
+
+} // namespace nvsp_frontend
+
+extern "C" {
+
+NVSP_FRONTEND_API nvspFrontend_handle_t nvspFrontend_create(const char* packDirUtf8) {
+  using namespace nvsp_frontend;
+  try {
+    auto* h = new Handle();
+    h->packDir = packDirUtf8 ? std::string(packDirUtf8) : std::string();
+    h->lastError.clear();
+    return reinterpret_cast<nvspFrontend_handle_t>(h);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+NVSP_FRONTEND_API void nvspFrontend_destroy(nvspFrontend_handle_t handle) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  delete h;
+}
+
+NVSP_FRONTEND_API int nvspFrontend_setLanguage(nvspFrontend_handle_t handle, const char* langTagUtf8) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+
+  std::lock_guard<std::mutex> lock(h->mu);
+
+  h->lastError.clear();
+  const std::string lang = langTagUtf8 ? std::string(langTagUtf8) : std::string();
+
+  PackSet pack;
+  std::string err;
+  if (!loadPackSet(h->packDir, lang, pack, err)) {
+    setError(h, err.empty() ? "Failed to load pack set" : err);
+    return 0;
+  }
+
+  h->pack = std::move(pack);
+  h->packLoaded = true;
+  h->wordCache.clear();
+  dropOverrides(h);
+  // Treat language change as the start of a new stream, so we don't
+  // insert a segment boundary gap before the first chunk in the new language.
+  h->streamHasSpeech = false;
+  h->lastEndsVowelLike = false;
+  h->langTag = normalizeLangTag(lang);
+  return 1;
+}
+
+NVSP_FRONTEND_API int nvspFrontend_queueIPA(
+  nvspFrontend_handle_t handle,
+  const char* ipaUtf8,
+  double speed,
+  double basePitch,
+  double inflection,
+  const char* clauseTypeUtf8,
+  int userIndexBase,
+  nvspFrontend_FrameCallback cb,
+  void* userData
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+
+  std::lock_guard<std::mutex> lock(h->mu);
+  h->lastError.clear();
+
+  if (!ensurePackLoaded(h)) return 0;
+  return queueChunk(h, ipaUtf8, speed, basePitch, inflection, clauseTypeUtf8, userIndexBase, cb, userData) ? 1 : 0;
+}
+
+NVSP_FRONTEND_API int nvspFrontend_queueIPABatch(
+  nvspFrontend_handle_t handle,
+  const nvspFrontend_IPARecord* records,
+  int recordCount,
+  double speed,
+  double basePitch,
+  double inflection,
+  nvspFrontend_FrameCallback cb,
+  void* userData
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+
+  std::lock_guard<std::mutex> lock(h->mu);
+  h->lastError.clear();
+
+  if (recordCount < 0 || (recordCount > 0 && !records)) {
+    setError(h, "Invalid record array");
+    return 0;
+  }
+  if (!ensurePackLoaded(h)) return 0;
+
+  // Keep going after a failed record, like a caller looping over queueIPA would,
+  // but report the first failure.
+  std::string firstError;
+  for (int i = 0; i < recordCount; ++i) {
+    const nvspFrontend_IPARecord& r = records[i];
+    if (queueChunk(
+          h, r.ipaUtf8,
+          (r.speed > 0.0) ? r.speed : speed,
+          (r.basePitch > 0.0) ? r.basePitch : basePitch,
+          (r.inflection >= 0.0) ? r.inflection : inflection,
+          r.clauseTypeUtf8, r.userIndexBase, cb, userData)) {
+      continue;
+    }
+    if (firstError.empty()) {
+      firstError = "Record " + std::to_string(i) + ": " + h->lastError;
+    }
+  }
+  if (!firstError.empty()) {
+    setError(h, firstError);
+    return 0;
+  }
+  return 1;
+}
+
+NVSP_FRONTEND_API int nvspFrontend_setPhonemizer(
+  nvspFrontend_handle_t handle,
+  const nvspFrontend_PhonemizerConfig* config
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+
+  std::lock_guard<std::mutex> lock(h->mu);
+  h->lastError.clear();
+
+  if (!config) {
+    h->phonemizer.reset();
+    return 1;
+  }
+
+  const std::string backend = config->backendUtf8 ? std::string(config->backendUtf8) : std::string();
+  const std::string path = config->pathUtf8 ? std::string(config->pathUtf8) : std::string();
+  std::unique_ptr<TextPhonemizer> p;
+  std::string err;
+  if (backend == "espeak") {
+    EspeakPhonemizerOptions opts;
+    opts.libraryPath = path;
+    if (config->dataPathUtf8) opts.dataPath = config->dataPathUtf8;
+    if (config->voiceUtf8) opts.voice = config->voiceUtf8;
+    opts.initialize = config->initialize != 0;
+    opts.phonemeMode = config->phonemeMode;
+    p = createEspeakPhonemizer(opts, err);
+  } else if (backend == "process") {
+    p = createProcessPhonemizer(path, config->timeoutMs > 0 ? static_cast<unsigned>(config->timeoutMs) : 0u, err);
+  } else if (backend == "stub") {
+    p = createStubPhonemizer();
+  } else {
+    err = "Unknown phonemizer backend '" + backend + "'";
+  }
+
+  if (!p) {
+    setError(h, err.empty() ? "Failed to create phonemizer" : err);
+    return 0;
+  }
+  h->phonemizer = std::move(p);
+  return 1;
+}
+
+NVSP_FRONTEND_API int nvspFrontend_phonemizeText(
+  nvspFrontend_handle_t handle,
+  const char* textUtf8,
+  const char** outIpaUtf8
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (outIpaUtf8) *outIpaUtf8 = nullptr;
+  if (!h) return 0;
+
+  std::lock_guard<std::mutex> lock(h->mu);
+  h->lastError.clear();
+
+  if (!h->phonemizer) {
+    setError(h, "No phonemizer set");
+    return 0;
+  }
+  std::string err;
+  if (!h->phonemizer->phonemize(textUtf8 ? std::string(textUtf8) : std::string(), h->phonemizedText, err)) {
+    setError(h, err.empty() ? "Phonemizer failed" : err);
+    return 0;
+  }
+  if (outIpaUtf8) *outIpaUtf8 = h->phonemizedText.c_str();
+  return 1;
+}
+
+NVSP_FRONTEND_API int nvspFrontend_queueText(
+  nvspFrontend_handle_t handle,
+  const char* textUtf8,
+  double speed,
+  double basePitch,
+  double inflection,
+  int pauseMode,
+  int userIndexBase,
+  nvspFrontend_FrameCallback cb,
+  void* userData
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+
+  std::lock_guard<std::mutex> lock(h->mu);
+  h->lastError.clear();
+
+  if (!h->phonemizer) {
+    setError(h, "No phonemizer set");
+    return 0;
+  }
+  if (!ensurePackLoaded(h)) return 0;
+
+  // Keep going after a failed clause, but report the first failure.
+  std::string firstError;
+  const std::vector<TextClause> clauses = splitTextClauses(textUtf8 ? textUtf8 : "");
+  std::string ipa;
+  for (size_t i = 0; i < clauses.size(); ++i) {
+    const TextClause& clause = clauses[i];
+    const int userIndex = userIndexBase + static_cast<int>(i);
+    std::string err;
+    if (!h->phonemizer->phonemize(clause.textUtf8, ipa, err)) {
+      if (firstError.empty()) {
+        firstError = "Clause " + std::to_string(i) + ": " + (err.empty() ? "Phonemizer failed" : err);
+      }
+      continue;
+    }
+    // Nothing speakable in this clause.
+    if (ipa.empty()) continue;
+
+    const char clauseType[2] = {clause.clauseType, '\0'};
+    bool hadSpeech = false;
+    if (!queueChunk(h, ipa.c_str(), speed, basePitch, inflection, clauseType, userIndex, cb, userData, &hadSpeech)) {
+      if (firstError.empty()) firstError = "Clause " + std::to_string(i) + ": " + h->lastError;
+      continue;
+    }
+
+    // Punctuation pause, kept within 20 ms (with a 3 ms fade) so it can't click.
+    const double pauseMs = punctuationPauseMs(clause.punctuation, pauseMode);
+    if (cb && hadSpeech && pauseMs > 0.0) {
+      const double durMs = (pauseMs < 20.0) ? pauseMs : 20.0;
+      const double fadeMs = (durMs < 3.0) ? durMs : 3.0;
+      cb(userData, nullptr, durMs, fadeMs, userIndex);
+      h->stats.framesGenerated++;
+      h->stats.framesEmitted++;
+      h->stats.durationMs += durMs;
+    }
+  }
+
+  if (!firstError.empty()) {
+    setError(h, firstError);
+    return 0;
+  }
   return 1;
 }
 
@@ -200,4 +484,199 @@ NVSP_FRONTEND_API const char* nvspFrontend_getLastError(nvspFrontend_handle_t ha
   return h->lastError.c_str();
 }
 
+NVSP_FRONTEND_API int nvspFrontend_getFrameStats(nvspFrontend_handle_t handle, nvspFrontend_FrameStats* outStats) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h || !outStats) return 0;
+  std::lock_guard<std::mutex> lock(h->mu);
+  *outStats = h->stats;
+  return 1;
+}
+
+NVSP_FRONTEND_API void nvspFrontend_resetFrameStats(nvspFrontend_handle_t handle) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return;
+  std::lock_guard<std::mutex> lock(h->mu);
+  h->stats = nvspFrontend_FrameStats{};
+}
+
+NVSP_FRONTEND_API int nvspFrontend_getSetting(
+  nvspFrontend_handle_t handle,
+  const char* keyUtf8,
+  const char** outValueUtf8,
+  const char** outSourceUtf8
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (outValueUtf8) *outValueUtf8 = nullptr;
+  if (outSourceUtf8) *outSourceUtf8 = nullptr;
+  if (!h || !keyUtf8) return 0;
+
+  std::lock_guard<std::mutex> lock(h->mu);
+  if (!h->packLoaded) return 0;
+
+  const auto& settings = h->pack.lang.rawSettings;
+  auto it = settings.find(keyUtf8);
+  if (it == settings.end()) return 0;
+  if (outValueUtf8) *outValueUtf8 = it->second.value.c_str();
+  if (outSourceUtf8) *outSourceUtf8 = it->second.source.c_str();
+  return 1;
+}
+
+NVSP_FRONTEND_API int nvspFrontend_enumerateSettings(
+  nvspFrontend_handle_t handle,
+  nvspFrontend_SettingCallback cb,
+  void* userData
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return -1;
+
+  std::lock_guard<std::mutex> lock(h->mu);
+  h->lastError.clear();
+  if (!h->packLoaded) {
+    setError(h, "No language loaded");
+    return -1;
+  }
+
+  const auto& settings = h->pack.lang.rawSettings;
+  if (cb) {
+    for (const auto& kv : settings) {
+      cb(userData, kv.first.c_str(), kv.second.value.c_str(), kv.second.source.c_str());
+    }
+  }
+  return static_cast<int>(settings.size());
+}
+
+NVSP_FRONTEND_API int nvspFrontend_overridePhonemeField(
+  nvspFrontend_handle_t handle,
+  const char* phonemeKeyUtf8,
+  const char* fieldUtf8,
+  const char* valueUtf8
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+  std::lock_guard<std::mutex> lock(h->mu);
+  if (!phonemeKeyUtf8 || !phonemeKeyUtf8[0] || !fieldUtf8) {
+    setError(h, "Phoneme key and field name are required");
+    return 0;
+  }
+
+  const std::u32string key = utf8ToU32(phonemeKeyUtf8);
+  const std::string field = fieldUtf8;
+  const bool hasValue = valueUtf8 != nullptr;
+  const std::string value = hasValue ? std::string(valueUtf8) : std::string();
+  return addOverride(h, [=](PackSet& pack, std::string& err) {
+    return setPhonemeField(pack, key, field, hasValue ? &value : nullptr, err);
+  });
+}
+
+NVSP_FRONTEND_API int nvspFrontend_overrideSetting(
+  nvspFrontend_handle_t handle,
+  const char* keyUtf8,
+  const char* valueUtf8
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+  std::lock_guard<std::mutex> lock(h->mu);
+  if (!keyUtf8 || !keyUtf8[0] || !valueUtf8) {
+    setError(h, "Setting key and value are required");
+    return 0;
+  }
+
+  const std::string key = keyUtf8;
+  const std::string value = valueUtf8;
+  return addOverride(h, [=](PackSet& pack, std::string&) {
+    applySettingValue(pack.lang, key, value, "override");
+    return true;
+  });
+}
+
+NVSP_FRONTEND_API int nvspFrontend_overrideReplacement(
+  nvspFrontend_handle_t handle,
+  int preReplacement,
+  const nvspFrontend_ReplacementRule* rule
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+  std::lock_guard<std::mutex> lock(h->mu);
+
+  ReplacementRule r;
+  std::string err;
+  if (!toRule(rule, r, err)) {
+    setError(h, err);
+    return 0;
+  }
+  if (r.to.empty()) {
+    setError(h, "Replacement rule needs at least one 'to' value");
+    return 0;
+  }
+  const bool pre = preReplacement != 0;
+  return addOverride(h, [=](PackSet& pack, std::string&) {
+    upsertReplacementRule(pre ? pack.lang.preReplacements : pack.lang.replacements, r);
+    return true;
+  });
+}
+
+NVSP_FRONTEND_API int nvspFrontend_overrideRemoveReplacement(
+  nvspFrontend_handle_t handle,
+  int preReplacement,
+  const nvspFrontend_ReplacementRule* rule
+) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+  std::lock_guard<std::mutex> lock(h->mu);
+
+  ReplacementRule r;
+  std::string err;
+  if (!toRule(rule, r, err)) {
+    setError(h, err);
+    return 0;
+  }
+  const bool pre = preReplacement != 0;
+  return addOverride(h, [=](PackSet& pack, std::string&) {
+    removeReplacementRules(pre ? pack.lang.preReplacements : pack.lang.replacements, r);
+    return true;
+  });
+}
+
+NVSP_FRONTEND_API int nvspFrontend_revertOverride(nvspFrontend_handle_t handle, int overrideId) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return 0;
+  std::lock_guard<std::mutex> lock(h->mu);
+
+  auto it = h->overrides.begin();
+  while (it != h->overrides.end() && it->id != overrideId) ++it;
+  if (it == h->overrides.end() || !h->basePack) return 0;
+  h->overrides.erase(it);
+
+  // Re-apply the remaining overrides in order, on top of the loaded pack.
+  // They all succeeded before, and are applied to the same base again.
+  PackSet pack = *h->basePack;
+  std::string err;
+  for (const PackOverride& o : h->overrides) o.apply(pack, err);
+  h->pack = std::move(pack);
+  h->wordCache.clear();
+  if (h->overrides.empty()) h->basePack.reset();
+  return 1;
+}
+
+NVSP_FRONTEND_API void nvspFrontend_revertAllOverrides(nvspFrontend_handle_t handle) {
+  using namespace nvsp_frontend;
+  Handle* h = asHandle(handle);
+  if (!h) return;
+  std::lock_guard<std::mutex> lock(h->mu);
+  if (h->basePack) {
+    h->pack = std::move(*h->basePack);
+    h->wordCache.clear();
+  }
+  dropOverrides(h);
+}
+
 } // extern "C"
@@ -31,7 +31,7 @@ extern "C" {
   #define NVSP_FRONTEND_API
 #endif
 
-#define NVSP_FRONTEND_ABI_VERSION 1
+#define NVSP_FRONTEND_ABI_VERSION 3
 
 typedef void* nvspFrontend_handle_t;
 
@@ -58,6 +58,12 @@ typedef struct nvspFrontend_Frame {
   double preFormantGain;
   double outputGain;
   double endVoicePitch;
+  double trillRate;
+  double trillDepth;
+  double trillClosureFraction;
+  double trillFricationFloor;
+  double midVoicePitch1;
+  double midVoicePitch2;
 } nvspFrontend_Frame;
 
 /*
@@ -74,6 +80,19 @@ typedef void (*nvspFrontend_FrameCallback)(
   int userIndex
 );
 
+/*
+  Running totals kept per handle, to measure how many frames reach the callback.
+  - framesGenerated: frames (including silences) before frame coalescing.
+  - framesEmitted: frames actually passed to the callback.
+  - durationMs: total duration of the emitted frames.
+  With frameCoalescingEnabled off in the language pack, the two counts are equal.
+*/
+typedef struct nvspFrontend_FrameStats {
+  unsigned long long framesGenerated;
+  unsigned long long framesEmitted;
+  double durationMs;
+} nvspFrontend_FrameStats;
+
 /* Create/destroy. packDir should contain:
    - packs/phonemes.yaml
    - packs/lang/default.yaml
@@ -121,12 +140,249 @@ NVSP_FRONTEND_API int nvspFrontend_queueIPA(
   void* userData
 );
 
+/*
+  One clause for nvspFrontend_queueIPABatch.
+  speed / basePitch <= 0 and inflection < 0 mean "use the value passed to the batch call".
+*/
+typedef struct nvspFrontend_IPARecord {
+  const char* ipaUtf8;
+  const char* clauseTypeUtf8; // NULL treated as "."
+  int userIndexBase;
+  double speed;
+  double basePitch;
+  double inflection;
+} nvspFrontend_IPARecord;
+
+/*
+  Queue several clauses in one call, e.g. all clauses of a paragraph.
+  The output is the same as calling nvspFrontend_queueIPA once per record, in order:
+  the segment boundary gap is applied between records exactly as between calls.
+  Each record's frames are passed to cb with that record's userIndexBase.
+
+  A record that fails to convert is skipped and the following records are still queued.
+  Returns 1 if every record was queued, 0 otherwise (getLastError names the first
+  failing record).
+*/
+NVSP_FRONTEND_API int nvspFrontend_queueIPABatch(
+  nvspFrontend_handle_t handle,
+  const nvspFrontend_IPARecord* records,
+  int recordCount,
+  double speed,
+  double basePitch,
+  double inflection,
+  nvspFrontend_FrameCallback cb,
+  void* userData
+);
+
+/*
+  Text input.
+
+  A handle can be given a phonemizer (text -> IPA) so callers can pass plain text
+  to nvspFrontend_queueText. Backends:
+  - "espeak": eSpeak NG, loaded at runtime from pathUtf8 (NULL = the platform's
+    default library name). Set initialize when this process has not initialized
+    that library yet; leave it 0 when the host already has (as NVDA does), in which
+    case the host's current voice is used unless voiceUtf8 is given.
+  - "process": a long-lived process started with the command line in pathUtf8. It
+    reads "<byte length>\n<text>" requests on stdin and answers "<byte length>\n<ipa>"
+    (or "!<byte length>\n<error message>") on stdout, one request at a time.
+  - "stub": a built-in letter-to-phoneme stub for tests and benchmarks.
+*/
+typedef struct nvspFrontend_PhonemizerConfig {
+  const char* backendUtf8;
+  const char* pathUtf8;
+  const char* dataPathUtf8; // espeak: directory containing espeak-ng-data (NULL = library default)
+  const char* voiceUtf8; // espeak: voice name to select (NULL = keep the current voice)
+  int initialize; // espeak: call espeak_Initialize / espeak_Terminate
+  int phonemeMode; // espeak: espeak_TextToPhonemes phonememode (0 = IPA with tie bars)
+  int timeoutMs; // process: per-request timeout (0 = 10 seconds)
+} nvspFrontend_PhonemizerConfig;
+
+/*
+  Set the handle's phonemizer. config == NULL removes it.
+  The phonemizer stays in place across setLanguage calls; selecting the matching
+  eSpeak voice is up to the caller.
+
+  Returns 1 on success, 0 on failure (the previous phonemizer is kept).
+*/
+NVSP_FRONTEND_API int nvspFrontend_setPhonemizer(
+  nvspFrontend_handle_t handle,
+  const nvspFrontend_PhonemizerConfig* config
+);
+
+/*
+  Run the handle's phonemizer on textUtf8 without generating frames.
+  *outIpaUtf8 is owned by the handle and valid until the next call on it.
+
+  Returns 1 on success, 0 on failure.
+*/
+NVSP_FRONTEND_API int nvspFrontend_phonemizeText(
+  nvspFrontend_handle_t handle,
+  const char* textUtf8,
+  const char** outIpaUtf8
+);
+
+/* Punctuation pause modes for nvspFrontend_queueText. */
+#define NVSP_FRONTEND_PAUSE_OFF 0
+#define NVSP_FRONTEND_PAUSE_SHORT 1
+#define NVSP_FRONTEND_PAUSE_LONG 2
+
+/*
+  Convert plain text into frames with the handle's phonemizer.
+
+  The text is split into clauses after . ? ! , : ; followed by whitespace, and line
+  breaks / whitespace runs become single spaces. Each clause is phonemized and queued
+  like one nvspFrontend_queueIPA call with the clause's punctuation as its clause type,
+  so segment boundary gaps apply between clauses.
+
+  After a clause that produced speech, a short silence (at most 20 ms) is added for
+  its punctuation according to pauseMode: . ! ? ... : ; get 30 ms (short) or 50 ms
+  (long), commas get 0 ms (short) or 6 ms (long).
+
+  Frames of the n-th clause (counting from 0) are passed userIndexBase + n, so callers
+  can tell where each clause starts.
+  A clause that fails is skipped and the following clauses are still queued.
+
+  Returns 1 if every clause was queued, 0 otherwise (including when no phonemizer is set).
+*/
+NVSP_FRONTEND_API int nvspFrontend_queueText(
+  nvspFrontend_handle_t handle,
+  const char* textUtf8,
+  double speed,
+  double basePitch,
+  double inflection,
+  int pauseMode,
+  int userIndexBase,
+  nvspFrontend_FrameCallback cb,
+  void* userData
+);
+
 /*
   If a function returns failure, call this to get a human-readable message.
   The returned pointer is owned by the frontend handle and remains valid until the next call.
 */
 NVSP_FRONTEND_API const char* nvspFrontend_getLastError(nvspFrontend_handle_t handle);
 
+/*
+  Copy the frame statistics accumulated since the handle was created or the
+  stats were last reset.
+
+  Returns 1 on success, 0 on failure.
+*/
+NVSP_FRONTEND_API int nvspFrontend_getFrameStats(nvspFrontend_handle_t handle, nvspFrontend_FrameStats* outStats);
+NVSP_FRONTEND_API void nvspFrontend_resetFrameStats(nvspFrontend_handle_t handle);
+
+/*
+  Callback invoked for each language-pack setting by nvspFrontend_enumerateSettings.
+  - valueUtf8: the scalar as written in the pack file (quotes removed).
+  - sourceUtf8: the pack file in the inheritance chain that supplied the value
+    ("default", "en", "en-us", ...), without the .yaml extension.
+*/
+typedef void (*nvspFrontend_SettingCallback)(
+  void* userData,
+  const char* keyUtf8,
+  const char* valueUtf8,
+  const char* sourceUtf8
+);
+
+/*
+  Look up a settings: key in the language currently loaded by setLanguage.
+  This reads the already-merged pack, so callers don't need to parse the YAML again.
+  outValueUtf8 / outSourceUtf8 may be NULL. The returned pointers are owned by the
+  frontend handle and remain valid until the next setLanguage, override* or revert*
+  call on this handle (all of these replace the merged settings). Copy them if you
+  need them longer.
+
+  Returns 1 if the key is set, 0 if it is not (or no language is loaded).
+*/
+NVSP_FRONTEND_API int nvspFrontend_getSetting(
+  nvspFrontend_handle_t handle,
+  const char* keyUtf8,
+  const char** outValueUtf8,
+  const char** outSourceUtf8
+);
+
+/*
+  Call cb once per setting of the loaded language, in key order.
+  The strings are only valid during the callback.
+
+  Returns the number of settings, or -1 on failure.
+*/
+NVSP_FRONTEND_API int nvspFrontend_enumerateSettings(
+  nvspFrontend_handle_t handle,
+  nvspFrontend_SettingCallback cb,
+  void* userData
+);
+
+/*
+  Live-edit overrides, for previewing pack edits without saving them.
+
+  Each call patches the language loaded by setLanguage in memory, the same way
+  one more language file at the end of the inheritance chain would. The change
+  applies to the next queueIPA call; no YAML is written or re-read.
+
+  Each call returns an override id (> 0), or 0 on failure (see getLastError).
+  Overrides stack in the order they were made. Reverting one re-applies the
+  others to the pack as it was loaded. setLanguage discards all overrides.
+*/
+
+/*
+  Set one phoneme field: a frame field name such as "cf1", or a flag such as
+  "_isVowel". The value is parsed like a YAML scalar. valueUtf8 == NULL removes
+  the field (or clears the flag). Unknown phonemes are created.
+*/
+NVSP_FRONTEND_API int nvspFrontend_overridePhonemeField(
+  nvspFrontend_handle_t handle,
+  const char* phonemeKeyUtf8,
+  const char* fieldUtf8,
+  const char* valueUtf8
+);
+
+/* Set one settings: key. The value is given as it would be written in YAML. */
+NVSP_FRONTEND_API int nvspFrontend_overrideSetting(
+  nvspFrontend_handle_t handle,
+  const char* keyUtf8,
+  const char* valueUtf8
+);
+
+/*
+  A normalization replacement rule, mirroring the YAML form:
+    - from: ...
+      to: [...]
+      when: { atWordStart, atWordEnd, beforeClass, afterClass }
+  Rules are matched by from + when; empty or NULL class names mean "none".
+*/
+typedef struct nvspFrontend_ReplacementRule {
+  const char* fromUtf8;
+  const char* const* toUtf8; // candidates; the first supported phoneme is used
+  int toCount;
+  int atWordStart;
+  int atWordEnd;
+  const char* beforeClassUtf8;
+  const char* afterClassUtf8;
+} nvspFrontend_ReplacementRule;
+
+/*
+  Replace the `to` list of the matching rule, or append the rule if none matches.
+  preReplacement != 0 targets normalization.preReplacements instead of replacements.
+*/
+NVSP_FRONTEND_API int nvspFrontend_overrideReplacement(
+  nvspFrontend_handle_t handle,
+  int preReplacement,
+  const nvspFrontend_ReplacementRule* rule
+);
+
+/* Remove every matching rule (the rule's `to` list is ignored). */
+NVSP_FRONTEND_API int nvspFrontend_overrideRemoveReplacement(
+  nvspFrontend_handle_t handle,
+  int preReplacement,
+  const nvspFrontend_ReplacementRule* rule
+);
+
+/* Returns 1 if the override was found and reverted, 0 otherwise. */
+NVSP_FRONTEND_API int nvspFrontend_revertOverride(nvspFrontend_handle_t handle, int overrideId);
+NVSP_FRONTEND_API void nvspFrontend_revertAllOverrides(nvspFrontend_handle_t handle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -73,6 +73,12 @@ bool parseFieldId(const std::string& name, FieldId& out) {
   if (name == "preFormantGain") { out = FieldId::preFormantGain; return true; }
   if (name == "outputGain") { out = FieldId::outputGain; return true; }
   if (name == "endVoicePitch") { out = FieldId::endVoicePitch; return true; }
+  if (name == "trillRate") { out = FieldId::trillRate; return true; }
+  if (name == "trillDepth") { out = FieldId::trillDepth; return true; }
+  if (name == "trillClosureFraction") { out = FieldId::trillClosureFraction; return true; }
+  if (name == "trillFricationFloor") { out = FieldId::trillFricationFloor; return true; }
+  if (name == "midVoicePitch1") { out = FieldId::midVoicePitch1; return true; }
+  if (name == "midVoicePitch2") { out = FieldId::midVoicePitch2; return true; }
   return false;
 }
 
@@ -243,14 +249,26 @@ static void applyLanguageDefaults(LanguagePack& lp) {
   }
 }
 
-static void mergeSettings(LanguagePack& lp, const yaml_min::Node& settings) {
+static void mergeSettings(LanguagePack& lp, const yaml_min::Node& settings, const std::string& source) {
   if (!settings.isMap()) return;
 
+  for (const auto& kv : settings.map) {
+    if (!kv.second.isScalar()) continue;
+    RawSetting& raw = lp.rawSettings[kv.first];
+    raw.value = kv.second.scalar;
+    raw.source = source;
+  }
+
   auto getNum = [&](const char* k, double& field) {
     const yaml_min::Node* n = settings.get(k);
     double v;
     if (n && n->asNumber(v)) field = v;
   };
+  auto getInt = [&](const char* k, int& field) {
+    const yaml_min::Node* n = settings.get(k);
+    double v;
+    if (n && n->asNumber(v)) field = static_cast<int>(v);
+  };
   auto getBool = [&](const char* k, bool& field) {
     const yaml_min::Node* n = settings.get(k);
     bool v;
@@ -302,6 +320,13 @@ static void mergeSettings(LanguagePack& lp, const yaml_min::Node& settings) {
   getNum("trillModulationMs", lp.trillModulationMs);
   getNum("trillModulationFadeMs", lp.trillModulationFadeMs);
 
+  // Frame coalescing (merge near-identical consecutive frames).
+  getBool("frameCoalescingEnabled", lp.frameCoalescingEnabled);
+  getNum("frameCoalescingTolerance", lp.frameCoalescingTolerance);
+
+  // Word token cache size (entries; 0 disables).
+  getInt("wordTokenCacheSize", lp.wordTokenCacheSize);
+
   // Optional: spelling diphthong handling in acronym-like (spelled-out) words.
   {
     std::string mode;
@@ -610,7 +635,7 @@ static bool mergeLanguageFile(const fs::path& path, PackSet& out, std::string& o
 
   // settings:
   if (const yaml_min::Node* s = root.get("settings")) {
-    mergeSettings(out.lang, *s);
+    mergeSettings(out.lang, *s, path.stem().string());
   }
 
   // normalization:
@@ -753,4 +778,107 @@ bool hasPhoneme(const PackSet& pack, const std::u32string& key) {
   return pack.phonemes.find(key) != pack.phonemes.end();
 }
 
+bool setPhonemeField(
+  PackSet& pack,
+  const std::u32string& key,
+  const std::string& fieldName,
+  const std::string* value,
+  std::string& outError
+) {
+  // Parse the value the same way the loader parses a YAML scalar.
+  yaml_min::Node val;
+  val.type = yaml_min::Node::Type::Scalar;
+  if (value) val.scalar = *value;
+
+  if (!fieldName.empty() && fieldName[0] == '_') {
+    const std::uint32_t bit = parseFlagKey(fieldName);
+    if (bit == 0) {
+      outError = "Unknown phoneme flag: " + fieldName;
+      return false;
+    }
+    bool b = false;
+    if (value && !val.asBool(b)) {
+      outError = "Expected true/false for " + fieldName;
+      return false;
+    }
+    auto it = pack.phonemes.find(key);
+    if (it == pack.phonemes.end()) {
+      if (!b) return true;
+      PhonemeDef def;
+      def.key = key;
+      it = pack.phonemes.emplace(key, def).first;
+    }
+    if (b) it->second.flags |= bit;
+    else it->second.flags &= ~bit;
+    return true;
+  }
+
+  FieldId id;
+  if (!parseFieldId(fieldName, id)) {
+    outError = "Unknown phoneme field: " + fieldName;
+    return false;
+  }
+  const int idx = static_cast<int>(id);
+
+  if (!value) {
+    auto it = pack.phonemes.find(key);
+    if (it != pack.phonemes.end()) {
+      it->second.field[idx] = 0.0;
+      it->second.setMask &= ~(1ull << idx);
+    }
+    return true;
+  }
+
+  double num;
+  if (!val.asNumber(num)) {
+    outError = "Expected a number for " + fieldName;
+    return false;
+  }
+  auto it = pack.phonemes.find(key);
+  if (it == pack.phonemes.end()) {
+    PhonemeDef def;
+    def.key = key;
+    it = pack.phonemes.emplace(key, def).first;
+  }
+  it->second.field[idx] = num;
+  it->second.setMask |= (1ull << idx);
+  return true;
+}
+
+void applySettingValue(LanguagePack& lp, const std::string& key, const std::string& value, const std::string& source) {
+  yaml_min::Node settings;
+  settings.type = yaml_min::Node::Type::Map;
+  yaml_min::Node& val = settings.map[key];
+  val.type = yaml_min::Node::Type::Scalar;
+  val.scalar = value;
+  mergeSettings(lp, settings, source);
+}
+
+static bool sameRuleCondition(const ReplacementRule& a, const ReplacementRule& b) {
+  return a.from == b.from &&
+    a.when.atWordStart == b.when.atWordStart &&
+    a.when.atWordEnd == b.when.atWordEnd &&
+    a.when.beforeClass == b.when.beforeClass &&
+    a.when.afterClass == b.when.afterClass;
+}
+
+void upsertReplacementRule(std::vector<ReplacementRule>& rules, const ReplacementRule& rule) {
+  for (ReplacementRule& r : rules) {
+    if (sameRuleCondition(r, rule)) {
+      r.to = rule.to;
+      return;
+    }
+  }
+  rules.push_back(rule);
+}
+
+size_t removeReplacementRules(std::vector<ReplacementRule>& rules, const ReplacementRule& rule) {
+  const size_t before = rules.size();
+  rules.erase(
+    std::remove_if(rules.begin(), rules.end(), [&](const ReplacementRule& r) { return sameRuleCondition(r, rule); }),
+    rules.end()
+  );
+  return before - rules.size();
+}
+
 } // namespace nvsp_frontend
@@ -2,6 +2,7 @@
 #define NVSP_FRONTEND_PACK_H
 
 #include <cstdint>
+#include <map>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -12,8 +13,8 @@
 
 namespace nvsp_frontend {
 
-// Field count matches nvspFrontend_Frame in nvspFrontend.h (47 doubles).
-constexpr int kFrameFieldCount = 47;
+// Field count matches nvspFrontend_Frame in nvspFrontend.h (53 doubles).
+constexpr int kFrameFieldCount = 53;
 
 // Frame field IDs by index (must match struct order).
 enum class FieldId : int {
@@ -64,6 +65,12 @@ enum class FieldId : int {
   preFormantGain = 44,
   outputGain = 45,
   endVoicePitch = 46,
+  trillRate = 47,
+  trillDepth = 48,
+  trillClosureFraction = 49,
+  trillFricationFloor = 50,
+  midVoicePitch1 = 51,
+  midVoicePitch2 = 52,
 };
 
 // Phoneme flags (based on data.py keys).
@@ -142,9 +149,20 @@ struct IntonationClause {
 };
 
 
+// A settings: value as written in a pack file, and the file in the
+// inheritance chain ("default", "en", "en-us", ...) it came from.
+struct RawSetting {
+  std::string value;
+  std::string source;
+};
+
 struct LanguagePack {
   std::string langTag; // normalized (lowercase, '-')
 
+  // Every scalar key seen in the merged settings: sections, including keys
+  // this build does not interpret. Later files in the chain override earlier ones.
+  std::map<std::string, RawSetting> rawSettings;
+
   // Settings / knobs.
   double primaryStressDiv = 1.4;
   double secondaryStressDiv = 1.1;
@@ -255,17 +273,42 @@ struct LanguagePack {
   // pack-level hacks (e.g. duplicating 'r' tokens).
   //
   // When trillModulationMs > 0, the frontend will render `_isTrill` phonemes as
-  // a series of micro-frames that apply an amplitude modulation to voiceAmplitude.
+  // a single frame with the trill fields set, and speechPlayer.dll applies the
+  // amplitude modulation to voiceAmplitude.
   //
   // - trillModulationMs: base trill duration in milliseconds (at speed=1.0).
   //   This also acts as the enable flag (> 0).
-  // - trillModulationFadeMs: fade duration (ms) between micro-frames (0 = auto).
+  // - trillModulationFadeMs: no longer used. It set the fade between the
+  //   micro-frames the frontend used to emit; the DSP now ramps each closure
+  //   over 2ms (at most 12% of the cycle). Still parsed so older packs load.
   //
   // NOTE: trillModulationMs is subject to normal speed scaling (like other durations).
   // The internal flutter cycle rate is fixed in code (see ipa_engine.cpp).
   double trillModulationMs = 0.0;
   double trillModulationFadeMs = 0.0;
 
+  // Frame coalescing (optional).
+  //
+  // Lengthened vowels, gap pairs and runs of silence often produce consecutive
+  // frames that differ only in pitch, or not at all. Each one costs the DSP a
+  // queue slot and a fade. When enabled, emitFrames merges adjacent frames
+  // whose fields all agree within frameCoalescingTolerance (relative), and
+  // whose pitch ramps line up into one straight glide within the same
+  // tolerance. Adjacent silences are always merged.
+  //
+  // Disabled by default to preserve existing behavior.
+  bool frameCoalescingEnabled = false;
+  double frameCoalescingTolerance = 0.02;
+
+  // Word token cache.
+  //
+  // Each handle remembers the tokens of recently spoken words (before timing
+  // and pitch), keyed by the word and its neighbouring phonemes, and reuses
+  // them instead of parsing and transforming the word again. The output is
+  // the same either way. This is the number of entries kept; 0 disables it.
+  // Tonal packs always bypass the cache.
+  int wordTokenCacheSize = 1024;
+
   // Intra-word vowel hiatus break (optional).
   //
   // If enabled (>0), insert a short silence between two adjacent vowels
@@ -351,7 +394,8 @@ struct LanguagePack {
   // Tonal support.
   bool tonal = false;
   // Map tone string (e.g. "1", "˥˩") -> contour points (percent values).
-  std::unordered_map<std::u32string, std::vector<int>> toneContours;
+  // std::less<> lets the engine look tones up without copying them.
+  std::map<std::u32string, std::vector<int>, std::less<>> toneContours;
   bool toneDigitsEnabled = true; // allow 1-5 as tone markers
   // If true: contour points are absolute 0..100 values (same scale as intonation).
   // If false: contour points are treated as offsets from the current syllable baseline.
@@ -376,6 +420,30 @@ bool loadPackSet(
 // Utility: does this pack contain a phoneme key?
 bool hasPhoneme(const PackSet& pack, const std::u32string& key);
 
+// Live edits used by the nvspFrontend override API. Each one changes the
+// loaded pack the same way one more language file at the end of the chain
+// would, without reading any YAML.
+
+// Set one field ("cf1", ...) or flag ("_isVowel", ...) of a phoneme, creating
+// the phoneme if needed. value == nullptr removes the field / clears the flag.
+bool setPhonemeField(
+  PackSet& pack,
+  const std::u32string& key,
+  const std::string& fieldName,
+  const std::string* value,
+  std::string& outError
+);
+
+// Apply one settings: value, as written in YAML.
+void applySettingValue(LanguagePack& lp, const std::string& key, const std::string& value, const std::string& source);
+
+// Replace the `to` list of the first rule with the same `from` and `when`,
+// or append the rule if there is none.
+void upsertReplacementRule(std::vector<ReplacementRule>& rules, const ReplacementRule& rule);
+
+// Remove every rule with the same `from` and `when`. Returns how many were removed.
+size_t removeReplacementRules(std::vector<ReplacementRule>& rules, const ReplacementRule& rule);
+
 // Map a frame field name (e.g. "cf1") to FieldId. Returns true on success.
 bool parseFieldId(const std::string& name, FieldId& out);
 
@@ -0,0 +1,391 @@
+#include "phonemizer_worker.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace nvsp_frontend {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Longest response header we accept ("!" + digits). Anything longer means the
+// process is not speaking the protocol (for example a plain CLI phonemizer).
+constexpr size_t kMaxHeaderChars = 24;
+
+// Largest response we accept, to avoid allocating garbage lengths.
+constexpr size_t kMaxResponseBytes = 16u * 1024u * 1024u;
+
+#ifdef _WIN32
+
+std::wstring utf8ToWide(const std::string& s) {
+  if (s.empty()) return std::wstring();
+  const int n = MultiByteToWideChar(CP_UTF8, 0, s.data(), static_cast<int>(s.size()), nullptr, 0);
+  std::wstring out(static_cast<size_t>(n > 0 ? n : 0), L'\0');
+  if (n > 0) MultiByteToWideChar(CP_UTF8, 0, s.data(), static_cast<int>(s.size()), &out[0], n);
+  return out;
+}
+
+#else
+
+// Serializes pipe creation and fork, so a worker never inherits the pipe
+// ends of a sibling that is being started on another thread.
+std::mutex g_spawnMu;
+
+// Blocks SIGPIPE on the calling thread for its lifetime, so writing to a
+// process that has exited fails with EPIPE instead of killing the host.
+// A SIGPIPE raised meanwhile is consumed before the old mask is restored,
+// unless one was already pending for some other reason.
+class SigpipeBlock {
+public:
+  SigpipeBlock() {
+    sigemptyset(&m_set);
+    sigaddset(&m_set, SIGPIPE);
+    sigset_t pending;
+    sigemptyset(&pending);
+    m_wasPending = sigpending(&pending) == 0 && sigismember(&pending, SIGPIPE) == 1;
+    m_blocked = pthread_sigmask(SIG_BLOCK, &m_set, &m_oldMask) == 0;
+  }
+
+  ~SigpipeBlock() {
+    if (!m_blocked) return;
+    if (m_raised && !m_wasPending) {
+      const timespec zero{0, 0};
+      while (sigtimedwait(&m_set, nullptr, &zero) < 0 && errno == EINTR) {
+      }
+    }
+    pthread_sigmask(SIG_SETMASK, &m_oldMask, nullptr);
+  }
+
+  // Record that a write failed with EPIPE, which raised SIGPIPE.
+  void raised() { m_raised = true; }
+
+private:
+  sigset_t m_set;
+  sigset_t m_oldMask;
+  bool m_blocked = false;
+  bool m_wasPending = false;
+  bool m_raised = false;
+};
+
+#endif
+
+} // namespace
+
+#ifdef _WIN32
+
+bool PhonemizerWorker::start(const std::string& commandLine, const std::string& workingDir, std::string& outError) {
+  stop();
+
+  SECURITY_ATTRIBUTES sa{};
+  sa.nLength = sizeof(sa);
+  sa.bInheritHandle = TRUE;
+
+  HANDLE hOutRead = NULL;
+  HANDLE hOutWrite = NULL;
+  if (!CreatePipe(&hOutRead, &hOutWrite, &sa, 0)) {
+    outError = "CreatePipe(stdout) failed";
+    return false;
+  }
+  SetHandleInformation(hOutRead, HANDLE_FLAG_INHERIT, 0);
+
+  HANDLE hInRead = NULL;
+  HANDLE hInWrite = NULL;
+  if (!CreatePipe(&hInRead, &hInWrite, &sa, 0)) {
+    CloseHandle(hOutRead);
+    CloseHandle(hOutWrite);
+    outError = "CreatePipe(stdin) failed";
+    return false;
+  }
+  SetHandleInformation(hInWrite, HANDLE_FLAG_INHERIT, 0);
+
+  // Stderr must not be mixed into the framed stdout stream.
+  HANDLE hNullErr = CreateFileW(L"NUL", GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+  STARTUPINFOW si{};
+  si.cb = sizeof(si);
+  si.dwFlags = STARTF_USESTDHANDLES;
+  si.hStdInput = hInRead;
+  si.hStdOutput = hOutWrite;
+  si.hStdError = (hNullErr != INVALID_HANDLE_VALUE) ? hNullErr : NULL;
+
+  PROCESS_INFORMATION pi{};
+  std::wstring cmd = utf8ToWide(commandLine);
+  std::vector<wchar_t> cmdBuf(cmd.begin(), cmd.end());
+  cmdBuf.push_back(L'\0');
+  const std::wstring cwd = utf8ToWide(workingDir);
+
+  BOOL ok = CreateProcessW(NULL, cmdBuf.data(), NULL, NULL, TRUE, CREATE_NO_WINDOW, NULL, cwd.empty() ? NULL : cwd.c_str(), &si, &pi);
+
+  CloseHandle(hOutWrite);
+  CloseHandle(hInRead);
+  if (hNullErr != INVALID_HANDLE_VALUE) CloseHandle(hNullErr);
+
+  if (!ok) {
+    DWORD e = GetLastError();
+    CloseHandle(hOutRead);
+    CloseHandle(hInWrite);
+    std::ostringstream oss;
+    oss << "CreateProcess failed (" << static_cast<unsigned long>(e) << ")";
+    outError = oss.str();
+    return false;
+  }
+
+  CloseHandle(pi.hThread);
+  m_process = pi.hProcess;
+  m_stdinWrite = hInWrite;
+  m_stdoutRead = hOutRead;
+  m_pending.clear();
+  return true;
+}
+
+void PhonemizerWorker::stop() {
+  if (m_stdinWrite) {
+    // EOF on stdin asks a well-behaved worker to exit.
+    CloseHandle(m_stdinWrite);
+    m_stdinWrite = nullptr;
+  }
+  if (m_process) {
+    if (WaitForSingleObject(m_process, 200) != WAIT_OBJECT_0) {
+      TerminateProcess(m_process, 1);
+      WaitForSingleObject(m_process, INFINITE);
+    }
+    CloseHandle(m_process);
+    m_process = nullptr;
+  }
+  if (m_stdoutRead) {
+    CloseHandle(m_stdoutRead);
+    m_stdoutRead = nullptr;
+  }
+  m_pending.clear();
+}
+
+bool PhonemizerWorker::writeAll(const char* p, size_t n) {
+  while (n > 0) {
+    DWORD wrote = 0;
+    DWORD toWrite = (n > 65535u) ? 65535u : static_cast<DWORD>(n);
+    if (!WriteFile(m_stdinWrite, p, toWrite, &wrote, NULL) || wrote == 0) return false;
+    p += wrote;
+    n -= wrote;
+  }
+  return true;
+}
+
+long PhonemizerWorker::readSome(char* p, size_t n, Clock::time_point deadline) {
+  // Anonymous pipes don't support overlapped reads, so poll for data.
+  while (true) {
+    DWORD avail = 0;
+    if (!PeekNamedPipe(m_stdoutRead, NULL, 0, NULL, &avail, NULL)) return -1;
+    if (avail > 0) {
+      DWORD toRead = (avail < n) ? avail : static_cast<DWORD>(n);
+      DWORD read = 0;
+      if (!ReadFile(m_stdoutRead, p, toRead, &read, NULL) || read == 0) return -1;
+      return static_cast<long>(read);
+    }
+    if (Clock::now() >= deadline) return 0;
+    Sleep(1);
+  }
+}
+
+#else
+
+bool PhonemizerWorker::start(const std::string& commandLine, const std::string& workingDir, std::string& outError) {
+  stop();
+
+  const std::string cmd = "exec " + commandLine;
+
+  std::lock_guard<std::mutex> lock(g_spawnMu);
+
+  int inPipe[2];
+  int outPipe[2];
+  if (pipe(inPipe) != 0) {
+    outError = "pipe(stdin) failed";
+    return false;
+  }
+  if (pipe(outPipe) != 0) {
+    close(inPipe[0]);
+    close(inPipe[1]);
+    outError = "pipe(stdout) failed";
+    return false;
+  }
+  fcntl(inPipe[1], F_SETFD, FD_CLOEXEC);
+  fcntl(outPipe[0], F_SETFD, FD_CLOEXEC);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    dup2(inPipe[0], STDIN_FILENO);
+    dup2(outPipe[1], STDOUT_FILENO);
+    close(inPipe[0]);
+    close(outPipe[1]);
+    if (!workingDir.empty() && chdir(workingDir.c_str()) != 0) _exit(127);
+    execl("/bin/sh", "sh", "-c", cmd.c_str(), static_cast<char*>(nullptr));
+    _exit(127);
+  }
+
+  close(inPipe[0]);
+  close(outPipe[1]);
+
+  if (pid < 0) {
+    close(inPipe[1]);
+    close(outPipe[0]);
+    std::ostringstream oss;
+    oss << "fork failed (" << errno << ")";
+    outError = oss.str();
+    return false;
+  }
+
+  m_pid = pid;
+  m_stdinWrite = inPipe[1];
+  m_stdoutRead = outPipe[0];
+  m_pending.clear();
+  return true;
+}
+
+void PhonemizerWorker::stop() {
+  if (m_stdinWrite >= 0) {
+    // EOF on stdin asks a well-behaved worker to exit.
+    close(m_stdinWrite);
+    m_stdinWrite = -1;
+  }
+  if (m_pid > 0) {
+    bool exited = false;
+    for (int i = 0; i < 200 && !exited; ++i) {
+      if (waitpid(m_pid, nullptr, WNOHANG) == m_pid) exited = true;
+      else std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (!exited) {
+      kill(m_pid, SIGKILL);
+      waitpid(m_pid, nullptr, 0);
+    }
+    m_pid = -1;
+  }
+  if (m_stdoutRead >= 0) {
+    close(m_stdoutRead);
+    m_stdoutRead = -1;
+  }
+  m_pending.clear();
+}
+
+bool PhonemizerWorker::writeAll(const char* p, size_t n) {
+  SigpipeBlock sigpipeBlock;
+  while (n > 0) {
+    ssize_t wrote = write(m_stdinWrite, p, n);
+    if (wrote < 0 && errno == EINTR) continue;
+    if (wrote < 0 && errno == EPIPE) sigpipeBlock.raised();
+    if (wrote <= 0) return false;
+    p += wrote;
+    n -= static_cast<size_t>(wrote);
+  }
+  return true;
+}
+
+long PhonemizerWorker::readSome(char* p, size_t n, Clock::time_point deadline) {
+  while (true) {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+    if (left < 0) left = 0;
+    pollfd pfd{};
+    pfd.fd = m_stdoutRead;
+    pfd.events = POLLIN;
+    int r = poll(&pfd, 1, static_cast<int>(left));
+    if (r < 0 && errno == EINTR) continue;
+    if (r < 0) return -1;
+    if (r == 0) return 0;
+    ssize_t got = read(m_stdoutRead, p, n);
+    if (got < 0 && errno == EINTR) continue;
+    if (got <= 0) return -1;
+    return static_cast<long>(got);
+  }
+}
+
+#endif
+
+bool PhonemizerWorker::fill(Clock::time_point deadline, std::string& outError) {
+  char tmp[4096];
+  long got = readSome(tmp, sizeof(tmp), deadline);
+  if (got == 0) {
+    outError = "Phonemizer worker timed out";
+    return false;
+  }
+  if (got < 0) {
+    outError = "Phonemizer worker exited";
+    return false;
+  }
+  m_pending.append(tmp, tmp + got);
+  return true;
+}
+
+bool PhonemizerWorker::request(
+  const std::string& textUtf8,
+  unsigned timeoutMs,
+  std::string& outIpaUtf8,
+  std::string& outError,
+  bool& outProtocolOk
+) {
+  outIpaUtf8.clear();
+  outProtocolOk = false;
+
+  std::string message = std::to_string(textUtf8.size()) + "\n";
+  message += textUtf8;
+  if (!writeAll(message.data(), message.size())) {
+    outError = "Failed to write to the phonemizer worker";
+    return false;
+  }
+
+  const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+
+  size_t nl;
+  while ((nl = m_pending.find('\n')) == std::string::npos) {
+    if (m_pending.size() > kMaxHeaderChars) {
+      outError = "Phonemizer worker sent an invalid response header";
+      return false;
+    }
+    if (!fill(deadline, outError)) return false;
+  }
+  std::string line = m_pending.substr(0, nl);
+  m_pending.erase(0, nl + 1);
+  if (!line.empty() && line.back() == '\r') line.pop_back();
+
+  const bool isError = !line.empty() && line[0] == '!';
+  const std::string digits = isError ? line.substr(1) : line;
+  if (digits.empty() || digits.size() > kMaxHeaderChars || digits.find_first_not_of("0123456789") != std::string::npos) {
+    outError = "Phonemizer worker sent an invalid response header";
+    return false;
+  }
+  const unsigned long long len = std::strtoull(digits.c_str(), nullptr, 10);
+  if (len > kMaxResponseBytes) {
+    outError = "Phonemizer worker response is too large";
+    return false;
+  }
+
+  while (m_pending.size() < len) {
+    if (!fill(deadline, outError)) return false;
+  }
+  std::string body = m_pending.substr(0, static_cast<size_t>(len));
+  m_pending.erase(0, static_cast<size_t>(len));
+
+  outProtocolOk = true;
+  if (isError) {
+    outError = body.empty() ? "Phonemizer worker reported an error" : body;
+    return false;
+  }
+  outIpaUtf8 = std::move(body);
+  return true;
+}
+
+} // namespace nvsp_frontend
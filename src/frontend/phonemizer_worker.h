@@ -0,0 +1,82 @@
+#ifndef NVSP_FRONTEND_PHONEMIZER_WORKER_H
+#define NVSP_FRONTEND_PHONEMIZER_WORKER_H
+
+#include <chrono>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+namespace nvsp_frontend {
+
+// One long-lived phonemizer process and its pipes. It reads requests from
+// stdin and answers on stdout, one at a time (both UTF-8):
+//   request:  "<byte length>\n" followed by exactly that many bytes of text
+//   response: "<byte length>\n" followed by exactly that many bytes of IPA
+//             "!<byte length>\n" followed by an error message
+//
+// Used by the "process" text phonemizer and by the phoneme editor's
+// PhonemizerPool. A worker serves one request at a time; callers that share
+// one must serialize.
+class PhonemizerWorker {
+public:
+  PhonemizerWorker() = default;
+  ~PhonemizerWorker() { stop(); }
+
+  PhonemizerWorker(const PhonemizerWorker&) = delete;
+  PhonemizerWorker& operator=(const PhonemizerWorker&) = delete;
+
+  bool running() const {
+#ifdef _WIN32
+    return m_process != nullptr;
+#else
+    return m_pid > 0;
+#endif
+  }
+
+  // Start commandLine (UTF-8), replacing any running process. On Windows it is
+  // passed to CreateProcess with stderr discarded; elsewhere it is run through
+  // /bin/sh so quoting in it is honoured, and stderr is inherited.
+  // An empty workingDir keeps the caller's working directory.
+  bool start(const std::string& commandLine, const std::string& workingDir, std::string& outError);
+
+  // Close stdin, which asks the process to exit, and kill it if it does not.
+  void stop();
+
+  // Send one request and wait up to timeoutMs for its response.
+  // Returns false if the request failed; outProtocolOk tells whether the worker
+  // answered with an error and is still usable, or must be restarted.
+  bool request(
+    const std::string& textUtf8,
+    unsigned timeoutMs,
+    std::string& outIpaUtf8,
+    std::string& outError,
+    bool& outProtocolOk
+  );
+
+private:
+  bool writeAll(const char* p, size_t n);
+  // Read up to n bytes. Returns the byte count, 0 on timeout, -1 on EOF/error.
+  long readSome(char* p, size_t n, std::chrono::steady_clock::time_point deadline);
+  // Append more output to m_pending.
+  bool fill(std::chrono::steady_clock::time_point deadline, std::string& outError);
+
+  // Bytes read from stdout but not consumed yet.
+  std::string m_pending;
+
+#ifdef _WIN32
+  // HANDLEs, kept as void* so this header does not pull in windows.h.
+  void* m_process = nullptr;
+  void* m_stdinWrite = nullptr;
+  void* m_stdoutRead = nullptr;
+#else
+  pid_t m_pid = -1;
+  int m_stdinWrite = -1;
+  int m_stdoutRead = -1;
+#endif
+};
+
+} // namespace nvsp_frontend
+
+#endif
@@ -0,0 +1,159 @@
+// Checks that converting a clause on a warmed-up handle does not touch the
+// heap: global operator new is replaced with a counting version, and after a
+// few warm-up passes every clause must convert with zero allocations. Runs for
+// en-us and for a tonal pack (zh), with the word token cache on and off.
+//
+// Usage: alloc_test PACK_DIR
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "nvspFrontend.h"
+
+namespace {
+
+std::atomic<long> g_allocations{0};
+
+void* countedAlloc(std::size_t size) {
+  ++g_allocations;
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+// Aligned allocations (used by std::pmr::new_delete_resource, among others)
+// keep the malloc'd block just before the pointer they hand out.
+void* countedAlignedAlloc(std::size_t size, std::align_val_t align) {
+  ++g_allocations;
+  const std::size_t a = std::max(static_cast<std::size_t>(align), alignof(void*));
+  void* raw = std::malloc(size + a + sizeof(void*));
+  if (!raw) throw std::bad_alloc();
+  const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+  void** p = reinterpret_cast<void**>((base + a - 1) & ~(static_cast<std::uintptr_t>(a) - 1));
+  p[-1] = raw;
+  return p;
+}
+
+void alignedFree(void* p) {
+  if (p) std::free(static_cast<void**>(p)[-1]);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  ++g_allocations;
+  return std::malloc(size ? size : 1);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  ++g_allocations;
+  return std::malloc(size ? size : 1);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void* operator new(std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+
+namespace {
+
+struct Case {
+  const char* lang;
+  const char* clauses[3];
+};
+
+const Case kCases[] = {
+  {"en-us", {
+    "ðɪs ɪz ə tˈɛst ɒv ɹˈiːdɪŋ",
+    "ðə kwˈɪk bɹˈaʊn fˈɒks d͡ʒˈʌmps ˌəʊvə ðə lˈeɪzi dˈɒɡ",
+    "hˈaʊ ˈɑː juː",
+  }},
+  {"zh", {
+    "ni3 xau3",
+    "ʂʅ4 tɕje4 ma5",
+    "tʂʊŋ1 kwo2 ɻən2",
+  }},
+};
+
+const char kClauseTypes[] = {'.', '?', ','};
+
+long g_frames = 0;
+
+void countFrame(void*, const nvspFrontend_Frame*, double, double, int) {
+  ++g_frames;
+}
+
+bool convert(nvspFrontend_handle_t h, const Case& c, int i) {
+  const char clauseType[2] = {kClauseTypes[i], 0};
+  return nvspFrontend_queueIPA(h, c.clauses[i], 1.0, 100.0, 0.5, clauseType, i, countFrame, nullptr) != 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s PACK_DIR\n", argv[0]);
+    return 2;
+  }
+
+  int failures = 0;
+  for (const Case& c : kCases) {
+    for (const bool cacheOn : {true, false}) {
+      const std::string label = std::string(c.lang) + (cacheOn ? " (cache on)" : " (cache off)");
+      nvspFrontend_handle_t h = nvspFrontend_create(argv[1]);
+      if (!h || !nvspFrontend_setLanguage(h, c.lang) ||
+          (!cacheOn && !nvspFrontend_overrideSetting(h, "wordTokenCacheSize", "0"))) {
+        std::fprintf(stderr, "FAIL %s: could not set up the handle: %s\n",
+          label.c_str(), h ? nvspFrontend_getLastError(h) : "create failed");
+        ++failures;
+        if (h) nvspFrontend_destroy(h);
+        continue;
+      }
+
+      // Warm up: grows the conversion arena, fills the word cache and lets
+      // the callback side reach its steady state.
+      bool ok = true;
+      for (int pass = 0; pass < 5 && ok; ++pass) {
+        for (int i = 0; i < 3 && ok; ++i) ok = convert(h, c, i);
+      }
+      if (!ok) {
+        std::fprintf(stderr, "FAIL %s: conversion failed: %s\n", label.c_str(), nvspFrontend_getLastError(h));
+        ++failures;
+        nvspFrontend_destroy(h);
+        continue;
+      }
+
+      for (int i = 0; i < 3; ++i) {
+        const long framesBefore = g_frames;
+        const long before = g_allocations.load();
+        const bool converted = convert(h, c, i);
+        const long allocations = g_allocations.load() - before;
+        if (!converted || g_frames == framesBefore) {
+          std::fprintf(stderr, "FAIL %s: \"%s\" produced no frames\n", label.c_str(), c.clauses[i]);
+          ++failures;
+        } else if (allocations != 0) {
+          std::fprintf(stderr, "FAIL %s: \"%s\" made %ld heap allocation(s)\n", label.c_str(), c.clauses[i], allocations);
+          ++failures;
+        }
+      }
+      nvspFrontend_destroy(h);
+    }
+  }
+
+  if (failures) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("conversion allocations: all clauses converted without touching the heap\n");
+  return 0;
+}
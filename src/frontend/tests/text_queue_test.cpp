@@ -0,0 +1,202 @@
+// Checks nvspFrontend_queueText with the stub phonemizer: the text must be
+// split into the expected clauses, and for every pause mode the frames must
+// match queueing each clause's IPA with nvspFrontend_queueIPA under the
+// expected clause type and userIndex, followed by the expected punctuation
+// pause. A run that passes every clause as '.' must not match, so the clause
+// type is known to reach the frames.
+//
+// Usage: text_queue_test PACK_DIR
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "nvspFrontend.h"
+#include "text_input.h"
+
+namespace {
+
+struct Emitted {
+  bool silence;
+  nvspFrontend_Frame frame;
+  double durationMs;
+  double fadeMs;
+  int userIndex;
+};
+
+void collect(void* userData, const nvspFrontend_Frame* frameOrNull, double durationMs, double fadeMs, int userIndex) {
+  Emitted e{};
+  e.silence = (frameOrNull == nullptr);
+  if (frameOrNull) e.frame = *frameOrNull;
+  e.durationMs = durationMs;
+  e.fadeMs = fadeMs;
+  e.userIndex = userIndex;
+  static_cast<std::vector<Emitted>*>(userData)->push_back(e);
+}
+
+bool sameOutput(const std::vector<Emitted>& a, const std::vector<Emitted>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].silence != b[i].silence || a[i].userIndex != b[i].userIndex) return false;
+    if (std::memcmp(&a[i].durationMs, &b[i].durationMs, sizeof(double)) != 0) return false;
+    if (std::memcmp(&a[i].fadeMs, &b[i].fadeMs, sizeof(double)) != 0) return false;
+    if (!a[i].silence && std::memcmp(&a[i].frame, &b[i].frame, sizeof(nvspFrontend_Frame)) != 0) return false;
+  }
+  return true;
+}
+
+const char kText[] = "Hello there, how are you?\r\nI am  fine. Wait... Stop! One: two; three";
+
+struct ExpectedClause {
+  const char* text;
+  char clauseType;
+  const char* punctuation;
+  // Pause for PAUSE_OFF, PAUSE_SHORT and PAUSE_LONG, after the 20 ms cap.
+  double pauseMs[3];
+};
+
+const ExpectedClause kClauses[] = {
+  {"Hello there,", ',', ",", {0.0, 0.0, 6.0}},
+  {"how are you?", '?', "?", {0.0, 20.0, 20.0}},
+  {"I am fine.", '.', ".", {0.0, 20.0, 20.0}},
+  {"Wait...", '.', "...", {0.0, 20.0, 20.0}},
+  {"Stop!", '!', "!", {0.0, 20.0, 20.0}},
+  {"One:", ':', ":", {0.0, 20.0, 20.0}},
+  {"two;", ';', ";", {0.0, 20.0, 20.0}},
+  {"three", '.', "", {0.0, 0.0, 0.0}},
+};
+const int kClauseCount = static_cast<int>(sizeof(kClauses) / sizeof(kClauses[0]));
+
+const int kUserIndexBase = 40;
+const double kSpeed = 1.0;
+const double kPitch = 110.0;
+const double kInflection = 0.6;
+
+nvspFrontend_handle_t createHandle(const std::string& packDir) {
+  nvspFrontend_handle_t h = nvspFrontend_create(packDir.c_str());
+  if (!h) return nullptr;
+  nvspFrontend_PhonemizerConfig config{};
+  config.backendUtf8 = "stub";
+  if (!nvspFrontend_setLanguage(h, "en-us") || !nvspFrontend_setPhonemizer(h, &config)) {
+    std::fprintf(stderr, "could not set up a handle: %s\n", nvspFrontend_getLastError(h));
+    nvspFrontend_destroy(h);
+    return nullptr;
+  }
+  return h;
+}
+
+// What queueText should produce: each clause through queueIPA, then its pause.
+bool renderExpected(nvspFrontend_handle_t h, int pauseMode, bool forceFullStop, std::vector<Emitted>& out) {
+  out.clear();
+  for (int i = 0; i < kClauseCount; ++i) {
+    const ExpectedClause& clause = kClauses[i];
+    const char* ipa = nullptr;
+    if (!nvspFrontend_phonemizeText(h, clause.text, &ipa)) {
+      std::fprintf(stderr, "phonemizeText failed for \"%s\": %s\n", clause.text, nvspFrontend_getLastError(h));
+      return false;
+    }
+    const char clauseType[2] = {forceFullStop ? '.' : clause.clauseType, 0};
+    const int userIndex = kUserIndexBase + i;
+    if (!nvspFrontend_queueIPA(h, ipa, kSpeed, kPitch, kInflection, clauseType, userIndex, collect, &out)) {
+      std::fprintf(stderr, "queueIPA failed for \"%s\": %s\n", clause.text, nvspFrontend_getLastError(h));
+      return false;
+    }
+    const double pauseMs = clause.pauseMs[pauseMode];
+    if (pauseMs > 0.0) collect(&out, nullptr, pauseMs, 3.0, userIndex);
+  }
+  return true;
+}
+
+int checkSplit() {
+  const std::vector<nvsp_frontend::TextClause> clauses = nvsp_frontend::splitTextClauses(kText);
+  if (static_cast<int>(clauses.size()) != kClauseCount) {
+    std::fprintf(stderr, "FAIL split: %zu clauses, expected %d\n", clauses.size(), kClauseCount);
+    return 1;
+  }
+  int failures = 0;
+  for (int i = 0; i < kClauseCount; ++i) {
+    const ExpectedClause& want = kClauses[i];
+    const nvsp_frontend::TextClause& got = clauses[i];
+    if (got.textUtf8 != want.text || got.clauseType != want.clauseType || got.punctuation != want.punctuation) {
+      std::fprintf(stderr, "FAIL split: clause %d is \"%s\" '%c' \"%s\", expected \"%s\" '%c' \"%s\"\n",
+        i, got.textUtf8.c_str(), got.clauseType, got.punctuation.c_str(),
+        want.text, want.clauseType, want.punctuation);
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+int checkQueue(const std::string& packDir, int pauseMode) {
+  // Fresh handles, so the segment boundary state starts out the same.
+  nvspFrontend_handle_t textHandle = createHandle(packDir);
+  nvspFrontend_handle_t ipaHandle = createHandle(packDir);
+  nvspFrontend_handle_t fullStopHandle = createHandle(packDir);
+  int failures = 0;
+  std::vector<Emitted> got;
+  std::vector<Emitted> expected;
+  std::vector<Emitted> fullStop;
+  if (!textHandle || !ipaHandle || !fullStopHandle) {
+    ++failures;
+  } else if (!nvspFrontend_queueText(textHandle, kText, kSpeed, kPitch, kInflection, pauseMode,
+               kUserIndexBase, collect, &got)) {
+    std::fprintf(stderr, "FAIL pause mode %d: queueText failed: %s\n", pauseMode, nvspFrontend_getLastError(textHandle));
+    ++failures;
+  } else if (!renderExpected(ipaHandle, pauseMode, false, expected) ||
+             !renderExpected(fullStopHandle, pauseMode, true, fullStop)) {
+    ++failures;
+  } else {
+    // Every clause has letters, so each one must show up under its own userIndex.
+    std::vector<int> framesPerClause(kClauseCount, 0);
+    for (const Emitted& e : got) {
+      const int clause = e.userIndex - kUserIndexBase;
+      if (clause < 0 || clause >= kClauseCount) {
+        std::fprintf(stderr, "FAIL pause mode %d: frame with userIndex %d\n", pauseMode, e.userIndex);
+        ++failures;
+        break;
+      }
+      if (!e.silence) ++framesPerClause[clause];
+    }
+    for (int i = 0; i < kClauseCount; ++i) {
+      if (!framesPerClause[i]) {
+        std::fprintf(stderr, "FAIL pause mode %d: no frames for clause %d\n", pauseMode, i);
+        ++failures;
+      }
+    }
+    if (!sameOutput(got, expected)) {
+      std::fprintf(stderr, "FAIL pause mode %d: queueText (%zu frames) differs from queueIPA per clause (%zu frames)\n",
+        pauseMode, got.size(), expected.size());
+      ++failures;
+    }
+    if (sameOutput(got, fullStop)) {
+      std::fprintf(stderr, "FAIL pause mode %d: output does not depend on the clause types\n", pauseMode);
+      ++failures;
+    }
+  }
+  if (textHandle) nvspFrontend_destroy(textHandle);
+  if (ipaHandle) nvspFrontend_destroy(ipaHandle);
+  if (fullStopHandle) nvspFrontend_destroy(fullStopHandle);
+  return failures;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s PACK_DIR\n", argv[0]);
+    return 2;
+  }
+  const std::string packDir = argv[1];
+
+  int failures = checkSplit();
+  const int pauseModes[] = {NVSP_FRONTEND_PAUSE_OFF, NVSP_FRONTEND_PAUSE_SHORT, NVSP_FRONTEND_PAUSE_LONG};
+  for (int pauseMode : pauseModes) failures += checkQueue(packDir, pauseMode);
+
+  if (failures) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("queueText: %d clauses match in every pause mode\n", kClauseCount);
+  return 0;
+}
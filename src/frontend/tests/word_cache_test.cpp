@@ -0,0 +1,160 @@
+// Checks that the word token cache does not change the output: every language
+// pack that loads converts the same clauses on two handles, one with the
+// default wordTokenCacheSize and one with the cache turned off, and the frames
+// must match exactly.
+//
+// Usage: word_cache_test PACK_DIR
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "nvspFrontend.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Emitted {
+  bool silence;
+  nvspFrontend_Frame frame;
+  double durationMs;
+  double fadeMs;
+  int userIndex;
+};
+
+void collect(void* userData, const nvspFrontend_Frame* frameOrNull, double durationMs, double fadeMs, int userIndex) {
+  Emitted e{};
+  e.silence = (frameOrNull == nullptr);
+  if (frameOrNull) e.frame = *frameOrNull;
+  e.durationMs = durationMs;
+  e.fadeMs = fadeMs;
+  e.userIndex = userIndex;
+  static_cast<std::vector<Emitted>*>(userData)->push_back(e);
+}
+
+bool sameOutput(const std::vector<Emitted>& a, const std::vector<Emitted>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].silence != b[i].silence || a[i].userIndex != b[i].userIndex) return false;
+    if (std::memcmp(&a[i].durationMs, &b[i].durationMs, sizeof(double)) != 0) return false;
+    if (std::memcmp(&a[i].fadeMs, &b[i].fadeMs, sizeof(double)) != 0) return false;
+    if (!a[i].silence && std::memcmp(&a[i].frame, &b[i].frame, sizeof(nvspFrontend_Frame)) != 0) return false;
+  }
+  return true;
+}
+
+// Multi-word clauses that repeat words in different surroundings, so the
+// cached handle both fills and hits its cache. They cover stress marks,
+// length marks, stress marks standing alone (carried to the next word), tie
+// bars, diphthongs, the copy-adjacent h and tone digits.
+const char* const kClauses[] = {
+  "ðɪs ɪz ə tˈɛst ɒv ɹˈiːdɪŋ",
+  "ðə kˈæt sˈæt ɒn ðə mˈæt",
+  "ðə mˈæt sˈæt ɒn ðə kˈæt",
+  "ˈeɪ ˈbiː ˈsiː ˈdiː ˈeɪ ˈbiː",
+  "t͡ʃˈɜːt͡ʃ d͡ʒˈʌd͡ʒ t͡ʃˈɜːt͡ʃ",
+  "hˈaʊs hˈiː hæz ə hˈaʊs",
+  "ə hˈaʊs ɪn ðə hˈaʊs",
+  "kæt  ˈ  dɔg kæt",
+  "dɔg kæt ˈ kæt ˌ dɔg kæt",
+  "ˌɪntəˈnæʃənəl ˈɪntəˌnæʃənəl",
+  "aɪ sˈɔː ɪt aɪ sˈɔː ɪt aɪ sˈɔː ɪt",
+  "guten taːk guten abənt",
+  "ni3 xau3 ni3 xau3 ma5",
+  "ɛnˈeɪ ɛn eɪ",
+  "t͡ ʃa t͡ʃa",
+};
+
+const char kClauseTypes[] = {'.', ',', '?', '!'};
+
+// Converts every clause twice (the second pass hits the cache) and returns
+// all frames in order.
+bool render(nvspFrontend_handle_t h, std::vector<Emitted>& out) {
+  out.clear();
+  for (int pass = 0; pass < 2; ++pass) {
+    int index = 0;
+    for (const char* clause : kClauses) {
+      const char clauseType[2] = {kClauseTypes[index % 4], 0};
+      if (!nvspFrontend_queueIPA(h, clause, 1.3, 110.0, 0.6, clauseType, index, collect, &out)) {
+        std::fprintf(stderr, "queueIPA failed for \"%s\": %s\n", clause, nvspFrontend_getLastError(h));
+        return false;
+      }
+      ++index;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s PACK_DIR\n", argv[0]);
+    return 2;
+  }
+  const std::string packDir = argv[1];
+
+  std::vector<std::string> langs;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(fs::path(packDir) / "packs" / "lang", ec)) {
+    if (entry.path().extension() == ".yaml") langs.push_back(entry.path().stem().string());
+  }
+  if (langs.empty()) {
+    std::fprintf(stderr, "no language packs found under %s\n", packDir.c_str());
+    return 1;
+  }
+
+  nvspFrontend_handle_t cached = nvspFrontend_create(packDir.c_str());
+  nvspFrontend_handle_t uncached = nvspFrontend_create(packDir.c_str());
+  if (!cached || !uncached) {
+    std::fprintf(stderr, "nvspFrontend_create failed\n");
+    return 1;
+  }
+
+  int failures = 0;
+  int tested = 0;
+  std::vector<Emitted> withCache;
+  std::vector<Emitted> withoutCache;
+  for (const std::string& lang : langs) {
+    if (!nvspFrontend_setLanguage(cached, lang.c_str())) {
+      // Packs that do not load are not this test's concern.
+      std::printf("skip %s: %s\n", lang.c_str(), nvspFrontend_getLastError(cached));
+      continue;
+    }
+    if (!nvspFrontend_setLanguage(uncached, lang.c_str()) ||
+        !nvspFrontend_overrideSetting(uncached, "wordTokenCacheSize", "0")) {
+      std::fprintf(stderr, "FAIL %s: could not set up the uncached handle: %s\n",
+        lang.c_str(), nvspFrontend_getLastError(uncached));
+      ++failures;
+      continue;
+    }
+    if (!render(cached, withCache) || !render(uncached, withoutCache)) {
+      std::fprintf(stderr, "FAIL %s: conversion failed\n", lang.c_str());
+      ++failures;
+      continue;
+    }
+    if (withCache.empty() || !sameOutput(withCache, withoutCache)) {
+      std::fprintf(stderr, "FAIL %s: frames differ with the word token cache on (%zu) and off (%zu)\n",
+        lang.c_str(), withCache.size(), withoutCache.size());
+      ++failures;
+    }
+    ++tested;
+  }
+
+  nvspFrontend_destroy(cached);
+  nvspFrontend_destroy(uncached);
+
+  if (failures) {
+    std::fprintf(stderr, "%d language(s) failed\n", failures);
+    return 1;
+  }
+  if (!tested) {
+    std::fprintf(stderr, "no language pack loaded\n");
+    return 1;
+  }
+  std::printf("word token cache: %d language(s) match\n", tested);
+  return 0;
+}
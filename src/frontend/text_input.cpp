@@ -0,0 +1,102 @@
+#include "text_input.h"
+
+#include "nvspFrontend.h"
+#include "utf8.h"
+
+namespace nvsp_frontend {
+
+static bool isClausePunct(char32_t c) {
+  return c == U'.' || c == U'?' || c == U'!' || c == U',' || c == U':' || c == U';';
+}
+
+static bool isLineBreak(char32_t c) {
+  return c == U'\r' || c == U'\n' || c == 0x2028 || c == 0x2029;
+}
+
+static bool isSpace(char32_t c) {
+  switch (c) {
+    case U' ':
+    case U'\t':
+    case U'\v':
+    case U'\f':
+    case 0x00A0:
+    case 0x1680:
+    case 0x202F:
+    case 0x205F:
+    case 0x3000:
+      return true;
+    default:
+      return isLineBreak(c) || (c >= 0x2000 && c <= 0x200A);
+  }
+}
+
+// Collapse whitespace runs into one space and trim both ends.
+static std::u32string normalizeWhitespace(std::u32string_view s) {
+  std::u32string out;
+  out.reserve(s.size());
+  bool pendingSpace = false;
+  for (char32_t c : s) {
+    if (isSpace(c)) {
+      pendingSpace = true;
+      continue;
+    }
+    if (pendingSpace && !out.empty()) out.push_back(U' ');
+    pendingSpace = false;
+    out.push_back(c);
+  }
+  return out;
+}
+
+static void addClause(std::u32string_view raw, std::vector<TextClause>& out) {
+  const std::u32string text = normalizeWhitespace(raw);
+  if (text.empty()) return;
+
+  TextClause clause;
+  const size_t n = text.size();
+  if (n >= 3 && text.compare(n - 3, 3, U"...") == 0) {
+    clause.punctuation = "...";
+    clause.clauseType = '.';
+  } else if (isClausePunct(text[n - 1])) {
+    clause.clauseType = static_cast<char>(text[n - 1]);
+    clause.punctuation.assign(1, clause.clauseType);
+  }
+  clause.textUtf8 = u32ToUtf8(text);
+  out.push_back(std::move(clause));
+}
+
+std::vector<TextClause> splitTextClauses(std::string_view textUtf8) {
+  const std::u32string text = utf8ToU32(textUtf8);
+  std::vector<TextClause> out;
+
+  size_t start = 0;
+  for (size_t i = 1; i < text.size(); ++i) {
+    // The whitespace after the punctuation is the separator and is dropped.
+    if (isSpace(text[i]) && isClausePunct(text[i - 1])) {
+      addClause(std::u32string_view(text).substr(start, i - start), out);
+      start = i + 1;
+    }
+  }
+  if (start < text.size()) {
+    addClause(std::u32string_view(text).substr(start), out);
+  }
+  return out;
+}
+
+double punctuationPauseMs(const std::string& punctuation, int pauseMode) {
+  if (punctuation.empty() || pauseMode == NVSP_FRONTEND_PAUSE_OFF) return 0.0;
+  const bool isLong = (pauseMode == NVSP_FRONTEND_PAUSE_LONG);
+
+  // Strong and medium clause boundaries.
+  if (punctuation == "." || punctuation == "!" || punctuation == "?" || punctuation == "..." ||
+      punctuation == ":" || punctuation == ";") {
+    return isLong ? 50.0 : 30.0;
+  }
+  // Commas are very frequent; keep the short mode at 0 ms to avoid
+  // adding noticeable latency over long passages.
+  if (punctuation == ",") {
+    return isLong ? 6.0 : 0.0;
+  }
+  return 0.0;
+}
+
+} // namespace nvsp_frontend
@@ -0,0 +1,30 @@
+#ifndef NVSP_FRONTEND_TEXT_INPUT_H
+#define NVSP_FRONTEND_TEXT_INPUT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nvsp_frontend {
+
+// One clause of plain text, ready for the phonemizer.
+struct TextClause {
+  std::string textUtf8;
+  // Clause type for intonation: '.', ',', '?', '!', ':', ';' (an ellipsis counts as '.').
+  char clauseType = '.';
+  // Punctuation that ended the clause ("...", ".", ",", ...), or empty if none.
+  std::string punctuation;
+};
+
+// Split text into clauses the way the NVDA driver always has: break after
+// . ? ! , : ; when followed by whitespace, turn line breaks and whitespace runs
+// into single spaces, and drop clauses that end up empty.
+std::vector<TextClause> splitTextClauses(std::string_view textUtf8);
+
+// Pause after a clause's punctuation for the given pause mode
+// (NVSP_FRONTEND_PAUSE_OFF/SHORT/LONG), in ms.
+double punctuationPauseMs(const std::string& punctuation, int pauseMode);
+
+} // namespace nvsp_frontend
+
+#endif
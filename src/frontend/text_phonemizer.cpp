@@ -0,0 +1,214 @@
+#include "text_phonemizer.h"
+
+#include "phonemizer_worker.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace nvsp_frontend {
+
+// -------------------------
+// eSpeak NG
+// -------------------------
+
+// espeak_AUDIO_OUTPUT / espeakCHARS_* / espeakINITIALIZE_* values from speak_lib.h.
+static constexpr int kEspeakAudioOutputSynchronous = 2;
+static constexpr int kEspeakCharsUtf8 = 1;
+static constexpr int kEspeakInitializeDontExit = 0x8000;
+// IPA (bit 1) with U+0361 as the tie character (bit 7 plus the character in bits 8-23).
+static constexpr int kEspeakDefaultPhonemeMode = 0x36100 + 0x82;
+
+#ifdef _WIN32
+static std::wstring utf8ToWide(const std::string& s) {
+  if (s.empty()) return std::wstring();
+  const int n = MultiByteToWideChar(CP_UTF8, 0, s.data(), static_cast<int>(s.size()), nullptr, 0);
+  std::wstring out(static_cast<size_t>(n > 0 ? n : 0), L'\0');
+  if (n > 0) MultiByteToWideChar(CP_UTF8, 0, s.data(), static_cast<int>(s.size()), &out[0], n);
+  return out;
+}
+#endif
+
+namespace {
+
+class EspeakPhonemizer : public TextPhonemizer {
+public:
+  using InitializeFn = int (*)(int output, int buflength, const char* path, int options);
+  using SetVoiceByNameFn = int (*)(const char* name);
+  using TextToPhonemesFn = const char* (*)(const void** textptr, int textmode, int phonememode);
+  using TerminateFn = int (*)();
+
+  ~EspeakPhonemizer() override {
+    if (m_initialized && m_terminate) m_terminate();
+    if (m_lib) {
+#ifdef _WIN32
+      FreeLibrary(static_cast<HMODULE>(m_lib));
+#else
+      dlclose(m_lib);
+#endif
+    }
+  }
+
+  bool open(const EspeakPhonemizerOptions& opts, std::string& outError) {
+#ifdef _WIN32
+    const std::wstring path = opts.libraryPath.empty() ? std::wstring(L"libespeak-ng.dll") : utf8ToWide(opts.libraryPath);
+    m_lib = LoadLibraryW(path.c_str());
+#else
+    const std::string path = opts.libraryPath.empty() ? std::string("libespeak-ng.so.1") : opts.libraryPath;
+    m_lib = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+    if (!m_lib) {
+      outError = "Could not load the eSpeak NG library" + (opts.libraryPath.empty() ? std::string() : " '" + opts.libraryPath + "'");
+      return false;
+    }
+
+    auto* initialize = reinterpret_cast<InitializeFn>(symbol("espeak_Initialize"));
+    auto* setVoice = reinterpret_cast<SetVoiceByNameFn>(symbol("espeak_SetVoiceByName"));
+    m_textToPhonemes = reinterpret_cast<TextToPhonemesFn>(symbol("espeak_TextToPhonemes"));
+    m_terminate = reinterpret_cast<TerminateFn>(symbol("espeak_Terminate"));
+    if (!initialize || !setVoice || !m_textToPhonemes) {
+      outError = "The eSpeak NG library does not export espeak_TextToPhonemes";
+      return false;
+    }
+
+    if (opts.initialize) {
+      const char* dataPath = opts.dataPath.empty() ? nullptr : opts.dataPath.c_str();
+      if (initialize(kEspeakAudioOutputSynchronous, 0, dataPath, kEspeakInitializeDontExit) <= 0) {
+        outError = "espeak_Initialize failed";
+        return false;
+      }
+      m_initialized = true;
+    }
+    if (!opts.voice.empty() && setVoice(opts.voice.c_str()) != 0) {
+      outError = "eSpeak NG has no voice '" + opts.voice + "'";
+      return false;
+    }
+    m_phonemeMode = (opts.phonemeMode != 0) ? opts.phonemeMode : kEspeakDefaultPhonemeMode;
+    return true;
+  }
+
+  bool phonemize(const std::string& textUtf8, std::string& outIpaUtf8, std::string& outError) override {
+    outIpaUtf8.clear();
+    (void)outError;
+    // espeak_TextToPhonemes converts one clause per call and advances textPtr,
+    // setting it to NULL at the end of the text.
+    const void* textPtr = textUtf8.c_str();
+    const void* lastPtr = nullptr;
+    while (textPtr && textPtr != lastPtr) {
+      lastPtr = textPtr;
+      const char* phonemes = m_textToPhonemes(&textPtr, kEspeakCharsUtf8, m_phonemeMode);
+      if (!phonemes) break;
+      outIpaUtf8 += phonemes;
+    }
+    const size_t first = outIpaUtf8.find_first_not_of(" \t\r\n");
+    const size_t last = outIpaUtf8.find_last_not_of(" \t\r\n");
+    outIpaUtf8 = (first == std::string::npos) ? std::string() : outIpaUtf8.substr(first, last - first + 1);
+    return true;
+  }
+
+private:
+  void* symbol(const char* name) {
+#ifdef _WIN32
+    return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(m_lib), name));
+#else
+    return dlsym(m_lib, name);
+#endif
+  }
+
+  void* m_lib = nullptr;
+  TextToPhonemesFn m_textToPhonemes = nullptr;
+  TerminateFn m_terminate = nullptr;
+  bool m_initialized = false;
+  int m_phonemeMode = kEspeakDefaultPhonemeMode;
+};
+
+// -------------------------
+// External process
+// -------------------------
+
+class ProcessPhonemizer : public TextPhonemizer {
+public:
+  ProcessPhonemizer(const std::string& commandLine, unsigned timeoutMs)
+    : m_commandLine(commandLine), m_timeoutMs(timeoutMs ? timeoutMs : 10000u) {}
+
+  bool start(std::string& outError) { return m_worker.start(m_commandLine, std::string(), outError); }
+
+  bool phonemize(const std::string& textUtf8, std::string& outIpaUtf8, std::string& outError) override {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+      if (!m_worker.running() && !start(outError)) return false;
+      bool protocolOk = false;
+      if (m_worker.request(textUtf8, m_timeoutMs, outIpaUtf8, outError, protocolOk)) return true;
+      // The worker answered with an error: retrying won't help.
+      if (protocolOk) return false;
+      m_worker.stop();
+    }
+    return false;
+  }
+
+private:
+  std::string m_commandLine;
+  unsigned m_timeoutMs;
+  PhonemizerWorker m_worker;
+};
+
+// -------------------------
+// Stub
+// -------------------------
+
+class StubPhonemizer : public TextPhonemizer {
+public:
+  bool phonemize(const std::string& textUtf8, std::string& outIpaUtf8, std::string& outError) override {
+    (void)outError;
+    static const char* const kLetters[26] = {
+      "a", "b", "k", "d", "ɛ", "f", "ɡ", "h", "i", "dʒ", "k", "l", "m",
+      "n", "ɔ", "p", "k", "ɹ", "s", "t", "u", "v", "w", "ks", "j", "z",
+    };
+    outIpaUtf8.clear();
+    bool inWord = false;
+    for (char ch : textUtf8) {
+      const unsigned char c = static_cast<unsigned char>(ch);
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+        inWord = false;
+        continue;
+      }
+      int letter = -1;
+      if (c >= 'a' && c <= 'z') letter = c - 'a';
+      else if (c >= 'A' && c <= 'Z') letter = c - 'A';
+      if (letter < 0) continue;
+      if (!inWord) {
+        if (!outIpaUtf8.empty()) outIpaUtf8 += ' ';
+        outIpaUtf8 += "ˈ";
+        inWord = true;
+      }
+      outIpaUtf8 += kLetters[letter];
+    }
+    return true;
+  }
+};
+
+} // namespace
+
+std::unique_ptr<TextPhonemizer> createEspeakPhonemizer(const EspeakPhonemizerOptions& opts, std::string& outError) {
+  auto p = std::make_unique<EspeakPhonemizer>();
+  if (!p->open(opts, outError)) return nullptr;
+  return p;
+}
+
+std::unique_ptr<TextPhonemizer> createProcessPhonemizer(const std::string& commandLine, unsigned timeoutMs, std::string& outError) {
+  if (commandLine.empty()) {
+    outError = "No phonemizer command line";
+    return nullptr;
+  }
+  auto p = std::make_unique<ProcessPhonemizer>(commandLine, timeoutMs);
+  // Start now so a bad command line is reported by setPhonemizer, not the first queueText.
+  if (!p->start(outError)) return nullptr;
+  return p;
+}
+
+std::unique_ptr<TextPhonemizer> createStubPhonemizer() {
+  return std::make_unique<StubPhonemizer>();
+}
+
+} // namespace nvsp_frontend
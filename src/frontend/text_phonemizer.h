@@ -0,0 +1,50 @@
+#ifndef NVSP_FRONTEND_TEXT_PHONEMIZER_H
+#define NVSP_FRONTEND_TEXT_PHONEMIZER_H
+
+#include <memory>
+#include <string>
+
+namespace nvsp_frontend {
+
+// Text -> IPA stage used by nvspFrontend_queueText.
+// One phonemizer belongs to one handle and is only called with the handle locked.
+class TextPhonemizer {
+public:
+  virtual ~TextPhonemizer() = default;
+
+  // Convert one clause of plain text to IPA.
+  virtual bool phonemize(const std::string& textUtf8, std::string& outIpaUtf8, std::string& outError) = 0;
+};
+
+struct EspeakPhonemizerOptions {
+  // Path to the eSpeak NG library. Empty uses the platform's default library name.
+  std::string libraryPath;
+  // Directory containing espeak-ng-data. Empty uses the library's default.
+  std::string dataPath;
+  // Voice to select. Empty keeps the voice the host selected.
+  std::string voice;
+  // Call espeak_Initialize (and espeak_Terminate when done). Leave this off when
+  // the host process has already initialized the same library, as NVDA has.
+  bool initialize = false;
+  // espeak_TextToPhonemes phonememode. 0 uses IPA with U+0361 tie bars.
+  int phonemeMode = 0;
+};
+
+// eSpeak NG, loaded at runtime so the frontend has no link-time dependency on it.
+std::unique_ptr<TextPhonemizer> createEspeakPhonemizer(const EspeakPhonemizerOptions& opts, std::string& outError);
+
+// A long-lived external process, started with commandLine, that speaks the
+// PhonemizerWorker protocol (phonemizer_worker.h), as the phoneme editor's
+// phonemizer workers do.
+// A process that exits, breaks the protocol or times out is restarted and the
+// request is tried once more.
+std::unique_ptr<TextPhonemizer> createProcessPhonemizer(const std::string& commandLine, unsigned timeoutMs, std::string& outError);
+
+// A deterministic letter-to-phoneme stub for tests and benchmarks: ASCII letters
+// map to one phoneme each (c/q -> k, j -> dʒ, x -> ks, ...), every word gets
+// primary stress and anything else is dropped.
+std::unique_ptr<TextPhonemizer> createStubPhonemizer();
+
+} // namespace nvsp_frontend
+
+#endif
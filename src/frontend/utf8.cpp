@@ -6,9 +6,9 @@ namespace nvsp_frontend {
 
 static inline char32_t kReplacementChar = 0xFFFD;
 
-std::u32string utf8ToU32(std::string_view s) {
-  std::u32string out;
-  out.reserve(s.size());
+template <class U32String>
+static void decodeUtf8(std::string_view s, U32String& out) {
+  out.reserve(out.size() + s.size());
 
   const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
   const unsigned char* end = p + s.size();
@@ -82,10 +82,19 @@ std::u32string utf8ToU32(std::string_view s) {
 
     out.push_back(static_cast<char32_t>(cp));
   }
+}
 
+std::u32string utf8ToU32(std::string_view s) {
+  std::u32string out;
+  decodeUtf8(s, out);
   return out;
 }
 
+void utf8ToU32(std::string_view s, std::pmr::u32string& out) {
+  out.clear();
+  decodeUtf8(s, out);
+}
+
 std::string u32ToUtf8(std::u32string_view s) {
   std::string out;
   out.reserve(s.size());
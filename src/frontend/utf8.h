@@ -1,6 +1,7 @@
 #ifndef NVSP_FRONTEND_UTF8_H
 #define NVSP_FRONTEND_UTF8_H
 
+#include <memory_resource>
 #include <string>
 #include <string_view>
 
@@ -8,6 +9,8 @@ namespace nvsp_frontend {
 
 // Best-effort UTF-8 -> UTF-32. Invalid sequences become U+FFFD.
 std::u32string utf8ToU32(std::string_view s);
+// Same, into out (replacing its contents) and out's allocator.
+void utf8ToU32(std::string_view s, std::pmr::u32string& out);
 
 // UTF-32 -> UTF-8.
 std::string u32ToUtf8(std::u32string_view s);
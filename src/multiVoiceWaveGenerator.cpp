@@ -0,0 +1,441 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+/*
+Structure-of-arrays version of the scalar path in speechWaveGenerator.cpp (the default engine, SPEECHPLAYER_INIT_SCALAR_CASCADE).
+Every per-sample stage is written as a branch free loop over a fixed number of lanes so that the compiler can turn it into
+packed AVX2 (4 doubles) or AVX-512 (8 doubles) instructions.
+As in fixedPointWaveGenerator.cpp, the voice source runs on 32 bit phase accumulators and reads the vibrato sine and the
+glottal pulse from tables, instead of calling fmod, sin and cos per lane. Each lane draws noise from its own generator.
+A lane therefore follows a single player closely but not bit for bit: the tables cost some precision and the noise differs.
+*/
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "utils.h"
+#include "multiVoiceWaveGenerator.h"
+
+#if defined(__AVX512F__)
+const int kLaneWidth=8;
+#else
+const int kLaneWidth=4;
+#endif
+
+const double PITWO=M_PI*2;
+
+const int sineTableBits=10;
+const int sineTableSize=1<<sineTableBits;
+const int pulseTableSize=1024;
+
+// The same resonator as in speechWaveGenerator.cpp, one instance per lane.
+struct ResonatorLanes {
+	bool anti;
+	alignas(64) double a[kLaneWidth];
+	alignas(64) double b[kLaneWidth];
+	alignas(64) double c[kLaneWidth];
+	alignas(64) double p1[kLaneWidth];
+	alignas(64) double p2[kLaneWidth];
+
+	void init(bool anti) {
+		this->anti=anti;
+		for(int l=0;l<kLaneWidth;++l) {
+			a[l]=b[l]=c[l]=0;
+			reset(l);
+		}
+	}
+
+	// Loads the coefficients of resonator index from each lane's set, except in lanes where hold is set.
+	void updateCoefficients(const bool* hold, const speechPlayer_resonatorCoefficients_t* const* coefficients, int index) {
+		for(int l=0;l<kLaneWidth;++l) {
+			const speechPlayer_resonatorCoefficients_t& laneCoefficients=coefficients[l][index];
+			a[l]=hold[l]?a[l]:laneCoefficients.a;
+			b[l]=hold[l]?b[l]:laneCoefficients.b;
+			c[l]=hold[l]?c[l]:laneCoefficients.c;
+		}
+	}
+
+	// in and out may point to the same array.
+	void resonate(const double* in, double* out) {
+		if(anti) {
+			for(int l=0;l<kLaneWidth;++l) {
+				double x=in[l];
+				double y=a[l]*x+b[l]*p1[l]+c[l]*p2[l];
+				p2[l]=p1[l];
+				p1[l]=x;
+				out[l]=y;
+			}
+		} else {
+			for(int l=0;l<kLaneWidth;++l) {
+				double y=a[l]*in[l]+b[l]*p1[l]+c[l]*p2[l];
+				p2[l]=p1[l];
+				p1[l]=y;
+				out[l]=y;
+			}
+		}
+	}
+
+	void reset(int lane) {
+		p1[lane]=0;
+		p2[lane]=0;
+	}
+
+};
+
+typedef speechPlayer_frameParam_t speechPlayer_frame_t::*frameParamMember_t;
+
+// Cascade resonators in processing order: nasal zero, nasal pole, then formants 6 down to 1.
+const int numCascadeResonators=8;
+const int cascadeResonators[numCascadeResonators]={speechPlayer_resonator_cfN0,speechPlayer_resonator_cfNP,speechPlayer_resonator_cf6,speechPlayer_resonator_cf5,speechPlayer_resonator_cf4,speechPlayer_resonator_cf3,speechPlayer_resonator_cf2,speechPlayer_resonator_cf1};
+
+const int numParallelResonators=6;
+const int parallelResonators[numParallelResonators]={speechPlayer_resonator_pf1,speechPlayer_resonator_pf2,speechPlayer_resonator_pf3,speechPlayer_resonator_pf4,speechPlayer_resonator_pf5,speechPlayer_resonator_pf6};
+const frameParamMember_t parallelAmplitudes[numParallelResonators]={&speechPlayer_frame_t::pa1,&speechPlayer_frame_t::pa2,&speechPlayer_frame_t::pa3,&speechPlayer_frame_t::pa4,&speechPlayer_frame_t::pa5,&speechPlayer_frame_t::pa6};
+
+// The frame parameters the per-sample loops read, copied from every lane's current frame each sample so the loops read plain arrays.
+struct FrameLanes {
+	alignas(64) double voicePitch[kLaneWidth];
+	alignas(64) double vibratoPitchOffset[kLaneWidth];
+	alignas(64) double vibratoSpeed[kLaneWidth];
+	alignas(64) double voiceTurbulenceAmplitude[kLaneWidth];
+	alignas(64) double glottalOpenQuotient[kLaneWidth];
+	alignas(64) double voiceAmplitude[kLaneWidth];
+	alignas(64) double aspirationAmplitude[kLaneWidth];
+	alignas(64) double caNP[kLaneWidth];
+	alignas(64) double fricationAmplitude[kLaneWidth];
+	alignas(64) double pa[numParallelResonators][kLaneWidth];
+	alignas(64) double parallelBypass[kLaneWidth];
+	alignas(64) double preFormantGain[kLaneWidth];
+	alignas(64) double outputGain[kLaneWidth];
+	alignas(64) double trillRate[kLaneWidth];
+	alignas(64) double trillDepth[kLaneWidth];
+	alignas(64) double trillClosureFraction[kLaneWidth];
+	alignas(64) double trillFricationFloor[kLaneWidth];
+
+	void set(int lane, const speechPlayer_frame_t* frame) {
+		voicePitch[lane]=frame->voicePitch;
+		vibratoPitchOffset[lane]=frame->vibratoPitchOffset;
+		vibratoSpeed[lane]=frame->vibratoSpeed;
+		voiceTurbulenceAmplitude[lane]=frame->voiceTurbulenceAmplitude;
+		glottalOpenQuotient[lane]=frame->glottalOpenQuotient;
+		voiceAmplitude[lane]=frame->voiceAmplitude;
+		aspirationAmplitude[lane]=frame->aspirationAmplitude;
+		caNP[lane]=frame->caNP;
+		fricationAmplitude[lane]=frame->fricationAmplitude;
+		for(int s=0;s<numParallelResonators;++s) pa[s][lane]=frame->*parallelAmplitudes[s];
+		parallelBypass[lane]=frame->parallelBypass;
+		preFormantGain[lane]=frame->preFormantGain;
+		outputGain[lane]=frame->outputGain;
+		trillRate[lane]=frame->trillRate;
+		trillDepth[lane]=frame->trillDepth;
+		trillClosureFraction[lane]=frame->trillClosureFraction;
+		trillFricationFloor[lane]=frame->trillFricationFloor;
+	}
+
+};
+
+// All state for kLaneWidth voices.
+struct LaneGroup {
+	FrameManager* frameManagers[kLaneWidth];
+	FrameLanes frame;
+	const speechPlayer_resonatorCoefficients_t* coefficients[kLaneWidth];
+	bool running[kLaneWidth];
+	bool wasSilence[kLaneWidth];
+	// Phase accumulators: a full cycle is 2^32, so wrapping around is free.
+	alignas(64) uint32_t pitchPhase[kLaneWidth];
+	alignas(64) uint32_t vibratoPhase[kLaneWidth];
+	alignas(64) uint32_t trillPhase[kLaneWidth];
+	// Private random state of each lane's noise sources, see nextRandom.
+	alignas(64) uint32_t randomState[kLaneWidth];
+	alignas(64) double trillClosure[kLaneWidth];
+	alignas(64) double aspirationLastValue[kLaneWidth];
+	alignas(64) double fricLastValue[kLaneWidth];
+	alignas(64) double lastVoiceInput[kLaneWidth];
+	alignas(64) double lastVoiceOutput[kLaneWidth];
+	alignas(64) double lastInput[kLaneWidth];
+	alignas(64) double lastOutput[kLaneWidth];
+	ResonatorLanes cascade[numCascadeResonators];
+	ResonatorLanes parallel[numParallelResonators];
+
+	LaneGroup() {
+		for(int s=0;s<numCascadeResonators;++s) cascade[s].init(s==0);
+		for(int s=0;s<numParallelResonators;++s) parallel[s].init(false);
+		for(int l=0;l<kLaneWidth;++l) {
+			frameManagers[l]=NULL;
+			coefficients[l]=NULL;
+			randomState[l]=0;
+			running[l]=false;
+			wasSilence[l]=true;
+			resetLane(l);
+		}
+	}
+
+	void resetLane(int l) {
+		pitchPhase[l]=0;
+		vibratoPhase[l]=0;
+		trillPhase[l]=0;
+		trillClosure[l]=0;
+		aspirationLastValue[l]=0;
+		fricLastValue[l]=0;
+		lastVoiceInput[l]=0;
+		lastVoiceOutput[l]=0;
+		lastInput[l]=0;
+		lastOutput[l]=0;
+		for(int s=0;s<numCascadeResonators;++s) cascade[s].reset(l);
+		for(int s=0;s<numParallelResonators;++s) parallel[s].reset(l);
+	}
+
+};
+
+class MultiVoiceWaveGeneratorImpl: public MultiVoiceWaveGenerator {
+	private:
+	int numVoices;
+	std::vector<LaneGroup> groups;
+	speechPlayer_frame_t silentFrame;
+
+	double phaseScale;
+	double sineTable[sineTableSize+1];
+	// Glottal pulse over the open phase, already doubled as in VoiceGenerator.
+	double pulseTable[pulseTableSize+1];
+	// Read by lanes without a frame manager, whose coefficients are held anyway.
+	speechPlayer_resonatorCoefficients_t silentCoefficients[speechPlayer_numResonators];
+
+	static double nextNoise(uint32_t& randomState, double& lastValue) {
+		lastValue=(((double)nextRandom(randomState)/(double)nextRandomMax)-0.5)+0.75*lastValue;
+		return lastValue;
+	}
+
+	// The phase step of a frequency, a full cycle being 2^32.
+	uint32_t phaseStep(double frequency) {
+		double step=frequency*phaseScale;
+		step=(step<2147483647.0)?step:2147483647.0;
+		step=(step>-2147483648.0)?step:-2147483648.0;
+		return (uint32_t)(int32_t)step;
+	}
+
+	// The position within a cycle, from 0 up to 1, of a phase.
+	static double cyclePosition(uint32_t phase) {
+		return (double)(int32_t)(phase>>1)*(1.0/2147483648.0);
+	}
+
+	double lookupSine(uint32_t phase) {
+		uint32_t index=phase>>(32-sineTableBits);
+		double frac=cyclePosition(phase<<sineTableBits);
+		return sineTable[index]+(sineTable[index+1]-sineTable[index])*frac;
+	}
+
+	// phase runs from 0 to 1 over the open part of the cycle; values outside are clamped.
+	double lookupPulse(double phase) {
+		double position=phase*pulseTableSize;
+		position=(position>0.0)?position:0.0;
+		position=(position<(double)pulseTableSize)?position:(double)pulseTableSize;
+		int index=(int)position;
+		index=(index<pulseTableSize-1)?index:(pulseTableSize-1);
+		return pulseTable[index]+(pulseTable[index+1]-pulseTable[index])*(position-index);
+	}
+
+	// calculateTrillClosure without branches: the rising and falling edges are clamped to [0, 1] instead.
+	static double trillClosureLane(double cyclePos, double rate, double closureFraction) {
+		closureFraction=(closureFraction<1.0)?closureFraction:1.0;
+		double edge=0.002*rate;
+		edge=(edge<0.12)?edge:0.12;
+		edge=(edge<closureFraction/2)?edge:(closureFraction/2);
+		bool closing=(closureFraction>0.0)&(edge>0.0);
+		edge=closing?edge:1.0;
+		double rising=(cyclePos-(1.0-closureFraction))/edge;
+		double falling=(1.0-cyclePos)/edge;
+		double closure=(rising<falling)?rising:falling;
+		closure=(closure<1.0)?closure:1.0;
+		closure=(closure>0.0)?closure:0.0;
+		return closing?closure:0.0;
+	}
+
+	// NaN safe linear fade, as calculateValueAtFadePosition.
+	static double fadeLane(double oldVal, double newVal, double ratio) {
+		double faded=oldVal+((newVal-oldVal)*ratio);
+		return (newVal!=newVal)?oldVal:faded;
+	}
+
+	// Renders one sample for every lane of the group into out.
+	void generateSample(LaneGroup& g, double* out) {
+		const FrameLanes& f=g.frame;
+		alignas(64) double aspiration[kLaneWidth];
+		alignas(64) double fric[kLaneWidth];
+		alignas(64) double voice[kLaneWidth];
+		alignas(64) double cascadeOut[kLaneWidth];
+		alignas(64) double nasalZeroOut[kLaneWidth];
+		alignas(64) double parallelIn[kLaneWidth];
+		alignas(64) double parallelOut[kLaneWidth];
+		alignas(64) double resonatorOut[kLaneWidth];
+		bool holdCoefficients[kLaneWidth];
+
+		for(int l=0;l<kLaneWidth;++l) {
+			aspiration[l]=nextNoise(g.randomState[l],g.aspirationLastValue[l])*0.1;
+			g.vibratoPhase[l]+=phaseStep(f.vibratoSpeed[l]);
+			double vibrato=(lookupSine(g.vibratoPhase[l])*0.06*f.vibratoPitchOffset[l])+1;
+			g.pitchPhase[l]+=phaseStep(f.voicePitch[l]*vibrato);
+			double cyclePos=cyclePosition(g.pitchPhase[l]);
+			double effectiveOQ=f.glottalOpenQuotient[l];
+			effectiveOQ=(effectiveOQ<=0.0)?0.7:effectiveOQ;
+			double openLen=1.0-effectiveOQ;
+			openLen=(openLen<0.0001)?0.0001:openLen;
+			bool open=cyclePos>=effectiveOQ;
+			double shape=lookupPulse((cyclePos-effectiveOQ)/openLen);
+			double turbulence=aspiration[l]*f.voiceTurbulenceAmplitude[l]*(open?1.0:0.01);
+			double rawVoice=((open?shape:0.0)+turbulence)*f.voiceAmplitude[l];
+			// A lane without a trill holds its phase at 0, so every trill starts at the open part of its first cycle.
+			bool trill=f.trillRate[l]>0;
+			uint32_t trillPhase=g.trillPhase[l]+phaseStep(f.trillRate[l]);
+			g.trillPhase[l]=trill?trillPhase:0;
+			double trillClosure=trillClosureLane(cyclePosition(g.trillPhase[l]),f.trillRate[l],f.trillClosureFraction[l]);
+			g.trillClosure[l]=trill?trillClosure:0.0;
+			rawVoice*=1.0-g.trillClosure[l]*f.trillDepth[l];
+			rawVoice=(aspiration[l]*f.aspirationAmplitude[l])+rawVoice;
+			voice[l]=rawVoice-g.lastVoiceInput[l]+0.995*g.lastVoiceOutput[l];
+			g.lastVoiceInput[l]=rawVoice;
+			g.lastVoiceOutput[l]=voice[l];
+			voice[l]=(voice[l]*f.preFormantGain[l])/2.0;
+			// Resonator coefficients only change while the glottis is closed, as in the single voice generator.
+			holdCoefficients[l]=open|!g.running[l];
+		}
+		for(int s=0;s<numCascadeResonators;++s) g.cascade[s].updateCoefficients(holdCoefficients,g.coefficients,cascadeResonators[s]);
+		for(int s=0;s<numParallelResonators;++s) g.parallel[s].updateCoefficients(holdCoefficients,g.coefficients,parallelResonators[s]);
+		g.cascade[0].resonate(voice,nasalZeroOut);
+		g.cascade[1].resonate(nasalZeroOut,cascadeOut);
+		for(int l=0;l<kLaneWidth;++l) {
+			cascadeOut[l]=fadeLane(voice[l],cascadeOut[l],f.caNP[l]);
+		}
+		for(int s=2;s<numCascadeResonators;++s) {
+			g.cascade[s].resonate(cascadeOut,cascadeOut);
+		}
+		for(int l=0;l<kLaneWidth;++l) {
+			double fricationAmplitude=f.fricationAmplitude[l];
+			// Raising the amplitude towards the floor in proportion to the closure is a no-op without a closure or above the floor.
+			double floorGap=f.trillFricationFloor[l]-fricationAmplitude;
+			fricationAmplitude+=((floorGap>0.0)?floorGap:0.0)*g.trillClosure[l];
+			fric[l]=nextNoise(g.randomState[l],g.fricLastValue[l])*0.175*fricationAmplitude;
+		}
+		for(int l=0;l<kLaneWidth;++l) {
+			parallelIn[l]=(fric[l]*f.preFormantGain[l])/2.0;
+			parallelOut[l]=0;
+		}
+		for(int s=0;s<numParallelResonators;++s) {
+			g.parallel[s].resonate(parallelIn,resonatorOut);
+			for(int l=0;l<kLaneWidth;++l) {
+				parallelOut[l]+=(resonatorOut[l]-parallelIn[l])*f.pa[s][l];
+			}
+		}
+		for(int l=0;l<kLaneWidth;++l) {
+			parallelOut[l]=fadeLane(parallelOut[l],parallelIn[l],f.parallelBypass[l]);
+			double mixed=(cascadeOut[l]+parallelOut[l])*f.outputGain[l];
+			double filteredOut=mixed-g.lastInput[l]+0.999*g.lastOutput[l];
+			g.lastInput[l]=mixed;
+			g.lastOutput[l]=filteredOut;
+			out[l]=filteredOut;
+		}
+	}
+
+	void generateGroup(LaneGroup& g, int firstVoice, const unsigned int sampleCount, sample* sampleBufs, int* sampleCounts) {
+		for(int l=0;l<kLaneWidth;++l) {
+			g.running[l]=(firstVoice+l<numVoices)&&g.frameManagers[l];
+			if(firstVoice+l<numVoices) sampleCounts[firstVoice+l]=0;
+		}
+		alignas(64) double out[kLaneWidth];
+		unsigned int i;
+		for(i=0;i<sampleCount;++i) {
+			bool anyRunning=false;
+			for(int l=0;l<kLaneWidth;++l) {
+				const speechPlayer_frame_t* frame=g.running[l]?g.frameManagers[l]->getCurrentFrame():NULL;
+				if(frame) {
+					if(g.wasSilence[l]) {
+						g.resetLane(l);
+						g.wasSilence[l]=false;
+					}
+					g.frame.set(l,frame);
+					g.coefficients[l]=g.frameManagers[l]->getCurrentCoefficients()->resonators;
+					anyRunning=true;
+					continue;
+				}
+				if(g.running[l]) {
+					g.running[l]=false;
+					g.wasSilence[l]=true;
+					sampleCounts[firstVoice+l]=i;
+				}
+				g.frame.set(l,&silentFrame);
+				g.coefficients[l]=silentCoefficients;
+			}
+			if(!anyRunning) break;
+			generateSample(g,out);
+			for(int l=0;l<kLaneWidth;++l) {
+				if(!g.running[l]) continue;
+				sampleBufs[(firstVoice+l)*sampleCount+i].value=(int)max(min(out[l]*4000,32000),-32000);
+			}
+		}
+		for(int l=0;l<kLaneWidth;++l) {
+			if(g.running[l]) sampleCounts[firstVoice+l]=i;
+		}
+	}
+
+	public:
+	MultiVoiceWaveGeneratorImpl(int sr, int numVoices): numVoices(numVoices), groups((numVoices+kLaneWidth-1)/kLaneWidth), silentFrame(), phaseScale(4294967296.0/sr), silentCoefficients() {
+		for(int i=0;i<=sineTableSize;++i) {
+			sineTable[i]=sin(PITWO*i/sineTableSize);
+		}
+		for(int i=0;i<=pulseTableSize;++i) {
+			double phase=(double)i/pulseTableSize;
+			double voice;
+			if(phase<0.9) {
+				voice=0.5*(1-cos(phase*M_PI/0.9));
+			} else {
+				double v=(phase-0.9)*10;
+				voice=1-v*v;
+			}
+			pulseTable[i]=voice*2;
+		}
+		// Every voice gets its own noise sequence.
+		for(int v=0;v<numVoices;++v) {
+			groups[v/kLaneWidth].randomState[v%kLaneWidth]=(uint32_t)v;
+		}
+	}
+
+	int getNumVoices() {
+		return numVoices;
+	}
+
+	void setFrameManager(int voice, FrameManager* frameManager) {
+		if(voice<0||voice>=numVoices) return;
+		groups[voice/kLaneWidth].frameManagers[voice%kLaneWidth]=frameManager;
+	}
+
+	unsigned int generate(const unsigned int sampleCount, sample* sampleBufs, int* sampleCounts) {
+		DenormalsAreZero denormalsAreZero;
+		unsigned int maxCount=0;
+		for(size_t g=0;g<groups.size();++g) {
+			generateGroup(groups[g],(int)g*kLaneWidth,sampleCount,sampleBufs,sampleCounts);
+		}
+		for(int v=0;v<numVoices;++v) {
+			if((unsigned int)sampleCounts[v]>maxCount) maxCount=sampleCounts[v];
+		}
+		return maxCount;
+	}
+
+};
+
+MultiVoiceWaveGenerator* MultiVoiceWaveGenerator::create(int sampleRate, int numVoices) {
+	if(numVoices<1) return NULL;
+	return new MultiVoiceWaveGeneratorImpl(sampleRate,numVoices);
+}
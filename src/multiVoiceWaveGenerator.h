@@ -0,0 +1,43 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#ifndef SPEECHPLAYER_MULTIVOICEWAVEGENERATOR_H
+#define SPEECHPLAYER_MULTIVOICEWAVEGENERATOR_H
+
+#include "frame.h"
+#include "sample.h"
+
+/**
+ * Renders several independent voices in lockstep.
+ * The generator state of all voices is laid out as structure-of-arrays, one vector lane per voice,
+ * so each DSP stage advances every voice with the same instructions.
+ * Each voice pulls its frames from its own FrameManager.
+ */
+class MultiVoiceWaveGenerator {
+	public:
+	static MultiVoiceWaveGenerator* create(int sampleRate, int numVoices);
+	virtual int getNumVoices()=0;
+	virtual void setFrameManager(int voice, FrameManager* frameManager)=0;
+	/**
+	 * Renders up to sampleCount samples for every voice.
+	 * sampleBufs holds numVoices consecutive blocks of sampleCount samples (one block per voice).
+	 * sampleCounts receives the number of samples actually produced for each voice;
+	 * a voice stops early in the same way a single speechPlayer does when its queue runs out.
+	 * @return the largest of the per-voice sample counts.
+	 */
+	virtual unsigned int generate(const unsigned int sampleCount, sample* sampleBufs, int* sampleCounts)=0;
+	virtual ~MultiVoiceWaveGenerator() {};
+};
+
+#endif
@@ -0,0 +1,92 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "frame.h"
+#include "speechWaveGenerator.h"
+#include "offlineRenderer.h"
+
+const unsigned int renderChunkSize=4096;
+
+struct segment_t {
+	unsigned int first;
+	unsigned int count;
+	std::vector<sample> samples;
+};
+
+static unsigned int segmentSeed(unsigned int noiseSeed, unsigned int index) {
+	// Spread consecutive segment numbers over the seed space, so neighbouring segments don't share a noise sequence.
+	unsigned int seed=noiseSeed^(index*0x9E3779B9u);
+	seed^=seed>>16;
+	seed*=0x85EBCA6Bu;
+	seed^=seed>>13;
+	return seed;
+}
+
+static void renderSegment(int sampleRate, unsigned int flags, const speechPlayer_frameRequest_t* frames, unsigned int seed, segment_t& segment) {
+	FrameManager* frameManager=FrameManager::create(sampleRate);
+	SpeechWaveGenerator* waveGenerator=SpeechWaveGenerator::create(sampleRate,flags);
+	waveGenerator->setFrameManager(frameManager);
+	waveGenerator->setNoiseSeed(seed);
+	for(unsigned int i=0;i<segment.count;++i) {
+		const speechPlayer_frameRequest_t& request=frames[segment.first+i];
+		frameManager->queueFrame(request.frame,request.minFrameDuration,request.fadeDuration,request.userIndex,false);
+	}
+	unsigned int produced;
+	do {
+		size_t oldSize=segment.samples.size();
+		segment.samples.resize(oldSize+renderChunkSize);
+		produced=waveGenerator->generate(renderChunkSize,&segment.samples[oldSize]);
+		segment.samples.resize(oldSize+produced);
+	} while(produced==renderChunkSize);
+	delete waveGenerator;
+	delete frameManager;
+}
+
+sample* OfflineRenderer::render(int sampleRate, unsigned int flags, const speechPlayer_frameRequest_t* frames, unsigned int count, unsigned int noiseSeed, unsigned int numThreads, unsigned int& sampleCount) {
+	std::vector<segment_t> segments;
+	unsigned int first=0;
+	for(unsigned int i=0;i<count;++i) {
+		if(frames[i].frame&&i+1<count) continue;
+		segment_t segment;
+		segment.first=first;
+		segment.count=i+1-first;
+		segments.push_back(segment);
+		first=i+1;
+	}
+	if(numThreads==0) numThreads=std::thread::hardware_concurrency();
+	if(numThreads==0) numThreads=1;
+	if(numThreads>segments.size()) numThreads=(unsigned int)segments.size();
+	// Workers take the next unrendered segment until there are none left.
+	std::atomic<unsigned int> nextSegment(0);
+	auto worker=[&]() {
+		for(unsigned int i=nextSegment++;i<segments.size();i=nextSegment++) {
+			renderSegment(sampleRate,flags,frames,segmentSeed(noiseSeed,i),segments[i]);
+		}
+	};
+	std::vector<std::thread> threads;
+	for(unsigned int t=1;t<numThreads;++t) threads.push_back(std::thread(worker));
+	worker();
+	for(size_t t=0;t<threads.size();++t) threads[t].join();
+	sampleCount=0;
+	for(size_t i=0;i<segments.size();++i) sampleCount+=(unsigned int)segments[i].samples.size();
+	sample* buffer=new sample[sampleCount?sampleCount:1];
+	unsigned int offset=0;
+	for(size_t i=0;i<segments.size();++i) {
+		for(size_t j=0;j<segments[i].samples.size();++j) buffer[offset++]=segments[i].samples[j];
+	}
+	return buffer;
+}
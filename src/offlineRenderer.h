@@ -0,0 +1,36 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#ifndef SPEECHPLAYER_OFFLINERENDERER_H
+#define SPEECHPLAYER_OFFLINERENDERER_H
+
+#include "speechPlayer.h"
+
+/**
+ * Renders a whole frame sequence to memory, splitting it after every NULL (silence) frame.
+ * Each segment starts from silence with its own FrameManager, generator and noise seed, exactly as a fresh player would,
+ * so the segments are independent and can be rendered on several threads at once.
+ * The result is the same whatever the number of threads.
+ */
+class OfflineRenderer {
+	public:
+	/**
+	 * @param noiseSeed segment i seeds its noise from noiseSeed and i.
+	 * @param numThreads 0 uses one thread per processor.
+	 * @return a buffer allocated with new[] holding sampleCount samples.
+	 */
+	static sample* render(int sampleRate, unsigned int flags, const speechPlayer_frameRequest_t* frames, unsigned int count, unsigned int noiseSeed, unsigned int numThreads, unsigned int& sampleCount);
+};
+
+#endif
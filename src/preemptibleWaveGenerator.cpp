@@ -0,0 +1,277 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <vector>
+#include "lock.h"
+#include "preemptibleWaveGenerator.h"
+
+// How far back a preempt can reach into audio the host has buffered but not played.
+const unsigned int historyMs=500;
+// Fade-in applied after a skip, while the restarted resonators settle.
+const unsigned int skipFadeInMs=5;
+
+// Speech saved by PreemptibleWaveGeneratorImpl::suspend: the samples still to be heard, then the frame queue and chain that follow them.
+struct suspendedSpeech_t: public WaveGeneratorState {
+	FrameManagerState* frameManagerState;
+	WaveGeneratorState* sourceState;
+	std::vector<sample> audio;
+	std::vector<indexMark_t> marks;
+	// Index reported while the saved audio plays.
+	int audioIndex;
+
+	~suspendedSpeech_t() {
+		delete frameManagerState;
+		delete sourceState;
+	}
+};
+
+class PreemptibleWaveGeneratorImpl: public PreemptibleWaveGenerator {
+	private:
+	WaveGenerator* source;
+	FrameManager* frameManager;
+	LockableObject generatorLock;
+	// Ring of the most recently handed out samples; historyFilled of them are valid, ending just before historyPos.
+	std::vector<sample> history;
+	unsigned int historyPos;
+	unsigned int historyFilled;
+	// Faded-out tail of preempted speech, handed out before anything else.
+	std::vector<sample> ramp;
+	unsigned int rampPos;
+	unsigned int fadeInLength;
+	unsigned int fadeInPos;
+	// Pre-rendered speech handed out after the ramp and before the live chain, with the userIndex values it passes.
+	std::vector<sample> audio;
+	unsigned int audioPos;
+	std::vector<indexMark_t> marks;
+	unsigned int markPos;
+	// While audioIndexActive, getLastIndex reports audioIndex until the frame manager reaches a newer index than frameIndexAtAudio.
+	bool audioIndexActive;
+	int audioIndex;
+	int frameIndexAtAudio;
+
+	static double fadeGain(unsigned int pos, unsigned int length) {
+		return 0.5*(1.0-cos(M_PI*(pos+1)/(length+1)));
+	}
+
+	void remember(const sample* buf, unsigned int count) {
+		unsigned int size=(unsigned int)history.size();
+		for(unsigned int i=0;i<count;++i) {
+			history[historyPos]=buf[i];
+			historyPos=(historyPos+1)%size;
+		}
+		historyFilled=(historyFilled+count<size)?historyFilled+count:size;
+	}
+
+	// Speech following the ramp: pre-rendered audio first, then the live chain.
+	unsigned int generateSpeech(unsigned int sampleCount, sample* sampleBuf) {
+		unsigned int produced=0;
+		while(produced<sampleCount&&audioPos<audio.size()) {
+			sampleBuf[produced++]=audio[audioPos++];
+		}
+		for(;markPos<marks.size()&&marks[markPos].offset<=audioPos;++markPos) {
+			audioIndex=marks[markPos].userIndex;
+		}
+		if(produced<sampleCount) {
+			unsigned int start=produced;
+			produced+=source->generate(sampleCount-produced,sampleBuf+produced);
+			for(unsigned int i=start;i<produced&&fadeInPos<fadeInLength;++i,++fadeInPos) {
+				sampleBuf[i].value=(sampleVal)floor(sampleBuf[i].value*fadeGain(fadeInPos,fadeInLength)+0.5);
+			}
+		}
+		return produced;
+	}
+
+	void clearAudio() {
+		audio.clear();
+		audioPos=0;
+		marks.clear();
+		markPos=0;
+		audioIndexActive=false;
+	}
+
+	// Fades out the old speech, starting at the first sample the host drops, and clears the frame queue.
+	unsigned int fadeOut(unsigned int unplayedSamples, unsigned int rampSamples) {
+		unsigned int dropped=(unplayedSamples<historyFilled)?unplayedSamples:historyFilled;
+		// The old speech continues for the length of the ramp, picking up at the first sample the host drops:
+		// first from the history, then from a ramp that was not fully handed out yet, then from the live chain.
+		std::vector<sample> tail;
+		unsigned int size=(unsigned int)history.size();
+		unsigned int start=(historyPos+size-dropped)%size;
+		for(unsigned int i=0;i<dropped&&tail.size()<rampSamples;++i) {
+			tail.push_back(history[(start+i)%size]);
+		}
+		while(rampPos<ramp.size()&&tail.size()<rampSamples) {
+			tail.push_back(ramp[rampPos++]);
+		}
+		if(tail.size()<rampSamples) {
+			unsigned int oldSize=(unsigned int)tail.size();
+			tail.resize(rampSamples);
+			tail.resize(oldSize+generateSpeech(rampSamples-oldSize,&tail[oldSize]));
+		}
+		// Raised cosine fade, reaching zero just after the last sample.
+		unsigned int n=(unsigned int)tail.size();
+		for(unsigned int i=0;i<n;++i) {
+			tail[i].value=(sampleVal)floor(tail[i].value*fadeGain(n-1-i,n)+0.5);
+		}
+		ramp.swap(tail);
+		rampPos=0;
+		historyPos=(historyPos+size-dropped)%size;
+		historyFilled-=dropped;
+		clearAudio();
+		frameManager->reset();
+		source->reset();
+		fadeInPos=fadeInLength;
+		return dropped;
+	}
+
+	public:
+	PreemptibleWaveGeneratorImpl(WaveGenerator* source, FrameManager* frameManager, int sampleRate): source(source), frameManager(frameManager), history((sampleRate*historyMs)/1000+1), historyPos(0), historyFilled(0), rampPos(0), fadeInLength((sampleRate*skipFadeInMs)/1000), fadeInPos(fadeInLength), audioPos(0), markPos(0), audioIndexActive(false), audioIndex(-1), frameIndexAtAudio(-1) {
+	}
+
+	unsigned int generate(const unsigned int sampleCount, sample* sampleBuf) {
+		generatorLock.acquire();
+		unsigned int produced=0;
+		while(produced<sampleCount&&rampPos<ramp.size()) {
+			sampleBuf[produced++]=ramp[rampPos++];
+		}
+		if(produced<sampleCount) {
+			produced+=generateSpeech(sampleCount-produced,sampleBuf+produced);
+		}
+		remember(sampleBuf,produced);
+		generatorLock.release();
+		return produced;
+	}
+
+	void reset() {
+		generatorLock.acquire();
+		ramp.clear();
+		rampPos=0;
+		clearAudio();
+		fadeInPos=fadeInLength;
+		historyFilled=0;
+		source->reset();
+		generatorLock.release();
+	}
+
+	void skip(unsigned int numSamples) {
+		generatorLock.acquire();
+		ramp.clear();
+		rampPos=0;
+		clearAudio();
+		historyFilled=0;
+		frameManager->skip(numSamples);
+		source->reset();
+		fadeInPos=0;
+		generatorLock.release();
+	}
+
+	unsigned int preempt(const speechPlayer_frameRequest_t* frames, unsigned int count, unsigned int unplayedSamples, unsigned int rampSamples) {
+		generatorLock.acquire();
+		unsigned int dropped=fadeOut(unplayedSamples,rampSamples);
+		// Nothing can render while the lock is held, so the new frames take over in one step.
+		for(unsigned int i=0;i<count;++i) {
+			frameManager->queueFrame(frames[i].frame,frames[i].minFrameDuration,frames[i].fadeDuration,frames[i].userIndex,false);
+		}
+		generatorLock.release();
+		return dropped;
+	}
+
+	unsigned int preemptWithAudio(std::vector<sample>& audio, std::vector<indexMark_t>& marks, unsigned int unplayedSamples, unsigned int rampSamples) {
+		generatorLock.acquire();
+		unsigned int dropped=fadeOut(unplayedSamples,rampSamples);
+		this->audio.swap(audio);
+		this->marks.swap(marks);
+		audio.clear();
+		marks.clear();
+		audioIndexActive=true;
+		audioIndex=frameIndexAtAudio=frameManager->getLastIndex();
+		generatorLock.release();
+		return dropped;
+	}
+
+	WaveGeneratorState* suspend(unsigned int unplayedSamples) {
+		suspendedSpeech_t* state=new suspendedSpeech_t;
+		generatorLock.acquire();
+		unsigned int kept=(unplayedSamples<historyFilled)?unplayedSamples:historyFilled;
+		unsigned int size=(unsigned int)history.size();
+		unsigned int start=(historyPos+size-kept)%size;
+		for(unsigned int i=0;i<kept;++i) {
+			state->audio.push_back(history[(start+i)%size]);
+		}
+		state->audio.insert(state->audio.end(),ramp.begin()+rampPos,ramp.end());
+		// Marks of pre-rendered audio not reached yet move along with the samples in front of them.
+		unsigned int audioOffset=(unsigned int)state->audio.size();
+		state->audio.insert(state->audio.end(),audio.begin()+audioPos,audio.end());
+		for(unsigned int i=markPos;i<marks.size();++i) {
+			indexMark_t mark={audioOffset+marks[i].offset-audioPos,marks[i].userIndex};
+			state->marks.push_back(mark);
+		}
+		state->audioIndex=audioIndexActive?audioIndex:frameManager->getLastIndex();
+		state->frameManagerState=frameManager->saveState();
+		state->sourceState=source->saveState();
+		generatorLock.release();
+		return state;
+	}
+
+	unsigned int resume(const WaveGeneratorState* savedState, unsigned int unplayedSamples, unsigned int rampSamples) {
+		const suspendedSpeech_t* state=static_cast<const suspendedSpeech_t*>(savedState);
+		generatorLock.acquire();
+		unsigned int dropped=fadeOut(unplayedSamples,rampSamples);
+		frameManager->restoreState(state->frameManagerState);
+		source->restoreState(state->sourceState);
+		audio=state->audio;
+		marks=state->marks;
+		audioIndexActive=true;
+		audioIndex=state->audioIndex;
+		frameIndexAtAudio=frameManager->getLastIndex();
+		// The speech picks up mid-waveform, so it fades in; whatever part of the fade the saved audio does not cover falls to the live chain.
+		unsigned int faded=0;
+		for(;faded<audio.size()&&faded<fadeInLength;++faded) {
+			audio[faded].value=(sampleVal)floor(audio[faded].value*fadeGain(faded,fadeInLength)+0.5);
+		}
+		fadeInPos=faded;
+		generatorLock.release();
+		return dropped;
+	}
+
+	WaveGeneratorState* saveState() {
+		return suspend(0);
+	}
+
+	void restoreState(const WaveGeneratorState* state) {
+		resume(state,0,0);
+	}
+
+	int getLastIndex() {
+		generatorLock.acquire();
+		int index=frameManager->getLastIndex();
+		if(audioIndexActive) {
+			if(audioPos>=audio.size()&&index!=frameIndexAtAudio) {
+				audioIndexActive=false;
+			} else {
+				index=audioIndex;
+			}
+		}
+		generatorLock.release();
+		return index;
+	}
+
+};
+
+PreemptibleWaveGenerator* PreemptibleWaveGenerator::create(WaveGenerator* source, FrameManager* frameManager, int sampleRate) {
+	return new PreemptibleWaveGeneratorImpl(source,frameManager,sampleRate);
+}
@@ -0,0 +1,70 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#ifndef SPEECHPLAYER_PREEMPTIBLEWAVEGENERATOR_H
+#define SPEECHPLAYER_PREEMPTIBLEWAVEGENERATOR_H
+
+#include <vector>
+#include "frame.h"
+#include "waveGenerator.h"
+
+// A userIndex reached offset samples into a block of pre-rendered audio.
+typedef struct {
+	unsigned int offset;
+	int userIndex;
+} indexMark_t;
+
+/**
+ * Last stage of the generator chain. Keeps a short history of the samples it has handed out,
+ * so speech can be replaced mid-utterance with a fade-out that starts exactly where the host's playback will stop.
+ */
+class PreemptibleWaveGenerator: public WaveGenerator {
+	public:
+	// The generator does not own source or frameManager.
+	static PreemptibleWaveGenerator* create(WaveGenerator* source, FrameManager* frameManager, int sampleRate);
+	/**
+	 * Replaces everything queued on the frame manager with frames (durations already at the synthesis rate),
+	 * and makes the next generate call start with a fade-out of the old speech over rampSamples.
+	 * unplayedSamples is how many samples the host has received but not yet played.
+	 * @return how many samples the host must discard from the end of what it holds; the fade-out continues from the last sample it keeps.
+	 */
+	virtual unsigned int preempt(const speechPlayer_frameRequest_t* frames, unsigned int count, unsigned int unplayedSamples, unsigned int rampSamples)=0;
+	/**
+	 * Drops numSamples (at the synthesis rate) from the front of the frame queue without rendering them.
+	 * The DSP restarts from silence and the following output fades in, so the jump does not click.
+	 */
+	virtual void skip(unsigned int numSamples)=0;
+	/**
+	 * Like preempt, but the new speech is audio already rendered at the output rate, which plays straight after the fade-out.
+	 * The frame queue is emptied, so frames queued afterwards follow the audio.
+	 * audio and marks are taken over by the generator and left empty.
+	 */
+	virtual unsigned int preemptWithAudio(std::vector<sample>& audio, std::vector<indexMark_t>& marks, unsigned int unplayedSamples, unsigned int rampSamples)=0;
+	/**
+	 * Saves the speech from the first of the host's unplayedSamples onwards, so it can be resumed after an interruption.
+	 * The state holds those samples (taken from the history), any fade-out or pre-rendered audio not handed out yet,
+	 * the frame manager and the state of the whole chain. Nothing changes; the host normally calls preempt next.
+	 */
+	virtual WaveGeneratorState* suspend(unsigned int unplayedSamples)=0;
+	/**
+	 * Replaces the current speech as preempt does, then continues the speech saved by suspend exactly where it left off,
+	 * fading it in over a few milliseconds. The state is not consumed and can be resumed again.
+	 * @return how many samples the host must discard from the end of what it holds.
+	 */
+	virtual unsigned int resume(const WaveGeneratorState* state, unsigned int unplayedSamples, unsigned int rampSamples)=0;
+	// The userIndex of the speech handed out last, whether it came from pre-rendered audio or from the frame manager.
+	virtual int getLastIndex()=0;
+};
+
+#endif
@@ -0,0 +1,189 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+/*
+ * _nvspNative: optional CPython extension for the hot paths of speechPlayer.py.
+ * Audio is rendered straight into Python buffers and frames are queued in batches, with the GIL released while the DSP or frontend runs.
+ * Player and frontend handles are the integers returned by the ctypes wrappers, so both bindings can be used on the same handle.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <vector>
+#include "speechPlayer.h"
+#include "nvspFrontend.h"
+
+// One entry of the timings buffer taken by queueFrames and returned by frontendQueueIPA.
+typedef struct {
+	unsigned int minFrameDuration; // samples
+	unsigned int fadeDuration; // samples
+	int userIndex;
+	unsigned int flags;
+} nvspNative_timing_t;
+
+// The entry is a silence: its frame is ignored and a NULL frame is queued.
+#define NVSPNATIVE_TIMING_SILENCE 0x1
+
+static_assert(sizeof(nvspFrontend_Frame)==sizeof(speechPlayer_frame_t),"frontend and DSP frame layouts differ");
+
+static void* handleFromObject(PyObject* obj) {
+	void* handle=PyLong_AsVoidPtr(obj);
+	if(!handle&&!PyErr_Occurred()) PyErr_SetString(PyExc_ValueError,"NULL handle");
+	return handle;
+}
+
+PyDoc_STRVAR(synthesize_doc,"synthesize(player, buffer) -> int\n\nRenders into a writable buffer of 16 bit samples and returns how many samples were written.");
+
+static PyObject* nvspNative_synthesize(PyObject* self, PyObject* args) {
+	PyObject* playerObj;
+	Py_buffer view;
+	if(!PyArg_ParseTuple(args,"Ow*:synthesize",&playerObj,&view)) return NULL;
+	void* player=handleFromObject(playerObj);
+	if(!player) {
+		PyBuffer_Release(&view);
+		return NULL;
+	}
+	unsigned int sampleCount=(unsigned int)(view.len/sizeof(sample));
+	int produced;
+	Py_BEGIN_ALLOW_THREADS
+	produced=speechPlayer_synthesize(player,sampleCount,(sample*)view.buf);
+	Py_END_ALLOW_THREADS
+	PyBuffer_Release(&view);
+	return PyLong_FromLong(produced);
+}
+
+PyDoc_STRVAR(synthesizeBytes_doc,"synthesizeBytes(player, maxSamples) -> bytes\n\nRenders up to maxSamples into a new bytes object, empty when there is nothing to play.");
+
+static PyObject* nvspNative_synthesizeBytes(PyObject* self, PyObject* args) {
+	PyObject* playerObj;
+	unsigned int maxSamples;
+	if(!PyArg_ParseTuple(args,"OI:synthesizeBytes",&playerObj,&maxSamples)) return NULL;
+	void* player=handleFromObject(playerObj);
+	if(!player) return NULL;
+	// The bytes object is not visible to any other code until it is returned, so it can be filled in place.
+	PyObject* result=PyBytes_FromStringAndSize(NULL,(Py_ssize_t)maxSamples*sizeof(sample));
+	if(!result) return NULL;
+	sample* buf=(sample*)PyBytes_AS_STRING(result);
+	int produced;
+	Py_BEGIN_ALLOW_THREADS
+	produced=speechPlayer_synthesize(player,maxSamples,buf);
+	Py_END_ALLOW_THREADS
+	if(produced<0) produced=0;
+	if((unsigned int)produced<maxSamples&&_PyBytes_Resize(&result,(Py_ssize_t)produced*sizeof(sample))<0) return NULL;
+	return result;
+}
+
+PyDoc_STRVAR(queueFrames_doc,"queueFrames(player, frames, timings, purgeQueue=False) -> int\n\n"
+"Queues a batch of frames. frames holds consecutive speechPlayer_frame_t structs, timings one nvspNative_timing_t\n"
+"(minFrameDuration and fadeDuration in samples, userIndex, flags) per frame. Returns the number of frames queued.");
+
+static PyObject* nvspNative_queueFrames(PyObject* self, PyObject* args) {
+	PyObject* playerObj;
+	Py_buffer frames;
+	Py_buffer timings;
+	int purgeQueue=0;
+	if(!PyArg_ParseTuple(args,"Oy*y*|p:queueFrames",&playerObj,&frames,&timings,&purgeQueue)) return NULL;
+	void* player=handleFromObject(playerObj);
+	Py_ssize_t count=timings.len/(Py_ssize_t)sizeof(nvspNative_timing_t);
+	if(player&&frames.len<count*(Py_ssize_t)sizeof(speechPlayer_frame_t)) {
+		PyErr_SetString(PyExc_ValueError,"frames buffer is shorter than timings");
+		player=NULL;
+	}
+	if(!player) {
+		PyBuffer_Release(&frames);
+		PyBuffer_Release(&timings);
+		return NULL;
+	}
+	Py_BEGIN_ALLOW_THREADS
+	const nvspNative_timing_t* timing=(const nvspNative_timing_t*)timings.buf;
+	speechPlayer_frame_t* frame=(speechPlayer_frame_t*)frames.buf;
+	for(Py_ssize_t i=0;i<count;++i) {
+		speechPlayer_frame_t* framePtr=(timing[i].flags&NVSPNATIVE_TIMING_SILENCE)?NULL:&frame[i];
+		speechPlayer_queueFrame(player,framePtr,timing[i].minFrameDuration,timing[i].fadeDuration,timing[i].userIndex,purgeQueue&&i==0);
+	}
+	Py_END_ALLOW_THREADS
+	PyBuffer_Release(&frames);
+	PyBuffer_Release(&timings);
+	return PyLong_FromSsize_t(count);
+}
+
+// Collects the frontend's output in the layout queueFrames takes.
+struct frameBatch_t {
+	int sampleRate;
+	std::vector<nvspFrontend_Frame> frames;
+	std::vector<nvspNative_timing_t> timings;
+};
+
+static void collectFrame(void* userData, const nvspFrontend_Frame* frameOrNull, double durationMs, double fadeMs, int userIndex) {
+	frameBatch_t* batch=(frameBatch_t*)userData;
+	nvspNative_timing_t timing;
+	timing.minFrameDuration=(durationMs>0)?(unsigned int)(durationMs*batch->sampleRate/1000.0):0;
+	timing.fadeDuration=(fadeMs>0)?(unsigned int)(fadeMs*batch->sampleRate/1000.0):0;
+	timing.userIndex=userIndex;
+	timing.flags=frameOrNull?0:NVSPNATIVE_TIMING_SILENCE;
+	nvspFrontend_Frame frame={};
+	if(frameOrNull) frame=*frameOrNull;
+	batch->frames.push_back(frame);
+	batch->timings.push_back(timing);
+}
+
+PyDoc_STRVAR(frontendQueueIPA_doc,"frontendQueueIPA(frontend, ipa, speed, basePitch, inflection, clauseType, userIndexBase, sampleRate) -> (frames, timings) or None\n\n"
+"Converts IPA to frames without a Python callback per frame. The result is two bytes objects in the layout queueFrames takes,\n"
+"with durations converted to samples at sampleRate. Returns None on failure (see nvspFrontend_getLastError).");
+
+static PyObject* nvspNative_frontendQueueIPA(PyObject* self, PyObject* args) {
+	PyObject* frontendObj;
+	const char* ipa;
+	double speed, basePitch, inflection;
+	const char* clauseType;
+	int userIndexBase, sampleRate;
+	if(!PyArg_ParseTuple(args,"Osdddzii:frontendQueueIPA",&frontendObj,&ipa,&speed,&basePitch,&inflection,&clauseType,&userIndexBase,&sampleRate)) return NULL;
+	void* frontend=handleFromObject(frontendObj);
+	if(!frontend) return NULL;
+	frameBatch_t batch;
+	batch.sampleRate=sampleRate;
+	int ok;
+	Py_BEGIN_ALLOW_THREADS
+	ok=nvspFrontend_queueIPA(frontend,ipa,speed,basePitch,inflection,clauseType,userIndexBase,collectFrame,&batch);
+	Py_END_ALLOW_THREADS
+	if(!ok) Py_RETURN_NONE;
+	return Py_BuildValue("(y#y#)",
+		batch.frames.empty()?"":(const char*)batch.frames.data(),(Py_ssize_t)(batch.frames.size()*sizeof(nvspFrontend_Frame)),
+		batch.timings.empty()?"":(const char*)batch.timings.data(),(Py_ssize_t)(batch.timings.size()*sizeof(nvspNative_timing_t)));
+}
+
+static PyMethodDef nvspNative_methods[]={
+	{"synthesize",nvspNative_synthesize,METH_VARARGS,synthesize_doc},
+	{"synthesizeBytes",nvspNative_synthesizeBytes,METH_VARARGS,synthesizeBytes_doc},
+	{"queueFrames",nvspNative_queueFrames,METH_VARARGS,queueFrames_doc},
+	{"frontendQueueIPA",nvspNative_frontendQueueIPA,METH_VARARGS,frontendQueueIPA_doc},
+	{NULL,NULL,0,NULL}
+};
+
+static struct PyModuleDef nvspNative_module={
+	PyModuleDef_HEAD_INIT,
+	"_nvspNative",
+	"Buffer-protocol and batched bindings for speechPlayer and nvspFrontend.",
+	-1,
+	nvspNative_methods
+};
+
+PyMODINIT_FUNC PyInit__nvspNative(void) {
+	PyObject* module=PyModule_Create(&nvspNative_module);
+	if(!module) return NULL;
+	PyModule_AddIntConstant(module,"TIMING_SIZE",(long)sizeof(nvspNative_timing_t));
+	PyModule_AddIntConstant(module,"FRAME_SIZE",(long)sizeof(speechPlayer_frame_t));
+	PyModule_AddIntConstant(module,"TIMING_SILENCE",NVSPNATIVE_TIMING_SILENCE);
+	return module;
+}
@@ -0,0 +1,240 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <vector>
+#include "resamplingWaveGenerator.h"
+
+// Rational ratios are reduced to upFactor/downFactor; beyond this many branches the coefficient table gets too large.
+const int maxPolyphaseBranches=1024;
+// Taps per branch when upsampling; a multiple of accumulatorLanes.
+const int baseTapsPerBranch=32;
+const int accumulatorLanes=8;
+const double kaiserBeta=8.0;
+// Passband edge as a fraction of the lower of the two Nyquist frequencies.
+const double passbandFraction=0.92;
+const unsigned int inputBufferSize=512;
+
+static int greatestCommonDivisor(int a, int b) {
+	while(b) {
+		int t=a%b;
+		a=b;
+		b=t;
+	}
+	return a;
+}
+
+// Zeroth order modified Bessel function of the first kind, for the Kaiser window.
+static double besselI0(double x) {
+	double sum=1.0, term=1.0;
+	for(int k=1;k<50;++k) {
+		term*=(x/(2*k))*(x/(2*k));
+		sum+=term;
+		if(term<sum*1e-12) break;
+	}
+	return sum;
+}
+
+// Filter history and input position of a ResamplingWaveGeneratorImpl; the filter taps are fixed at creation and not saved.
+struct resamplerState_t: public WaveGeneratorState {
+	WaveGeneratorState* sourceState;
+	std::vector<float> history;
+	int historyPos;
+	int phase;
+	int inputNeeded;
+	sample inputBuf[inputBufferSize];
+	unsigned int inputPos;
+	unsigned int inputCount;
+	bool hasTail;
+	int flushRemaining;
+
+	~resamplerState_t() {
+		delete sourceState;
+	}
+};
+
+class ResamplingWaveGeneratorImpl: public ResamplingWaveGenerator {
+	private:
+	WaveGenerator* source;
+	int upFactor;
+	int downFactor;
+	int tapsPerBranch;
+	// Branch p holds its taps reversed, so they line up with the history window (oldest sample first).
+	std::vector<float> coefficients;
+	// Each input sample is written twice, so the last tapsPerBranch samples are always contiguous at history[historyPos].
+	std::vector<float> history;
+	int historyPos;
+	int phase;
+	int inputNeeded;
+	sample inputBuf[inputBufferSize];
+	unsigned int inputPos;
+	unsigned int inputCount;
+	bool hasTail;
+	int flushRemaining;
+
+	void designFilter() {
+		int length=tapsPerBranch*upFactor;
+		double cutoff=passbandFraction*((upFactor<downFactor)?((double)upFactor/downFactor):1.0);
+		double center=(length-1)/2.0;
+		double windowNorm=besselI0(kaiserBeta);
+		coefficients.assign(length,0.0f);
+		for(int p=0;p<upFactor;++p) {
+			double sum=0;
+			std::vector<double> taps(tapsPerBranch);
+			for(int k=0;k<tapsPerBranch;++k) {
+				int i=p+k*upFactor;
+				// Distance from the filter center in input samples.
+				double x=(i-center)/upFactor;
+				double sinc=(x==0)?1.0:sin(M_PI*cutoff*x)/(M_PI*cutoff*x);
+				double w=(i-center)/center;
+				double windowArg=1.0-w*w;
+				double window=besselI0(kaiserBeta*sqrt((windowArg>0)?windowArg:0.0))/windowNorm;
+				taps[k]=cutoff*sinc*window;
+				sum+=taps[k];
+			}
+			// Normalize every branch to unity DC gain so there is no ripple at the output rate.
+			for(int k=0;k<tapsPerBranch;++k) {
+				coefficients[p*tapsPerBranch+(tapsPerBranch-1-k)]=(float)(taps[k]/sum);
+			}
+		}
+	}
+
+	void pushInput(float value) {
+		history[historyPos]=value;
+		history[historyPos+tapsPerBranch]=value;
+		historyPos=(historyPos+1)%tapsPerBranch;
+	}
+
+	float filter() {
+		const float* taps=&coefficients[phase*tapsPerBranch];
+		const float* window=&history[historyPos];
+		float acc[accumulatorLanes]={0};
+		for(int k=0;k<tapsPerBranch;k+=accumulatorLanes) {
+			for(int j=0;j<accumulatorLanes;++j) {
+				acc[j]+=taps[k+j]*window[k+j];
+			}
+		}
+		float out=0;
+		for(int j=0;j<accumulatorLanes;++j) out+=acc[j];
+		return out;
+	}
+
+	// Fetches the next input sample. Returns false when the source has ended and the filter tail has been flushed.
+	bool nextInput(unsigned int outputsWanted, float& value) {
+		while(true) {
+			if(inputPos<inputCount) {
+				value=inputBuf[inputPos++].value;
+				return true;
+			}
+			if(flushRemaining>0) {
+				--flushRemaining;
+				value=0;
+				return true;
+			}
+			// Only pull as much as the remaining output needs, so the frame queue is not drained ahead of the audio.
+			unsigned int want=(unsigned int)(((unsigned long long)outputsWanted*downFactor)/upFactor)+1;
+			if(want>inputBufferSize) want=inputBufferSize;
+			inputPos=0;
+			inputCount=source->generate(want,inputBuf);
+			if(inputCount>0) hasTail=true;
+			if(inputCount<want&&hasTail) {
+				flushRemaining=tapsPerBranch;
+				hasTail=false;
+			}
+			if(inputCount==0&&flushRemaining==0) return false;
+		}
+	}
+
+	public:
+	ResamplingWaveGeneratorImpl(WaveGenerator* source, int upFactor, int downFactor): source(source), upFactor(upFactor), downFactor(downFactor), historyPos(0), phase(0), inputNeeded(1), inputPos(0), inputCount(0), hasTail(false), flushRemaining(0) {
+		// When decimating the passband shrinks, so the filter needs proportionally more taps.
+		int scale=(downFactor+upFactor-1)/upFactor;
+		tapsPerBranch=baseTapsPerBranch*scale;
+		history.assign(tapsPerBranch*2,0.0f);
+		designFilter();
+	}
+
+	void reset() {
+		history.assign(tapsPerBranch*2,0.0f);
+		historyPos=0;
+		phase=0;
+		inputNeeded=1;
+		inputPos=0;
+		inputCount=0;
+		hasTail=false;
+		flushRemaining=0;
+		source->reset();
+	}
+
+	WaveGeneratorState* saveState() {
+		resamplerState_t* state=new resamplerState_t;
+		state->sourceState=source->saveState();
+		state->history=history;
+		state->historyPos=historyPos;
+		state->phase=phase;
+		state->inputNeeded=inputNeeded;
+		for(unsigned int i=inputPos;i<inputCount;++i) state->inputBuf[i]=inputBuf[i];
+		state->inputPos=inputPos;
+		state->inputCount=inputCount;
+		state->hasTail=hasTail;
+		state->flushRemaining=flushRemaining;
+		return state;
+	}
+
+	void restoreState(const WaveGeneratorState* savedState) {
+		const resamplerState_t* state=static_cast<const resamplerState_t*>(savedState);
+		source->restoreState(state->sourceState);
+		history=state->history;
+		historyPos=state->historyPos;
+		phase=state->phase;
+		inputNeeded=state->inputNeeded;
+		for(unsigned int i=state->inputPos;i<state->inputCount;++i) inputBuf[i]=state->inputBuf[i];
+		inputPos=state->inputPos;
+		inputCount=state->inputCount;
+		hasTail=state->hasTail;
+		flushRemaining=state->flushRemaining;
+	}
+
+	unsigned int generate(const unsigned int sampleCount, sample* sampleBuf) {
+		unsigned int produced=0;
+		while(produced<sampleCount) {
+			while(inputNeeded>0) {
+				float value;
+				if(!nextInput(sampleCount-produced,value)) return produced;
+				pushInput(value);
+				--inputNeeded;
+			}
+			float out=floor(filter()+0.5f);
+			sampleBuf[produced++].value=(sampleVal)((out>32767.0f)?32767.0f:((out<-32768.0f)?-32768.0f:out));
+			phase+=downFactor;
+			inputNeeded=phase/upFactor;
+			phase%=upFactor;
+		}
+		return produced;
+	}
+
+};
+
+bool ResamplingWaveGenerator::isSupported(int inputRate, int outputRate) {
+	if(inputRate<=0||outputRate<=0) return false;
+	return outputRate/greatestCommonDivisor(inputRate,outputRate)<=maxPolyphaseBranches;
+}
+
+ResamplingWaveGenerator* ResamplingWaveGenerator::create(WaveGenerator* source, int inputRate, int outputRate) {
+	if(!source||!isSupported(inputRate,outputRate)) return NULL;
+	int divisor=greatestCommonDivisor(inputRate,outputRate);
+	return new ResamplingWaveGeneratorImpl(source,outputRate/divisor,inputRate/divisor);
+}
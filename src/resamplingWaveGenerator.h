@@ -0,0 +1,36 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#ifndef SPEECHPLAYER_RESAMPLINGWAVEGENERATOR_H
+#define SPEECHPLAYER_RESAMPLINGWAVEGENERATOR_H
+
+#include "waveGenerator.h"
+
+/**
+ * Wraps a WaveGenerator running at inputRate and converts its output to outputRate
+ * with a Kaiser windowed sinc polyphase filter.
+ * When the source runs out of frames, the filter tail is flushed before the shortened count is returned,
+ * so the end of an utterance is not cut off.
+ */
+class ResamplingWaveGenerator: public WaveGenerator {
+	public:
+	/**
+	 * @return a new resampler, or NULL if the rate ratio reduces to more polyphase branches than supported.
+	 * The resampler does not own source.
+	 */
+	static ResamplingWaveGenerator* create(WaveGenerator* source, int inputRate, int outputRate);
+	static bool isSupported(int inputRate, int outputRate);
+};
+
+#endif
@@ -0,0 +1,190 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "speechWaveGenerator.h"
+#include "timeCompressingWaveGenerator.h"
+#include "resamplingWaveGenerator.h"
+#include "speculativeRenderer.h"
+
+// Small chunks keep index marks accurate and let a cancelled speculation stop quickly.
+const unsigned int speculationChunkSize=256;
+const unsigned int defaultMaxSpeculations=4;
+const unsigned int defaultMaxSeconds=30;
+
+class SpeculativeRendererImpl: public SpeculativeRenderer {
+	private:
+	int outputRate;
+	int internalRate;
+	unsigned int flags;
+	std::mutex speculationMutex;
+	std::condition_variable workAvailable;
+	std::map<unsigned int,std::shared_ptr<Speculation>> speculations;
+	// Tickets waiting for the worker, oldest first. Tickets taken before the worker reaches them are skipped.
+	std::deque<unsigned int> pending;
+	unsigned int nextTicket;
+	unsigned int maxSpeculations;
+	unsigned int maxSamples;
+	// Samples held by complete speculations plus those rendered so far for the current one.
+	unsigned int heldSamples;
+	// Ticket the worker is rendering, 0 when idle; the worker abandons it as soon as it no longer matches.
+	unsigned int renderingTicket;
+	bool stopping;
+	std::thread worker;
+
+	void run() {
+		SetThreadPriority(GetCurrentThread(),THREAD_PRIORITY_LOWEST);
+		std::unique_lock<std::mutex> lock(speculationMutex);
+		for(;;) {
+			while(!stopping&&pending.empty()) workAvailable.wait(lock);
+			if(stopping) return;
+			unsigned int ticket=pending.front();
+			pending.pop_front();
+			auto i=speculations.find(ticket);
+			if(i==speculations.end()) continue;
+			std::shared_ptr<Speculation> speculation=i->second;
+			renderingTicket=ticket;
+			lock.unlock();
+			render(ticket,*speculation);
+			lock.lock();
+			renderingTicket=0;
+		}
+	}
+
+	// Renders a speculation with a private chain. Called on the worker thread without the lock held.
+	void render(unsigned int ticket, Speculation& speculation) {
+		FrameManager* frameManager=FrameManager::create(internalRate);
+		frameManager->setRate(speculation.rate);
+		SpeechWaveGenerator* waveGenerator=SpeechWaveGenerator::create(internalRate,flags);
+		waveGenerator->setFrameManager(frameManager);
+		TimeCompressingWaveGenerator* timeCompressor=TimeCompressingWaveGenerator::create(waveGenerator,internalRate);
+		timeCompressor->setFactor(speculation.timeCompression);
+		ResamplingWaveGenerator* resampler=NULL;
+		WaveGenerator* outputGenerator=timeCompressor;
+		if(internalRate!=outputRate) {
+			resampler=ResamplingWaveGenerator::create(timeCompressor,internalRate,outputRate);
+			outputGenerator=resampler;
+		}
+		for(size_t i=0;i<speculation.requests.size();++i) {
+			const speechPlayer_frameRequest_t& request=speculation.requests[i];
+			frameManager->queueFrame(request.frame,request.minFrameDuration,request.fadeDuration,request.userIndex,false);
+		}
+		std::vector<sample> audio;
+		std::vector<indexMark_t> marks;
+		int lastIndex=frameManager->getLastIndex();
+		bool abandoned=false;
+		unsigned int produced;
+		do {
+			size_t oldSize=audio.size();
+			audio.resize(oldSize+speculationChunkSize);
+			produced=outputGenerator->generate(speculationChunkSize,&audio[oldSize]);
+			audio.resize(oldSize+produced);
+			if(frameManager->getLastIndex()!=lastIndex) {
+				lastIndex=frameManager->getLastIndex();
+				indexMark_t mark={(unsigned int)oldSize,lastIndex};
+				marks.push_back(mark);
+			}
+			std::lock_guard<std::mutex> lock(speculationMutex);
+			if(stopping||renderingTicket!=ticket||speculations.count(ticket)==0||heldSamples+audio.size()>maxSamples) {
+				abandoned=true;
+				break;
+			}
+		} while(produced==speculationChunkSize);
+		delete resampler;
+		delete timeCompressor;
+		delete waveGenerator;
+		delete frameManager;
+		if(abandoned) return;
+		std::lock_guard<std::mutex> lock(speculationMutex);
+		if(speculations.count(ticket)==0) return;
+		speculation.audio.swap(audio);
+		speculation.marks.swap(marks);
+		speculation.complete=true;
+		heldSamples+=(unsigned int)speculation.audio.size();
+	}
+
+	void release(const Speculation& speculation) {
+		if(speculation.complete) heldSamples-=(unsigned int)speculation.audio.size();
+	}
+
+	public:
+	SpeculativeRendererImpl(int outputRate, int internalRate, unsigned int flags): outputRate(outputRate), internalRate(internalRate), flags(flags), nextTicket(1), maxSpeculations(defaultMaxSpeculations), maxSamples(outputRate*defaultMaxSeconds), heldSamples(0), renderingTicket(0), stopping(false) {
+	}
+
+	~SpeculativeRendererImpl() {
+		{
+			std::lock_guard<std::mutex> lock(speculationMutex);
+			stopping=true;
+		}
+		workAvailable.notify_all();
+		if(worker.joinable()) worker.join();
+	}
+
+	unsigned int prepare(const speechPlayer_frameRequest_t* frames, unsigned int count, double rate, double timeCompression) {
+		std::shared_ptr<Speculation> speculation(new Speculation);
+		speculation->frameData.resize(count);
+		speculation->requests.resize(count);
+		for(unsigned int i=0;i<count;++i) {
+			speculation->requests[i]=frames[i];
+			if(frames[i].frame) {
+				speculation->frameData[i]=*(frames[i].frame);
+				speculation->requests[i].frame=&(speculation->frameData[i]);
+			}
+		}
+		speculation->rate=rate;
+		speculation->timeCompression=timeCompression;
+		speculation->complete=false;
+		std::lock_guard<std::mutex> lock(speculationMutex);
+		if(speculations.size()>=maxSpeculations) return 0;
+		unsigned int ticket=nextTicket++;
+		if(nextTicket==0) nextTicket=1;
+		speculations[ticket]=speculation;
+		pending.push_back(ticket);
+		if(!worker.joinable()) worker=std::thread(&SpeculativeRendererImpl::run,this);
+		workAvailable.notify_one();
+		return ticket;
+	}
+
+	std::shared_ptr<Speculation> take(unsigned int ticket) {
+		std::lock_guard<std::mutex> lock(speculationMutex);
+		auto i=speculations.find(ticket);
+		if(i==speculations.end()) return NULL;
+		std::shared_ptr<Speculation> speculation=i->second;
+		speculations.erase(i);
+		release(*speculation);
+		return speculation;
+	}
+
+	void clear() {
+		std::lock_guard<std::mutex> lock(speculationMutex);
+		speculations.clear();
+		pending.clear();
+		heldSamples=0;
+	}
+
+	void setLimits(unsigned int maxSpeculations, unsigned int maxSamples) {
+		std::lock_guard<std::mutex> lock(speculationMutex);
+		this->maxSpeculations=maxSpeculations;
+		this->maxSamples=maxSamples;
+	}
+
+};
+
+SpeculativeRenderer* SpeculativeRenderer::create(int outputRate, int internalRate, unsigned int flags) {
+	return new SpeculativeRendererImpl(outputRate,internalRate,flags);
+}
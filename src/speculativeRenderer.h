@@ -0,0 +1,64 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#ifndef SPEECHPLAYER_SPECULATIVERENDERER_H
+#define SPEECHPLAYER_SPECULATIVERENDERER_H
+
+#include <memory>
+#include <vector>
+#include "frame.h"
+#include "preemptibleWaveGenerator.h"
+
+/**
+ * An utterance handed to SpeculativeRenderer::prepare, with the audio rendered for it so far.
+ * The frames are copies owned by the speculation, with durations at the synthesis rate.
+ */
+struct Speculation {
+	std::vector<speechPlayer_frame_t> frameData;
+	std::vector<speechPlayer_frameRequest_t> requests;
+	// The speaking rate and time compression the audio was rendered with.
+	double rate;
+	double timeCompression;
+	// Valid once complete is set; audio is at the output rate.
+	bool complete;
+	std::vector<sample> audio;
+	std::vector<indexMark_t> marks;
+};
+
+/**
+ * Renders utterances the host expects to speak next on a low priority background thread, so they can start without synthesis latency.
+ * Each utterance gets a ticket. Rendering uses the same chain as the player (synthesis, time compression, resampling) but its own generator state,
+ * so the live player is not disturbed. Speculations that are not complete when they are taken are abandoned, and the host falls back to their frames.
+ */
+class SpeculativeRenderer {
+	public:
+	static SpeculativeRenderer* create(int outputRate, int internalRate, unsigned int flags);
+	/**
+	 * Copies count frames (durations at the synthesis rate) and queues them for rendering.
+	 * @return a ticket greater than 0, or 0 if the maximum number of speculations are already held.
+	 */
+	virtual unsigned int prepare(const speechPlayer_frameRequest_t* frames, unsigned int count, double rate, double timeCompression)=0;
+	// Removes a speculation and stops rendering it. Returns NULL for an unknown ticket.
+	virtual std::shared_ptr<Speculation> take(unsigned int ticket)=0;
+	// Drops every speculation.
+	virtual void clear()=0;
+	/**
+	 * maxSpeculations bounds the number of tickets held at once; maxSamples bounds the audio they hold together.
+	 * A speculation that would go over maxSamples stops rendering and is played from its frames when committed.
+	 */
+	virtual void setLimits(unsigned int maxSpeculations, unsigned int maxSamples)=0;
+	virtual ~SpeculativeRenderer() {};
+};
+
+#endif
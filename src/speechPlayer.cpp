@@ -14,41 +14,237 @@ http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
 
 #include "frame.h"
 #include "speechWaveGenerator.h"
+#include "multiVoiceWaveGenerator.h"
+#include "resamplingWaveGenerator.h"
+#include "timeCompressingWaveGenerator.h"
+#include "preemptibleWaveGenerator.h"
+#include "speculativeRenderer.h"
+#include "offlineRenderer.h"
 #include "speechPlayer.h"
 
 typedef struct {
 	int sampleRate;
+	int internalRate;
+	double rate;
+	double timeCompression;
 	FrameManager* frameManager;
 	SpeechWaveGenerator* waveGenerator;
+	TimeCompressingWaveGenerator* timeCompressor;
+	ResamplingWaveGenerator* resampler;
+	PreemptibleWaveGenerator* preempter;
+	WaveGenerator* outputGenerator; // last stage of the generator chain
+	SpeculativeRenderer* speculator;
 } speechPlayer_handleInfo_t;
 
 speechPlayer_handle_t speechPlayer_initialize(int sampleRate) {
+	return speechPlayer_initializeEx(sampleRate,0);
+}
+
+speechPlayer_handle_t speechPlayer_initializeEx(int sampleRate, unsigned int flags) {
+	return speechPlayer_initializeResampled(sampleRate,sampleRate,flags);
+}
+
+speechPlayer_handle_t speechPlayer_initializeResampled(int outputRate, int internalRate, unsigned int flags) {
+	if(internalRate<=0) internalRate=outputRate;
+	// If the resampler can't handle the ratio, synthesize at the output rate instead.
+	if(internalRate!=outputRate&&!ResamplingWaveGenerator::isSupported(internalRate,outputRate)) internalRate=outputRate;
 	speechPlayer_handleInfo_t* playerHandleInfo=new speechPlayer_handleInfo_t;
-	playerHandleInfo->sampleRate=sampleRate;
-	playerHandleInfo->frameManager=FrameManager::create();
-	playerHandleInfo->waveGenerator=SpeechWaveGenerator::create(sampleRate);
+	playerHandleInfo->sampleRate=outputRate;
+	playerHandleInfo->internalRate=internalRate;
+	playerHandleInfo->rate=1.0;
+	playerHandleInfo->timeCompression=1.0;
+	playerHandleInfo->frameManager=FrameManager::create(internalRate);
+	playerHandleInfo->waveGenerator=SpeechWaveGenerator::create(internalRate,flags);
 	playerHandleInfo->waveGenerator->setFrameManager(playerHandleInfo->frameManager);
+	playerHandleInfo->timeCompressor=TimeCompressingWaveGenerator::create(playerHandleInfo->waveGenerator,internalRate);
+	playerHandleInfo->resampler=NULL;
+	playerHandleInfo->outputGenerator=playerHandleInfo->timeCompressor;
+	if(internalRate!=outputRate) {
+		playerHandleInfo->resampler=ResamplingWaveGenerator::create(playerHandleInfo->timeCompressor,internalRate,outputRate);
+		playerHandleInfo->outputGenerator=playerHandleInfo->resampler;
+	}
+	playerHandleInfo->preempter=PreemptibleWaveGenerator::create(playerHandleInfo->outputGenerator,playerHandleInfo->frameManager,outputRate);
+	playerHandleInfo->outputGenerator=playerHandleInfo->preempter;
+	playerHandleInfo->speculator=SpeculativeRenderer::create(outputRate,internalRate,flags);
 	return (speechPlayer_handle_t)playerHandleInfo;
 }
 
+// Converts a duration given in output samples to samples at the synthesis rate.
+static unsigned int toInternalSamples(speechPlayer_handleInfo_t* playerHandleInfo, unsigned int numSamples) {
+	if(playerHandleInfo->internalRate==playerHandleInfo->sampleRate) return numSamples;
+	return (unsigned int)(((unsigned long long)numSamples*playerHandleInfo->internalRate)/playerHandleInfo->sampleRate);
+}
+
 void speechPlayer_queueFrame(speechPlayer_handle_t playerHandle, speechPlayer_frame_t* framePtr, unsigned int minFrameDuration, unsigned int fadeDuration, int userIndex, bool purgeQueue) { 
 	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	minFrameDuration=toInternalSamples(playerHandleInfo,minFrameDuration);
+	fadeDuration=toInternalSamples(playerHandleInfo,fadeDuration);
 	playerHandleInfo->frameManager->queueFrame(framePtr,minFrameDuration,max(fadeDuration,1),userIndex,purgeQueue);
 }
 
 int speechPlayer_synthesize(speechPlayer_handle_t playerHandle, unsigned int sampleCount, sample* sampleBuf) {
-	return ((speechPlayer_handleInfo_t*)playerHandle)->waveGenerator->generate(sampleCount,sampleBuf);
+	return ((speechPlayer_handleInfo_t*)playerHandle)->outputGenerator->generate(sampleCount,sampleBuf);
+}
+
+// Copies frame requests with their durations converted to the synthesis rate; release with delete[].
+static speechPlayer_frameRequest_t* toInternalFrames(speechPlayer_handleInfo_t* playerHandleInfo, const speechPlayer_frameRequest_t* frames, unsigned int count) {
+	speechPlayer_frameRequest_t* internalFrames=new speechPlayer_frameRequest_t[count?count:1];
+	for(unsigned int i=0;i<count;++i) {
+		internalFrames[i]=frames[i];
+		internalFrames[i].minFrameDuration=toInternalSamples(playerHandleInfo,frames[i].minFrameDuration);
+		internalFrames[i].fadeDuration=max(toInternalSamples(playerHandleInfo,frames[i].fadeDuration),1);
+	}
+	return internalFrames;
+}
+
+int speechPlayer_preempt(speechPlayer_handle_t playerHandle, const speechPlayer_frameRequest_t* frames, unsigned int count, unsigned int rampMs, unsigned int unplayedSamples) {
+	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	speechPlayer_frameRequest_t* internalFrames=toInternalFrames(playerHandleInfo,frames,count);
+	unsigned int rampSamples=(unsigned int)(((unsigned long long)rampMs*playerHandleInfo->sampleRate)/1000);
+	unsigned int dropped=playerHandleInfo->preempter->preempt(internalFrames,count,unplayedSamples,rampSamples);
+	delete[] internalFrames;
+	return (int)dropped;
+}
+
+unsigned int speechPlayer_prepare(speechPlayer_handle_t playerHandle, const speechPlayer_frameRequest_t* frames, unsigned int count) {
+	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	speechPlayer_frameRequest_t* internalFrames=toInternalFrames(playerHandleInfo,frames,count);
+	unsigned int ticket=playerHandleInfo->speculator->prepare(internalFrames,count,playerHandleInfo->rate,playerHandleInfo->timeCompression);
+	delete[] internalFrames;
+	return ticket;
+}
+
+int speechPlayer_commit(speechPlayer_handle_t playerHandle, unsigned int ticket, unsigned int rampMs, unsigned int unplayedSamples) {
+	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	std::shared_ptr<Speculation> speculation=playerHandleInfo->speculator->take(ticket);
+	if(!speculation) return -1;
+	unsigned int rampSamples=(unsigned int)(((unsigned long long)rampMs*playerHandleInfo->sampleRate)/1000);
+	// Audio rendered before a rate or compression change would not match what the host asked for, so it is only used if neither changed.
+	if(speculation->complete&&speculation->rate==playerHandleInfo->rate&&speculation->timeCompression==playerHandleInfo->timeCompression) {
+		return (int)playerHandleInfo->preempter->preemptWithAudio(speculation->audio,speculation->marks,unplayedSamples,rampSamples);
+	}
+	unsigned int count=(unsigned int)speculation->requests.size();
+	return (int)playerHandleInfo->preempter->preempt(count?&speculation->requests[0]:NULL,count,unplayedSamples,rampSamples);
+}
+
+void speechPlayer_discard(speechPlayer_handle_t playerHandle, unsigned int ticket) {
+	((speechPlayer_handleInfo_t*)playerHandle)->speculator->take(ticket);
+}
+
+void speechPlayer_setSpeculationLimits(speechPlayer_handle_t playerHandle, unsigned int maxSpeculations, unsigned int maxMs) {
+	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	unsigned int maxSamples=(unsigned int)(((unsigned long long)maxMs*playerHandleInfo->sampleRate)/1000);
+	playerHandleInfo->speculator->setLimits(maxSpeculations,maxSamples);
+}
+
+speechPlayer_state_t speechPlayer_suspend(speechPlayer_handle_t playerHandle, unsigned int unplayedSamples) {
+	return (speechPlayer_state_t)((speechPlayer_handleInfo_t*)playerHandle)->preempter->suspend(unplayedSamples);
+}
+
+int speechPlayer_resume(speechPlayer_handle_t playerHandle, speechPlayer_state_t state, unsigned int rampMs, unsigned int unplayedSamples) {
+	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	if(!state) return 0;
+	unsigned int rampSamples=(unsigned int)(((unsigned long long)rampMs*playerHandleInfo->sampleRate)/1000);
+	return (int)playerHandleInfo->preempter->resume((WaveGeneratorState*)state,unplayedSamples,rampSamples);
+}
+
+void speechPlayer_freeState(speechPlayer_state_t state) {
+	delete (WaveGeneratorState*)state;
+}
+
+void speechPlayer_skip(speechPlayer_handle_t playerHandle, unsigned int numSamples) {
+	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	playerHandleInfo->preempter->skip(toInternalSamples(playerHandleInfo,numSamples));
+}
+
+void speechPlayer_setRate(speechPlayer_handle_t playerHandle, double rate) {
+	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	if(rate>0) playerHandleInfo->rate=rate;
+	playerHandleInfo->frameManager->setRate(rate);
+}
+
+void speechPlayer_setTimeCompression(speechPlayer_handle_t playerHandle, double factor) {
+	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	playerHandleInfo->timeCompression=factor;
+	playerHandleInfo->timeCompressor->setFactor(factor);
 }
 
 int speechPlayer_getLastIndex(speechPlayer_handle_t playerHandle) {
 	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
-	return playerHandleInfo->frameManager->getLastIndex();
+	return playerHandleInfo->preempter->getLastIndex();
 }
 
 void speechPlayer_terminate(speechPlayer_handle_t playerHandle) {
 	speechPlayer_handleInfo_t* playerHandleInfo=(speechPlayer_handleInfo_t*)playerHandle;
+	delete playerHandleInfo->speculator;
+	delete playerHandleInfo->preempter;
+	delete playerHandleInfo->resampler;
+	delete playerHandleInfo->timeCompressor;
 	delete playerHandleInfo->waveGenerator;
 	delete playerHandleInfo->frameManager;
 	delete playerHandleInfo;
 }
-  
\ No newline at end of file
+  
+sample* speechPlayer_renderOffline(int sampleRate, unsigned int flags, const speechPlayer_frameRequest_t* frames, unsigned int count, unsigned int noiseSeed, unsigned int numThreads, unsigned int* sampleCount) {
+	speechPlayer_frameRequest_t* requests=new speechPlayer_frameRequest_t[count?count:1];
+	for(unsigned int i=0;i<count;++i) {
+		requests[i]=frames[i];
+		requests[i].fadeDuration=max(frames[i].fadeDuration,1);
+	}
+	unsigned int renderedCount=0;
+	sample* buffer=OfflineRenderer::render(sampleRate,flags,requests,count,noiseSeed,numThreads,renderedCount);
+	delete[] requests;
+	if(sampleCount) *sampleCount=renderedCount;
+	return buffer;
+}
+
+void speechPlayer_freeRendered(sample* buffer) {
+	delete[] buffer;
+}
+
+typedef struct {
+	int sampleRate;
+	int numVoices;
+	FrameManager** frameManagers;
+	MultiVoiceWaveGenerator* waveGenerator;
+} speechPlayer_multiHandleInfo_t;
+
+speechPlayer_handle_t speechPlayer_multiInitialize(int sampleRate, int numVoices) {
+	if(numVoices<1) return NULL;
+	speechPlayer_multiHandleInfo_t* playerHandleInfo=new speechPlayer_multiHandleInfo_t;
+	playerHandleInfo->sampleRate=sampleRate;
+	playerHandleInfo->numVoices=numVoices;
+	playerHandleInfo->frameManagers=new FrameManager*[numVoices];
+	playerHandleInfo->waveGenerator=MultiVoiceWaveGenerator::create(sampleRate,numVoices);
+	for(int voice=0;voice<numVoices;++voice) {
+		playerHandleInfo->frameManagers[voice]=FrameManager::create(sampleRate);
+		playerHandleInfo->waveGenerator->setFrameManager(voice,playerHandleInfo->frameManagers[voice]);
+	}
+	return (speechPlayer_handle_t)playerHandleInfo;
+}
+
+void speechPlayer_multiQueueFrame(speechPlayer_handle_t playerHandle, int voice, speechPlayer_frame_t* framePtr, unsigned int minFrameDuration, unsigned int fadeDuration, int userIndex, bool purgeQueue) {
+	speechPlayer_multiHandleInfo_t* playerHandleInfo=(speechPlayer_multiHandleInfo_t*)playerHandle;
+	if(voice<0||voice>=playerHandleInfo->numVoices) return;
+	playerHandleInfo->frameManagers[voice]->queueFrame(framePtr,minFrameDuration,max(fadeDuration,1),userIndex,purgeQueue);
+}
+
+int speechPlayer_multiSynthesize(speechPlayer_handle_t playerHandle, unsigned int sampleCount, sample* sampleBufs, int* sampleCounts) {
+	return ((speechPlayer_multiHandleInfo_t*)playerHandle)->waveGenerator->generate(sampleCount,sampleBufs,sampleCounts);
+}
+
+int speechPlayer_multiGetLastIndex(speechPlayer_handle_t playerHandle, int voice) {
+	speechPlayer_multiHandleInfo_t* playerHandleInfo=(speechPlayer_multiHandleInfo_t*)playerHandle;
+	if(voice<0||voice>=playerHandleInfo->numVoices) return -1;
+	return playerHandleInfo->frameManagers[voice]->getLastIndex();
+}
+
+void speechPlayer_multiTerminate(speechPlayer_handle_t playerHandle) {
+	speechPlayer_multiHandleInfo_t* playerHandleInfo=(speechPlayer_multiHandleInfo_t*)playerHandle;
+	delete playerHandleInfo->waveGenerator;
+	for(int voice=0;voice<playerHandleInfo->numVoices;++voice) {
+		delete playerHandleInfo->frameManagers[voice];
+	}
+	delete[] playerHandleInfo->frameManagers;
+	delete playerHandleInfo;
+}
@@ -23,13 +23,112 @@ extern "C" {
 #include "sample.h"
 
 typedef void* speechPlayer_handle_t;
+/* Speech saved by speechPlayer_suspend */
+typedef void* speechPlayer_state_t;
+
+/* One entry of a frame sequence passed to speechPlayer_preempt; the fields mean the same as the arguments of speechPlayer_queueFrame. */
+typedef struct {
+	speechPlayer_frame_t* frame;
+	unsigned int minFrameDuration;
+	unsigned int fadeDuration;
+	int userIndex;
+} speechPlayer_frameRequest_t;
+
+/* Flags for speechPlayer_initializeEx */
+/* Run the cascade formant chain one sample at a time (reference implementation). This is the default; the flag is kept for existing callers and wins over SPEECHPLAYER_INIT_WAVEFRONT_CASCADE. */
+#define SPEECHPLAYER_INIT_SCALAR_CASCADE 0x1
+/* Run the DSP in single precision. The default double precision engine is the reference. */
+#define SPEECHPLAYER_INIT_FLOAT32 0x2
+/* Run the DSP in fixed point integer arithmetic, for CPUs with weak floating point. Overrides the other flags. */
+#define SPEECHPLAYER_INIT_FIXED_POINT 0x4
+/* Run the cascade formant chain in skewed blocks of 32 samples, with coefficients held for each block. Experimental: output differs from the reference and no speedup has been measured. */
+#define SPEECHPLAYER_INIT_WAVEFRONT_CASCADE 0x8
 
 speechPlayer_handle_t speechPlayer_initialize(int sampleRate);
+speechPlayer_handle_t speechPlayer_initializeEx(int sampleRate, unsigned int flags);
+/**
+ * Synthesizes at internalRate and resamples to outputRate inside the engine.
+ * Frame durations passed to speechPlayer_queueFrame and the samples returned by speechPlayer_synthesize are both at outputRate.
+ * If the ratio between the two rates is not supported, synthesis runs at outputRate directly.
+ */
+speechPlayer_handle_t speechPlayer_initializeResampled(int outputRate, int internalRate, unsigned int flags);
 void speechPlayer_queueFrame(speechPlayer_handle_t playerHandle, speechPlayer_frame_t* framePtr, unsigned int minFrameDuration, unsigned int fadeDuration, int userIndex, bool purgeQueue);
 int speechPlayer_synthesize(speechPlayer_handle_t playerHandle, unsigned int sampleCount, sample* sampleBuf); 
+/**
+ * Replaces all queued speech with count frames in one step, for interrupting speech with new speech.
+ * The speech being interrupted is faded out over rampMs milliseconds instead of being cut off.
+ * unplayedSamples is how many samples the host has already received from speechPlayer_synthesize but not played yet.
+ * Returns how many of those the host should discard from the end of its buffer before playing on;
+ * the fade-out returned by the next speechPlayer_synthesize call continues from the last sample it keeps.
+ * A count of 0 just stops speech with the fade-out.
+ */
+int speechPlayer_preempt(speechPlayer_handle_t playerHandle, const speechPlayer_frameRequest_t* frames, unsigned int count, unsigned int rampMs, unsigned int unplayedSamples);
+/**
+ * Suspends the current speech so it can be resumed after an interruption, without running the frontend again.
+ * speechPlayer_suspend saves the complete player state (the frame queue, the current frame and fade position, and all generator and filter states)
+ * together with the unplayedSamples the host holds but has not played, which the host then drops, usually through speechPlayer_preempt with the interruption.
+ * Nothing else changes. speechPlayer_resume replaces whatever is playing exactly as speechPlayer_preempt does,
+ * then continues the saved speech from the first sample the host dropped, with a short fade-in. The rate and time compression in effect are kept.
+ * A state can be resumed more than once; release it with speechPlayer_freeState.
+ */
+speechPlayer_state_t speechPlayer_suspend(speechPlayer_handle_t playerHandle, unsigned int unplayedSamples);
+int speechPlayer_resume(speechPlayer_handle_t playerHandle, speechPlayer_state_t state, unsigned int rampMs, unsigned int unplayedSamples);
+void speechPlayer_freeState(speechPlayer_state_t state);
+/**
+ * Discards the next numSamples of queued speech without synthesizing them, e.g. to skip ahead or to catch up after an audio underrun.
+ * The cost depends on the number of frames skipped, not their length.
+ * speechPlayer_getLastIndex reflects the frames skipped over, and the speech that follows fades in from silence.
+ */
+void speechPlayer_skip(speechPlayer_handle_t playerHandle, unsigned int numSamples);
+/**
+ * Speculative rendering, for speech the host can predict (e.g. the next item of a list while the user arrows through it).
+ * speechPlayer_prepare copies count frames and renders them on a low priority background thread, with the rate and time compression in effect at the time.
+ * It returns a ticket, or 0 if the maximum number of speculations are already held.
+ * speechPlayer_commit(ticket) then replaces the current speech exactly as speechPlayer_preempt would, playing the rendered audio if it is ready.
+ * If it is not ready, or the rate or time compression changed since speechPlayer_prepare, the frames are rendered live instead.
+ * It returns -1 for an unknown ticket. Committing or discarding a ticket releases it.
+ * speechPlayer_setSpeculationLimits bounds the number of tickets held at once (default 4) and the audio they hold together (default 30 seconds);
+ * a speculation that would go over stops rendering and is played live when committed.
+ */
+unsigned int speechPlayer_prepare(speechPlayer_handle_t playerHandle, const speechPlayer_frameRequest_t* frames, unsigned int count);
+int speechPlayer_commit(speechPlayer_handle_t playerHandle, unsigned int ticket, unsigned int rampMs, unsigned int unplayedSamples);
+void speechPlayer_discard(speechPlayer_handle_t playerHandle, unsigned int ticket);
+void speechPlayer_setSpeculationLimits(speechPlayer_handle_t playerHandle, unsigned int maxSpeculations, unsigned int maxMs);
+/**
+ * Scales the durations of all frames, including those already queued, by 1/rate.
+ * The new rate applies from the next frame transition, so a rate change needs no purge.
+ */
+void speechPlayer_setRate(speechPlayer_handle_t playerHandle, double rate);
+/**
+ * Speeds up the rendered audio by factor without changing its pitch, by removing whole pitch periods after synthesis.
+ * 1 (the default) turns the stage off. Can be changed at any time, including while audio is being synthesized.
+ */
+void speechPlayer_setTimeCompression(speechPlayer_handle_t playerHandle, double factor);
 int speechPlayer_getLastIndex(speechPlayer_handle_t playerHandle);
 void speechPlayer_terminate(speechPlayer_handle_t playerHandle);
 
+/**
+ * Renders count frames straight to memory, e.g. to turn a long document into audio. Durations are in samples at sampleRate.
+ * The sequence is split after every NULL frame and the pieces are rendered on numThreads threads (0 for one per processor).
+ * Each piece starts from silence with its own noise seed derived from noiseSeed, so the output does not depend on the number of threads.
+ * Returns a buffer of *sampleCount samples, to be released with speechPlayer_freeRendered.
+ */
+sample* speechPlayer_renderOffline(int sampleRate, unsigned int flags, const speechPlayer_frameRequest_t* frames, unsigned int count, unsigned int noiseSeed, unsigned int numThreads, unsigned int* sampleCount);
+void speechPlayer_freeRendered(sample* buffer);
+
+/**
+ * Multi-voice player: renders numVoices independent voices in lockstep using SIMD lanes.
+ * Each voice has its own frame queue; frames are queued exactly as for a single player.
+ * speechPlayer_multiSynthesize fills sampleBufs with numVoices consecutive blocks of sampleCount samples
+ * and writes the number of samples produced for each voice to sampleCounts.
+ * It returns the largest of those counts.
+ */
+speechPlayer_handle_t speechPlayer_multiInitialize(int sampleRate, int numVoices);
+void speechPlayer_multiQueueFrame(speechPlayer_handle_t playerHandle, int voice, speechPlayer_frame_t* framePtr, unsigned int minFrameDuration, unsigned int fadeDuration, int userIndex, bool purgeQueue);
+int speechPlayer_multiSynthesize(speechPlayer_handle_t playerHandle, unsigned int sampleCount, sample* sampleBufs, int* sampleCounts);
+int speechPlayer_multiGetLastIndex(speechPlayer_handle_t playerHandle, int voice);
+void speechPlayer_multiTerminate(speechPlayer_handle_t playerHandle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,38 +24,52 @@ Based on klsyn-88, found at http://linguistics.berkeley.edu/phonlab/resources/
 #include "debug.h"
 #include "utils.h"
 #include "speechWaveGenerator.h"
+#include "fixedPointWaveGenerator.h"
 
 using namespace std;
 
 const double PITWO=M_PI*2;
 
-class NoiseGenerator {
+/*
+All DSP classes below are templated on the type used for their state and arithmetic.
+The double instantiation is the reference engine; the float instantiation halves the size of the DSP state at some cost in accuracy.
+Frame parameters stay double and are converted as they are read.
+*/
+
+template<typename T> class NoiseGenerator {
 	private:
-	double lastValue;
+	T lastValue;
+	// Private random state, or NULL to use rand().
+	unsigned int* randomState;
 
 	public:
-	NoiseGenerator(): lastValue(0.0) {};
+	NoiseGenerator(): lastValue(0), randomState(NULL) {};
+
+	void setRandomState(unsigned int* state) {
+		randomState=state;
+	}
 
 	void reset() {
-		lastValue=0.0;
+		lastValue=0;
 	}
 
-	double getNext() {
+	T getNext() {
 		// rand() returns a non-negative value, so using it directly yields strictly
 		// positive noise and a significant DC bias after the one-pole filter.
 		//
 		// Center the random value at 0 ([-0.5, 0.5]) to avoid DC offset "thumps"
 		// when the signal (especially turbulence) is faded in/out.
-		lastValue=(((double)rand()/(double)RAND_MAX)-0.5)+0.75*lastValue;
+		T random=randomState?((T)nextRandom(*randomState)/(T)nextRandomMax):((T)rand()/(T)RAND_MAX);
+		lastValue=(random-T(0.5))+T(0.75)*lastValue;
 		return lastValue;
 	}
 
 };
 
-class FrequencyGenerator {
+template<typename T> class FrequencyGenerator {
 	private:
 	int sampleRate;
-	double lastCyclePos;
+	T lastCyclePos;
 
 	public:
 	FrequencyGenerator(int sr): sampleRate(sr), lastCyclePos(0) {}
@@ -64,111 +78,109 @@ class FrequencyGenerator {
 		lastCyclePos=0;
 	}
 
-	double getNext(double frequency) {
-		double cyclePos=fmod((frequency/sampleRate)+lastCyclePos,1);
+	T getNext(T frequency) {
+		T cyclePos=fmod((frequency/sampleRate)+lastCyclePos,T(1));
 		lastCyclePos=cyclePos;
 		return cyclePos;
 	}
 
 };
 
-class VoiceGenerator {
+template<typename T> class VoiceGenerator {
 	private:
-	FrequencyGenerator pitchGen;
-	FrequencyGenerator vibratoGen;
-	NoiseGenerator aspirationGen;
+	FrequencyGenerator<T> pitchGen;
+	FrequencyGenerator<T> vibratoGen;
+	FrequencyGenerator<T> trillGen;
+	NoiseGenerator<T> aspirationGen;
 
 	public:
 	bool glottisOpen;
-	VoiceGenerator(int sr): pitchGen(sr), vibratoGen(sr), aspirationGen(), glottisOpen(false) {};
+	// How far into a trill closure the last sample was, 0 when the frame has no trill.
+	T trillClosure;
+	VoiceGenerator(int sr): pitchGen(sr), vibratoGen(sr), trillGen(sr), aspirationGen(), glottisOpen(false), trillClosure(0) {};
 
 	void reset() {
 		pitchGen.reset();
 		vibratoGen.reset();
+		trillGen.reset();
 		aspirationGen.reset();
 		glottisOpen=false;
+		trillClosure=0;
 	}
 
-	double getNext(const speechPlayer_frame_t* frame) {
-		double vibrato=(sin(vibratoGen.getNext(frame->vibratoSpeed)*PITWO)*0.06*frame->vibratoPitchOffset)+1;
-		double voice=pitchGen.getNext(frame->voicePitch*vibrato);
-		double aspiration=aspirationGen.getNext()*0.1;
-		double turbulence=aspiration*frame->voiceTurbulenceAmplitude;
-		double effectiveOQ = frame->glottalOpenQuotient;
-		if (effectiveOQ <= 0.0) effectiveOQ = 0.7;
+	void setRandomState(unsigned int* state) {
+		aspirationGen.setRandomState(state);
+	}
+
+	T getNext(const speechPlayer_frame_t* frame) {
+		T vibrato=(sin(vibratoGen.getNext((T)frame->vibratoSpeed)*T(PITWO))*T(0.06)*(T)frame->vibratoPitchOffset)+1;
+		T voice=pitchGen.getNext((T)frame->voicePitch*vibrato);
+		T aspiration=aspirationGen.getNext()*T(0.1);
+		T turbulence=aspiration*(T)frame->voiceTurbulenceAmplitude;
+		T effectiveOQ = (T)frame->glottalOpenQuotient;
+		if (effectiveOQ <= 0) effectiveOQ = T(0.7);
 		glottisOpen=voice>=effectiveOQ;
 		if(!glottisOpen) {
-			turbulence*=0.01;
-			voice=0.0;
+			turbulence*=T(0.01);
+			voice=0;
 		} else {
-			double openLen = 1.0 - effectiveOQ;
-			if (openLen < 0.0001) openLen = 0.0001;
-			double phase = (voice - effectiveOQ) / openLen;
+			T openLen = 1 - effectiveOQ;
+			if (openLen < T(0.0001)) openLen = T(0.0001);
+			T phase = (voice - effectiveOQ) / openLen;
 			// Smooth Peak Hybrid:
 			// Rise (0..0.9): Standard Cosine rise (fat, warm).
 			// Fall (0.9..1.0): Quadratic fall (starts flat, accelerates to sharp closure).
 			// This matches slopes at the peak (slope 0), removing the "peak kink" artifact (phaser),
 			// while retaining the sharp closure (buzz) and zero-return (no clicks).
-			if (phase < 0.9) {
-				voice = 0.5 * (1.0 - cos(phase * M_PI / 0.9));
+			if (phase < T(0.9)) {
+				voice = T(0.5) * (1 - cos(phase * T(M_PI) / T(0.9)));
 			} else {
-				double v = (phase - 0.9) * 10.0; // 0..1
-				voice = 1.0 - v * v;
+				T v = (phase - T(0.9)) * 10; // 0..1
+				voice = 1 - v * v;
 			}
-			voice *= 2.0;
+			voice *= 2;
 		}
 		voice+=turbulence;
-		voice*=frame->voiceAmplitude;
-		aspiration*=frame->aspirationAmplitude;
+		voice*=(T)frame->voiceAmplitude;
+		if(frame->trillRate>0) {
+			trillClosure=calculateTrillClosure(trillGen.getNext((T)frame->trillRate),(T)frame->trillRate,(T)frame->trillClosureFraction);
+			voice*=1-trillClosure*(T)frame->trillDepth;
+		} else {
+			// Every trill starts at the open part of its first cycle.
+			trillGen.reset();
+			trillClosure=0;
+		}
+		aspiration*=(T)frame->aspirationAmplitude;
 		return aspiration+voice;
 	}
 
 };
 
-class Resonator {
+template<typename T> class Resonator {
 	private:
-	//raw parameters
-	int sampleRate;
-	double frequency;
-	double bandwidth;
 	bool anti;
-	//calculated parameters
-	bool setOnce;
-	double a, b, c;
+	// Coefficients come precalculated (in double) from the FrameManager and are narrowed to T.
+	T a, b, c;
 	//Memory
-	double p1, p2;
+	T p1, p2;
 
 	public:
-	Resonator(int sampleRate, bool anti=false) {
-		this->sampleRate=sampleRate;
+	Resonator(bool anti=false) {
 		this->anti=anti;
-		this->setOnce=false;
+		this->a=this->b=this->c=0;
 		this->p1=0;
 		this->p2=0;
 	}
 
-	void setParams(double frequency, double bandwidth) {
-		if(!setOnce||(frequency!=this->frequency)||(bandwidth!=this->bandwidth)) {
-			this->frequency=frequency;
-			this->bandwidth=bandwidth;
-			// Add constant bandwidth to reduce "boxiness" and soften transient clicks
-			double effectiveBandwidth = bandwidth + 25.0;
-			double r=exp(-M_PI/sampleRate*effectiveBandwidth);
-			c=-(r*r);
-			b=r*cos(PITWO/sampleRate*-frequency)*2.0;
-			a=1.0-b-c;
-			if(anti&&frequency!=0) {
-				a=1.0/a;
-				c*=-a;
-				b*=-a;
-			}
-		}
-		this->setOnce=true;
+	void setCoefficients(const speechPlayer_resonatorCoefficients_t& coefficients) {
+		a=(T)coefficients.a;
+		b=(T)coefficients.b;
+		c=(T)coefficients.c;
 	}
 
-	double resonate(double in, double frequency, double bandwidth, bool allowUpdate=true) {
-		if(allowUpdate) setParams(frequency,bandwidth);
-		double out=a*in+b*p1+c*p2;
+	T resonate(T in, const speechPlayer_resonatorCoefficients_t& coefficients, bool allowUpdate=true) {
+		if(allowUpdate) setCoefficients(coefficients);
+		T out=a*in+b*p1+c*p2;
 		p2=p1;
 		p1=anti?in:out;
 		return out;
@@ -177,113 +189,217 @@ class Resonator {
 	void reset() {
 		p1=0;
 		p2=0;
-		setOnce=false;
 	}
 
 };
 
-class CascadeFormantGenerator { 
+// numFormants is how many of F1 to F6 are rendered; the ones above it are compiled out (see calculateAudibleFormants).
+template<typename T, int numFormants> class CascadeFormantGenerator { 
 	private:
 	int sampleRate;
-	Resonator r1, r2, r3, r4, r5, r6, rN0, rNP;
+	Resonator<T> r1, r2, r3, r4, r5, r6, rN0, rNP;
 
 	public:
-	CascadeFormantGenerator(int sr): sampleRate(sr), r1(sr), r2(sr), r3(sr), r4(sr), r5(sr), r6(sr), rN0(sr,true), rNP(sr) {};
+	CascadeFormantGenerator(int sr): sampleRate(sr), r1(), r2(), r3(), r4(), r5(), r6(), rN0(true), rNP() {};
 
 	void reset() {
 		r1.reset(); r2.reset(); r3.reset(); r4.reset(); r5.reset(); r6.reset(); rN0.reset(); rNP.reset();
 	}
 
-	double getNext(const speechPlayer_frame_t* frame, bool glottisOpen, double input) {
-		input/=2.0;
+	T getNext(const speechPlayer_frame_t* frame, const speechPlayer_frameCoefficients_t* coefficients, bool glottisOpen, T input) {
+		input/=2;
 		bool allowUpdate=!glottisOpen;
-		double n0Output=rN0.resonate(input,frame->cfN0,frame->cbN0,allowUpdate);
-		double output=calculateValueAtFadePosition(input,rNP.resonate(n0Output,frame->cfNP,frame->cbNP,allowUpdate),frame->caNP);
-		output=r6.resonate(output,frame->cf6,frame->cb6,allowUpdate);
-		output=r5.resonate(output,frame->cf5,frame->cb5,allowUpdate);
-		output=r4.resonate(output,frame->cf4,frame->cb4,allowUpdate);
-		output=r3.resonate(output,frame->cf3,frame->cb3,allowUpdate);
-		output=r2.resonate(output,frame->cf2,frame->cb2,allowUpdate);
-		output=r1.resonate(output,frame->cf1,frame->cb1,allowUpdate);
+		const speechPlayer_resonatorCoefficients_t* r=coefficients->resonators;
+		T n0Output=rN0.resonate(input,r[speechPlayer_resonator_cfN0],allowUpdate);
+		T output=(T)calculateValueAtFadePosition(input,rNP.resonate(n0Output,r[speechPlayer_resonator_cfNP],allowUpdate),frame->caNP);
+		if(numFormants>=6) output=r6.resonate(output,r[speechPlayer_resonator_cf6],allowUpdate);
+		if(numFormants>=5) output=r5.resonate(output,r[speechPlayer_resonator_cf5],allowUpdate);
+		output=r4.resonate(output,r[speechPlayer_resonator_cf4],allowUpdate);
+		output=r3.resonate(output,r[speechPlayer_resonator_cf3],allowUpdate);
+		output=r2.resonate(output,r[speechPlayer_resonator_cf2],allowUpdate);
+		output=r1.resonate(output,r[speechPlayer_resonator_cf1],allowUpdate);
 		return output;
 	}
 
 };
 
-class ParallelFormantGenerator { 
+/*
+Block version of CascadeFormantGenerator.
+The stages are skewed in time: at step t, stage k works on sample t-k.
+Every stage then only depends on values from the previous step, so all eight resonators advance together in one vector step.
+A block of n samples takes n+numCascadeStages-1 steps. Stages outside their part of the block keep their state untouched.
+Coefficients are held constant for the whole block, latched from the last sample in it where the glottis was closed.
+*/
+const unsigned int cascadeBlockSize=32;
+
+template<typename T, int numFormants> class WavefrontCascadeFormantGenerator {
+	private:
+	// The nasal zero and pole, then the formants from the highest rendered one down to F1.
+	static const int numCascadeStages=numFormants+2;
+	bool latched;
+
+	// Frame coefficient index of each stage, in processing order. Stage 0 is the nasal zero (antiresonator).
+	static int stageResonator(int k) {
+		if(k==0) return speechPlayer_resonator_cfN0;
+		if(k==1) return speechPlayer_resonator_cfNP;
+		return speechPlayer_resonator_cf1+(numCascadeStages-1-k);
+	}
+
+	speechPlayer_resonatorCoefficients_t latchedCoefficients[numCascadeStages];
+	alignas(64) T a[numCascadeStages];
+	alignas(64) T b[numCascadeStages];
+	alignas(64) T c[numCascadeStages];
+	alignas(64) T p1[numCascadeStages];
+	alignas(64) T p2[numCascadeStages];
+
+	void applyLatchedCoefficients() {
+		for(int k=0;k<numCascadeStages;++k) {
+			a[k]=(T)latchedCoefficients[k].a;
+			b[k]=(T)latchedCoefficients[k].b;
+			c[k]=(T)latchedCoefficients[k].c;
+		}
+	}
+
+	public:
+	WavefrontCascadeFormantGenerator() {
+		for(int k=0;k<numCascadeStages;++k) {
+			a[k]=b[k]=c[k]=0;
+		}
+		reset();
+	};
+
+	void reset() {
+		for(int k=0;k<numCascadeStages;++k) {
+			p1[k]=0;
+			p2[k]=0;
+		}
+		latched=false;
+	}
+
+	bool hasLatchedCoefficients() {
+		return latched;
+	}
+
+	// Records the cascade coefficients of the current frame, to be used for the next block.
+	void latchCoefficients(const speechPlayer_frameCoefficients_t* coefficients) {
+		for(int k=0;k<numCascadeStages;++k) {
+			latchedCoefficients[k]=coefficients->resonators[stageResonator(k)];
+		}
+		latched=true;
+	}
+
+	// input is the already halved cascade input, caNP the nasal coupling for each sample.
+	void process(const T* input, const T* caNP, T* output, const unsigned int count) {
+		if(count==0) return;
+		if(latched) applyLatchedCoefficients();
+		alignas(64) T x[numCascadeStages]={0};
+		alignas(64) T y[numCascadeStages];
+		for(unsigned int t=0;t<count+numCascadeStages-1;++t) {
+			x[0]=(t<count)?input[t]:0;
+			for(int k=0;k<numCascadeStages;++k) {
+				y[k]=a[k]*x[k]+b[k]*p1[k]+c[k]*p2[k];
+			}
+			for(int k=0;k<numCascadeStages;++k) {
+				bool active=(t>=(unsigned int)k)&&(t-k<count);
+				T newP1=(k==0)?x[k]:y[k];
+				p2[k]=active?p1[k]:p2[k];
+				p1[k]=active?newP1:p1[k];
+			}
+			if(t>=numCascadeStages-1) output[t-(numCascadeStages-1)]=y[numCascadeStages-1];
+			for(int k=numCascadeStages-1;k>2;--k) x[k]=y[k-1];
+			// y[1] holds sample t-1, which stage 2 picks up on the next step.
+			x[2]=(t>=1&&t-1<count)?(T)calculateValueAtFadePosition(input[t-1],y[1],caNP[t-1]):0;
+			x[1]=y[0];
+		}
+	}
+
+};
+
+template<typename T, int numFormants> class ParallelFormantGenerator { 
 	private:
 	int sampleRate;
-	Resonator r1, r2, r3, r4, r5, r6;
+	Resonator<T> r1, r2, r3, r4, r5, r6;
 
 	public:
-	ParallelFormantGenerator(int sr): sampleRate(sr), r1(sr), r2(sr), r3(sr), r4(sr), r5(sr), r6(sr) {};
+	ParallelFormantGenerator(int sr): sampleRate(sr), r1(), r2(), r3(), r4(), r5(), r6() {};
 
 	void reset() {
 		r1.reset(); r2.reset(); r3.reset(); r4.reset(); r5.reset(); r6.reset();
 	}
 
-	double getNext(const speechPlayer_frame_t* frame, bool glottisOpen, double input) {
-		input/=2.0;
+	T getNext(const speechPlayer_frame_t* frame, const speechPlayer_frameCoefficients_t* coefficients, bool glottisOpen, T input) {
+		input/=2;
 		bool allowUpdate=!glottisOpen;
-		double output=0;
-		output+=(r1.resonate(input,frame->pf1,frame->pb1,allowUpdate)-input)*frame->pa1;
-		output+=(r2.resonate(input,frame->pf2,frame->pb2,allowUpdate)-input)*frame->pa2;
-		output+=(r3.resonate(input,frame->pf3,frame->pb3,allowUpdate)-input)*frame->pa3;
-		output+=(r4.resonate(input,frame->pf4,frame->pb4,allowUpdate)-input)*frame->pa4;
-		output+=(r5.resonate(input,frame->pf5,frame->pb5,allowUpdate)-input)*frame->pa5;
-		output+=(r6.resonate(input,frame->pf6,frame->pb6,allowUpdate)-input)*frame->pa6;
-		return calculateValueAtFadePosition(output,input,frame->parallelBypass);
+		const speechPlayer_resonatorCoefficients_t* r=coefficients->resonators;
+		T output=0;
+		output+=(r1.resonate(input,r[speechPlayer_resonator_pf1],allowUpdate)-input)*(T)frame->pa1;
+		output+=(r2.resonate(input,r[speechPlayer_resonator_pf2],allowUpdate)-input)*(T)frame->pa2;
+		output+=(r3.resonate(input,r[speechPlayer_resonator_pf3],allowUpdate)-input)*(T)frame->pa3;
+		output+=(r4.resonate(input,r[speechPlayer_resonator_pf4],allowUpdate)-input)*(T)frame->pa4;
+		if(numFormants>=5) output+=(r5.resonate(input,r[speechPlayer_resonator_pf5],allowUpdate)-input)*(T)frame->pa5;
+		if(numFormants>=6) output+=(r6.resonate(input,r[speechPlayer_resonator_pf6],allowUpdate)-input)*(T)frame->pa6;
+		return (T)calculateValueAtFadePosition(output,input,frame->parallelBypass);
 	}
 
 };
 
-class SpeechWaveGeneratorImpl: public SpeechWaveGenerator {
+template<typename T, int numFormants> class SpeechWaveGeneratorImpl: public SpeechWaveGenerator {
 	private:
 	int sampleRate;
-	VoiceGenerator voiceGenerator;
-	NoiseGenerator fricGenerator;
-	CascadeFormantGenerator cascade;
-	ParallelFormantGenerator parallel;
+	bool blockCascade;
+	VoiceGenerator<T> voiceGenerator;
+	NoiseGenerator<T> fricGenerator;
+	CascadeFormantGenerator<T,numFormants> cascade;
+	WavefrontCascadeFormantGenerator<T,numFormants> wavefrontCascade;
+	ParallelFormantGenerator<T,numFormants> parallel;
 	FrameManager* frameManager;
-	double lastInput;
-	double lastOutput;
-	double lastVoiceInput;
-	double lastVoiceOutput;
+	T lastInput;
+	T lastOutput;
+	T lastVoiceInput;
+	T lastVoiceOutput;
 	bool wasSilence;
+	double lastVoicePitch;
+	unsigned int noiseState;
+	T blockCascadeIn[cascadeBlockSize];
+	T blockCaNP[cascadeBlockSize];
+	T blockCascadeOut[cascadeBlockSize];
+	T blockParallelOut[cascadeBlockSize];
+	T blockOutputGain[cascadeBlockSize];
+
+	T getNextVoice(const speechPlayer_frame_t* frame) {
+		T rawVoice=voiceGenerator.getNext(frame);
+		T voice=rawVoice-lastVoiceInput+T(0.995)*lastVoiceOutput;
+		lastVoiceInput=rawVoice;
+		lastVoiceOutput=voice;
+		return voice;
+	}
 
-	public:
-	SpeechWaveGeneratorImpl(int sr): sampleRate(sr), voiceGenerator(sr), fricGenerator(), cascade(sr), parallel(sr), frameManager(NULL), lastInput(0.0), lastOutput(0.0), lastVoiceInput(0.0), lastVoiceOutput(0.0), wasSilence(true) {
+	T getNextParallel(const speechPlayer_frame_t* frame) {
+		T fricationAmplitude=(T)frame->fricationAmplitude;
+		if(voiceGenerator.trillClosure>0&&frame->trillFricationFloor>fricationAmplitude) fricationAmplitude+=((T)frame->trillFricationFloor-fricationAmplitude)*voiceGenerator.trillClosure;
+		T fric=fricGenerator.getNext()*T(0.175)*fricationAmplitude;
+		return parallel.getNext(frame,frameManager->getCurrentCoefficients(),voiceGenerator.glottisOpen,fric*(T)frame->preFormantGain);
 	}
 
-	unsigned int generate(const unsigned int sampleCount, sample* sampleBuf) {
-		if(!frameManager) return 0; 
-		double val=0;
+	sampleVal mixOutput(T cascadeOut, T parallelOut, T outputGain) {
+		T out=(cascadeOut+parallelOut)*outputGain;
+		T filteredOut=out-lastInput+T(0.999)*lastOutput;
+		lastInput=out;
+		lastOutput=filteredOut;
+		return (int)max(min(filteredOut*4000,32000),-32000);
+	}
+
+	// Reference path: runs the whole chain one sample at a time.
+	unsigned int generateScalar(const unsigned int sampleCount, sample* sampleBuf) {
 		for(unsigned int i=0;i<sampleCount;++i) {
 			const speechPlayer_frame_t* frame=frameManager->getCurrentFrame();
 			if(frame) {
-				if(wasSilence) {
-					voiceGenerator.reset();
-					fricGenerator.reset();
-					cascade.reset();
-					parallel.reset();
-					lastInput=0.0;
-					lastOutput=0.0;
-					lastVoiceInput=0.0;
-					lastVoiceOutput=0.0;
-					wasSilence=false;
-				}
-				double rawVoice=voiceGenerator.getNext(frame);
-				double voice=rawVoice-lastVoiceInput+0.995*lastVoiceOutput;
-				lastVoiceInput=rawVoice;
-				lastVoiceOutput=voice;
-				double cascadeOut=cascade.getNext(frame,voiceGenerator.glottisOpen,voice*frame->preFormantGain);
-				double fric=fricGenerator.getNext()*0.175*frame->fricationAmplitude;
-				double parallelOut=parallel.getNext(frame,voiceGenerator.glottisOpen,fric*frame->preFormantGain);
-				double out=(cascadeOut+parallelOut)*frame->outputGain;
-				double filteredOut=out-lastInput+0.999*lastOutput;
-				lastInput=out;
-				lastOutput=filteredOut;
-				sampleBuf[i].value=(int)max(min(filteredOut*4000,32000),-32000);
+				if(wasSilence) reset();
+				lastVoicePitch=frame->voicePitch;
+				T voice=getNextVoice(frame);
+				T cascadeOut=cascade.getNext(frame,frameManager->getCurrentCoefficients(),voiceGenerator.glottisOpen,voice*(T)frame->preFormantGain);
+				T parallelOut=getNextParallel(frame);
+				sampleBuf[i].value=mixOutput(cascadeOut,parallelOut,(T)frame->outputGain);
 			} else {
 				wasSilence=true;
 				return i;
@@ -292,10 +408,101 @@ class SpeechWaveGeneratorImpl: public SpeechWaveGenerator {
 		return sampleCount;
 	}
 
+	// Opt-in (SPEECHPLAYER_INIT_WAVEFRONT_CASCADE): runs the sources and parallel path per sample, then the cascade for the whole block at once.
+	unsigned int generateBlocks(const unsigned int sampleCount, sample* sampleBuf) {
+		unsigned int done=0;
+		while(done<sampleCount) {
+			unsigned int blockSize=min(sampleCount-done,cascadeBlockSize);
+			unsigned int n=0;
+			bool ended=false;
+			for(;n<blockSize;++n) {
+				const speechPlayer_frame_t* frame=frameManager->getCurrentFrame();
+				if(!frame) {
+					ended=true;
+					break;
+				}
+				if(wasSilence) reset();
+				lastVoicePitch=frame->voicePitch;
+				T voice=getNextVoice(frame);
+				if(!voiceGenerator.glottisOpen||!wavefrontCascade.hasLatchedCoefficients()) wavefrontCascade.latchCoefficients(frameManager->getCurrentCoefficients());
+				blockCascadeIn[n]=(voice*(T)frame->preFormantGain)/2;
+				blockCaNP[n]=(T)frame->caNP;
+				blockParallelOut[n]=getNextParallel(frame);
+				blockOutputGain[n]=(T)frame->outputGain;
+			}
+			wavefrontCascade.process(blockCascadeIn,blockCaNP,blockCascadeOut,n);
+			for(unsigned int i=0;i<n;++i) {
+				sampleBuf[done+i].value=mixOutput(blockCascadeOut[i],blockParallelOut[i],blockOutputGain[i]);
+			}
+			done+=n;
+			if(ended) {
+				wasSilence=true;
+				return done;
+			}
+		}
+		return sampleCount;
+	}
+
+	public:
+	SpeechWaveGeneratorImpl(int sr, unsigned int flags): sampleRate(sr), blockCascade((flags&SPEECHPLAYER_INIT_WAVEFRONT_CASCADE)!=0&&(flags&SPEECHPLAYER_INIT_SCALAR_CASCADE)==0), voiceGenerator(sr), fricGenerator(), cascade(sr), wavefrontCascade(), parallel(sr), frameManager(NULL), lastInput(0), lastOutput(0), lastVoiceInput(0), lastVoiceOutput(0), wasSilence(true), lastVoicePitch(0), noiseState(0) {
+	}
+
+	void reset() {
+		voiceGenerator.reset();
+		fricGenerator.reset();
+		cascade.reset();
+		wavefrontCascade.reset();
+		parallel.reset();
+		lastInput=0;
+		lastOutput=0;
+		lastVoiceInput=0;
+		lastVoiceOutput=0;
+		wasSilence=false;
+	}
+
+	unsigned int generate(const unsigned int sampleCount, sample* sampleBuf) {
+		if(!frameManager) return 0; 
+		DenormalsAreZero denormalsAreZero;
+		if(blockCascade) return generateBlocks(sampleCount,sampleBuf);
+		return generateScalar(sampleCount,sampleBuf);
+	}
+
 	void setFrameManager(FrameManager* frameManager) {
 		this->frameManager=frameManager;
 	}
 
+	double getLastVoicePitch() {
+		return lastVoicePitch;
+	}
+
+	// The copy keeps pointing its noise generators at this generator's noiseState, so it is only good for restoring into this generator.
+	WaveGeneratorState* saveState() {
+		return new WaveGeneratorCopy<SpeechWaveGeneratorImpl>(*this);
+	}
+
+	void restoreState(const WaveGeneratorState* state) {
+		*this=static_cast<const WaveGeneratorCopy<SpeechWaveGeneratorImpl>*>(state)->generator;
+	}
+
+	void setNoiseSeed(unsigned int seed) {
+		noiseState=seed;
+		voiceGenerator.setRandomState(&noiseState);
+		fricGenerator.setRandomState(&noiseState);
+	}
+
 };
 
-SpeechWaveGenerator* SpeechWaveGenerator::create(int sampleRate) {return new SpeechWaveGeneratorImpl(sampleRate); }
\ No newline at end of file
+// Instantiates the engine without the formants that cannot be heard at this sample rate.
+template<typename T> SpeechWaveGenerator* createWithAudibleFormants(int sampleRate, unsigned int flags) {
+	switch(calculateAudibleFormants(sampleRate)) {
+		case 4: return new SpeechWaveGeneratorImpl<T,4>(sampleRate,flags);
+		case 5: return new SpeechWaveGeneratorImpl<T,5>(sampleRate,flags);
+		default: return new SpeechWaveGeneratorImpl<T,6>(sampleRate,flags);
+	}
+}
+
+SpeechWaveGenerator* SpeechWaveGenerator::create(int sampleRate, unsigned int flags) {
+	if(flags&SPEECHPLAYER_INIT_FIXED_POINT) return FixedPointWaveGenerator::create(sampleRate);
+	if(flags&SPEECHPLAYER_INIT_FLOAT32) return createWithAudibleFormants<float>(sampleRate,flags);
+	return createWithAudibleFormants<double>(sampleRate,flags);
+}
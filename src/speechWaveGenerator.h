@@ -20,8 +20,12 @@ http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
 
 class SpeechWaveGenerator: public WaveGenerator {
 	public:
-	static SpeechWaveGenerator* create(int sampleRate); 
+	static SpeechWaveGenerator* create(int sampleRate, unsigned int flags=0); 
 	virtual void setFrameManager(FrameManager* frameManager)=0;
+	// voicePitch of the most recently rendered sample.
+	virtual double getLastVoicePitch()=0;
+	// Takes noise from a private generator starting at seed instead of the C runtime's rand(), so the render is reproducible on any thread.
+	virtual void setNoiseSeed(unsigned int seed)=0;
 };
 
 #endif
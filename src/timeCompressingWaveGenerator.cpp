@@ -0,0 +1,222 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#include <atomic>
+#include <vector>
+#include "timeCompressingWaveGenerator.h"
+
+const unsigned int pullSize=64;
+// Pitch range used to derive the period; outside it (e.g. unvoiced frames with no meaningful pitch) the period is clamped.
+const double minPeriodPitch=60.0;
+const double maxPeriodPitch=600.0;
+
+// Buffered input and output of a TimeCompressingWaveGeneratorImpl; the factor is a setting and is not saved.
+struct timeCompressorState_t: public WaveGeneratorState {
+	WaveGeneratorState* sourceState;
+	std::vector<sample> input;
+	std::vector<int> inputPeriods;
+	size_t inputPos;
+	std::vector<sample> output;
+	size_t outputPos;
+	int remainingInputToCopy;
+	bool sourceEnded;
+	bool endPending;
+
+	~timeCompressorState_t() {
+		delete sourceState;
+	}
+};
+
+class TimeCompressingWaveGeneratorImpl: public TimeCompressingWaveGenerator {
+	private:
+	SpeechWaveGenerator* source;
+	int sampleRate;
+	std::atomic<double> factor;
+	// Source samples not yet consumed, with the pitch period that was current when each was rendered.
+	std::vector<sample> input;
+	std::vector<int> inputPeriods;
+	size_t inputPos;
+	std::vector<sample> output;
+	size_t outputPos;
+	int remainingInputToCopy;
+	bool sourceEnded;
+	bool endPending;
+
+	int periodForPitch(double pitch) {
+		if(!(pitch>=minPeriodPitch)) pitch=minPeriodPitch;
+		if(pitch>maxPeriodPitch) pitch=maxPeriodPitch;
+		return (int)(sampleRate/pitch+0.5);
+	}
+
+	size_t available() {
+		return input.size()-inputPos;
+	}
+
+	// Pulls more source samples; sets sourceEnded when the source runs out of frames.
+	void pull() {
+		if(inputPos>0) {
+			input.erase(input.begin(),input.begin()+inputPos);
+			inputPeriods.erase(inputPeriods.begin(),inputPeriods.begin()+inputPos);
+			inputPos=0;
+		}
+		size_t oldSize=input.size();
+		input.resize(oldSize+pullSize);
+		unsigned int n=source->generate(pullSize,&input[oldSize]);
+		input.resize(oldSize+n);
+		inputPeriods.resize(oldSize+n,periodForPitch(source->getLastVoicePitch()));
+		if(n<pullSize) sourceEnded=true;
+	}
+
+	// Produces the next piece of compressed output into the output buffer.
+	void step(double speed) {
+		if(remainingInputToCopy>0) {
+			if(available()==0&&!sourceEnded) pull();
+			size_t n=available();
+			if(n>(size_t)remainingInputToCopy) n=remainingInputToCopy;
+			output.insert(output.end(),input.begin()+inputPos,input.begin()+inputPos+n);
+			inputPos+=n;
+			remainingInputToCopy-=(int)n;
+			return;
+		}
+		int period=inputPeriods.empty()||available()==0?periodForPitch(source->getLastVoicePitch()):inputPeriods[inputPos];
+		int newSamples;
+		if(speed>=2.0) {
+			newSamples=(int)(period/(speed-1.0));
+			if(newSamples<1) newSamples=1;
+		} else {
+			newSamples=period;
+			remainingInputToCopy=(int)(period*(2.0-speed)/(speed-1.0));
+		}
+		while(!sourceEnded&&available()<(size_t)(period+newSamples)) pull();
+		if(available()<(size_t)(period+newSamples)) {
+			// The utterance ended inside this step: pass the tail through unchanged.
+			output.insert(output.end(),input.begin()+inputPos,input.end());
+			inputPos=input.size();
+			remainingInputToCopy=0;
+			return;
+		}
+		// Cross-fade from this period into the next one, dropping period samples in the process.
+		const sample* fadeOut=&input[inputPos];
+		const sample* fadeIn=&input[inputPos+period];
+		size_t outStart=output.size();
+		output.resize(outStart+newSamples);
+		for(int t=0;t<newSamples;++t) {
+			int mixed=(fadeOut[t].value*(newSamples-t)+fadeIn[t].value*t)/newSamples;
+			output[outStart+t].value=(sampleVal)mixed;
+		}
+		inputPos+=period+newSamples;
+	}
+
+	public:
+	TimeCompressingWaveGeneratorImpl(SpeechWaveGenerator* source, int sampleRate): source(source), sampleRate(sampleRate), factor(1.0), inputPos(0), outputPos(0), remainingInputToCopy(0), sourceEnded(false), endPending(false) {
+	}
+
+	void setFactor(double factor) {
+		this->factor=(factor>1.0)?factor:1.0;
+	}
+
+	void reset() {
+		input.clear();
+		inputPeriods.clear();
+		inputPos=0;
+		output.clear();
+		outputPos=0;
+		remainingInputToCopy=0;
+		sourceEnded=false;
+		endPending=false;
+		source->reset();
+	}
+
+	WaveGeneratorState* saveState() {
+		timeCompressorState_t* state=new timeCompressorState_t;
+		state->sourceState=source->saveState();
+		state->input=input;
+		state->inputPeriods=inputPeriods;
+		state->inputPos=inputPos;
+		state->output=output;
+		state->outputPos=outputPos;
+		state->remainingInputToCopy=remainingInputToCopy;
+		state->sourceEnded=sourceEnded;
+		state->endPending=endPending;
+		return state;
+	}
+
+	void restoreState(const WaveGeneratorState* savedState) {
+		const timeCompressorState_t* state=static_cast<const timeCompressorState_t*>(savedState);
+		source->restoreState(state->sourceState);
+		input=state->input;
+		inputPeriods=state->inputPeriods;
+		inputPos=state->inputPos;
+		output=state->output;
+		outputPos=state->outputPos;
+		remainingInputToCopy=state->remainingInputToCopy;
+		sourceEnded=state->sourceEnded;
+		endPending=state->endPending;
+	}
+
+	unsigned int generate(const unsigned int sampleCount, sample* sampleBuf) {
+		unsigned int produced=0;
+		while(produced<sampleCount) {
+			if(outputPos<output.size()) {
+				size_t n=output.size()-outputPos;
+				if(n>sampleCount-produced) n=sampleCount-produced;
+				for(size_t i=0;i<n;++i) sampleBuf[produced+i]=output[outputPos+i];
+				outputPos+=n;
+				produced+=(unsigned int)n;
+				continue;
+			}
+			output.clear();
+			outputPos=0;
+			if(endPending) {
+				endPending=false;
+				return produced;
+			}
+			double speed=factor;
+			if(speed<=1.0&&available()==0) {
+				// Bypass: render straight into the caller's buffer.
+				remainingInputToCopy=0;
+				unsigned int wanted=sampleCount-produced;
+				unsigned int n=source->generate(wanted,sampleBuf+produced);
+				produced+=n;
+				if(n<wanted) return produced;
+				continue;
+			}
+			if(speed<=1.0) {
+				// Speed-up was switched off: drain what is buffered first.
+				output.insert(output.end(),input.begin()+inputPos,input.end());
+				inputPos=input.size();
+				continue;
+			}
+			if(available()==0&&!sourceEnded) pull();
+			if(available()==0&&sourceEnded) {
+				sourceEnded=false;
+				remainingInputToCopy=0;
+				return produced;
+			}
+			step(speed);
+			if(sourceEnded&&available()==0) {
+				// Hand out what the last step produced, then report the end of the utterance.
+				sourceEnded=false;
+				remainingInputToCopy=0;
+				endPending=true;
+			}
+		}
+		return produced;
+	}
+
+};
+
+TimeCompressingWaveGenerator* TimeCompressingWaveGenerator::create(SpeechWaveGenerator* source, int sampleRate) {
+	return new TimeCompressingWaveGeneratorImpl(source,sampleRate);
+}
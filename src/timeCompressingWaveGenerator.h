@@ -0,0 +1,33 @@
+/*
+This file is a part of the NV Speech Player project.
+URL: https://bitbucket.org/nvaccess/speechplayer
+Copyright 2014 NV Access Limited.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 2.0, as published by
+the Free Software Foundation.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+This license can be found at:
+http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+*/
+
+#ifndef SPEECHPLAYER_TIMECOMPRESSINGWAVEGENERATOR_H
+#define SPEECHPLAYER_TIMECOMPRESSINGWAVEGENERATOR_H
+
+#include "speechWaveGenerator.h"
+
+/**
+ * Shortens the output of a SpeechWaveGenerator by a given factor without changing its pitch.
+ * Whole pitch periods are removed with a cross-fade (WSOLA style). The period length comes from
+ * the voicePitch the source is rendering, so no pitch detection is needed and at most two periods are buffered.
+ * With a factor of 1 the source is passed through untouched.
+ */
+class TimeCompressingWaveGenerator: public WaveGenerator {
+	public:
+	static TimeCompressingWaveGenerator* create(SpeechWaveGenerator* source, int sampleRate);
+	// factor is the speed-up (2 plays twice as fast); values below 1 are treated as 1. May be called from any thread.
+	virtual void setFactor(double factor)=0;
+};
+
+#endif
@@ -16,10 +16,115 @@ http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
 #define SPEECHPLAYER_UTILS_H
 
 #include <float.h>
+#include <math.h>
+#if defined(__SSE__)||defined(_M_X64)||(defined(_M_IX86_FP)&&_M_IX86_FP>=1)
+#define SPEECHPLAYER_HAVE_MXCSR
+#include <xmmintrin.h>
+#endif
 
 inline double calculateValueAtFadePosition(double oldVal, double newVal, double curFadeRatio) {
 	if(_isnan(newVal)) return oldVal;
 	return oldVal+((newVal-oldVal)*curFadeRatio);
 }
 
+/**
+ * The same linear congruential generator as the Microsoft C runtime's rand(), but with caller-owned state.
+ * Used where noise must be reproducible and must not share the runtime's global sequence with other threads.
+ */
+const int nextRandomMax=0x7fff;
+inline int nextRandom(unsigned int& state) {
+	state=state*214013u+2531011u;
+	return (int)((state>>16)&nextRandomMax);
+}
+
+/**
+ * Calculates the coefficients of a two-pole resonator (or its inverse, an antiresonator) for the given frequency and bandwidth in hz.
+ * Shared by every generator implementation so they all agree on the filter design.
+ */
+inline void calculateResonatorCoefficients(int sampleRate, double frequency, double bandwidth, bool anti, double& a, double& b, double& c) {
+	const double pi=3.14159265358979323846;
+	// A resonance at or above Nyquist would fold back down as an alias, so such a resonator passes its input through unchanged instead.
+	if(frequency>=sampleRate/2.0) {
+		a=1.0;
+		b=0.0;
+		c=0.0;
+		return;
+	}
+	// Add constant bandwidth to reduce "boxiness" and soften transient clicks
+	double effectiveBandwidth = bandwidth + 25.0;
+	double r=exp(-pi/sampleRate*effectiveBandwidth);
+	c=-(r*r);
+	b=r*cos((pi*2)/sampleRate*-frequency)*2.0;
+	a=1.0-b-c;
+	if(anti&&frequency!=0) {
+		a=1.0/a;
+		c*=-a;
+		b*=-a;
+	}
+}
+
+/**
+ * How many of the formants F1 to F6 can be heard at sampleRate. F5 and F6 are never placed below 3500 and 4500 hz,
+ * so once the Nyquist frequency is below that, their resonators only add aliasing and are left out of the generators.
+ * Formants beyond the returned count are not rendered, even if a frame asks for them lower down.
+ */
+inline int calculateAudibleFormants(int sampleRate) {
+	const double lowestFormantFrequencies[2]={3500,4500};
+	int numFormants=4;
+	while(numFormants<6&&lowestFormantFrequencies[numFormants-4]<sampleRate/2.0) ++numFormants;
+	return numFormants;
+}
+
+/**
+ * How far the voice source is into a trill closure at cyclePos (0 to 1) through a cycle of the trill LFO, from 0 (open) to 1 (closed).
+ * A cycle starts open and ends in closure; each edge is a linear ramp of 2 ms, at most 12% of the cycle, like the fades between the micro-frames the frontend used to emit.
+ * Shared by every generator implementation so they all modulate the same way.
+ */
+template<typename T> inline T calculateTrillClosure(T cyclePos, T rate, T closureFraction) {
+	if(closureFraction<=0) return 0;
+	if(closureFraction>1) closureFraction=1;
+	T edge=T(0.002)*rate;
+	if(edge>T(0.12)) edge=T(0.12);
+	if(edge>closureFraction/2) edge=closureFraction/2;
+	T closureStart=1-closureFraction;
+	if(cyclePos<closureStart) return 0;
+	if(cyclePos<closureStart+edge) return (cyclePos-closureStart)/edge;
+	if(cyclePos<1-edge) return 1;
+	return (1-cyclePos)/edge;
+}
+
+
+/**
+ * While in scope, the calling thread treats denormal floating point values as zero (flush-to-zero and denormals-are-zero),
+ * and the mode the caller had is put back on exit. Filter state that decays towards silence otherwise spends a long time
+ * in the denormal range, where x86 arithmetic is many times slower; in float that happens within milliseconds of a pause.
+ * Does nothing on targets where the mode is not known to be cheap to switch.
+ */
+class DenormalsAreZero {
+	private:
+#if defined(SPEECHPLAYER_HAVE_MXCSR)
+	unsigned int savedMode;
+	public:
+	DenormalsAreZero(): savedMode(_mm_getcsr()) {
+		_mm_setcsr(savedMode|0x8040);
+	}
+	~DenormalsAreZero() {
+		_mm_setcsr(savedMode);
+	}
+#elif defined(__aarch64__)&&(defined(__GNUC__)||defined(__clang__))
+	unsigned long long savedMode;
+	public:
+	DenormalsAreZero() {
+		__asm__ __volatile__("mrs %0, fpcr" : "=r"(savedMode));
+		unsigned long long mode=savedMode|(1ull<<24);
+		__asm__ __volatile__("msr fpcr, %0" : : "r"(mode));
+	}
+	~DenormalsAreZero() {
+		__asm__ __volatile__("msr fpcr, %0" : : "r"(savedMode));
+	}
+#else
+	public:
+	DenormalsAreZero() {}
+#endif
+};
 #endif
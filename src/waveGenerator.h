@@ -20,9 +20,28 @@ http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
 #include "speechPlayer.h"
 #include "lock.h"
 
+// Opaque copy of a generator's state, made by WaveGenerator::saveState.
+class WaveGeneratorState {
+	public:
+	virtual ~WaveGeneratorState() {};
+};
+
+// State saved by copying a whole generator, for generators whose members are all plain values.
+template<class G> class WaveGeneratorCopy: public WaveGeneratorState {
+	public:
+	G generator;
+	WaveGeneratorCopy(const G& generator): generator(generator) {}
+};
+
 class WaveGenerator {
 	public:
 	virtual unsigned int generate(const unsigned int bufSize, sample* buffer)=0;
+	// Drops all filter memories and buffered samples (including those of any source), so the next sample starts from silence.
+	virtual void reset()=0;
+	// Copies all filter memories and buffered samples (including those of any source). Settings such as the time compression factor are not part of the state.
+	virtual WaveGeneratorState* saveState()=0;
+	// Returns to a state saved from this generator; the state can be restored any number of times.
+	virtual void restoreState(const WaveGeneratorState* state)=0;
 	virtual ~WaveGenerator()=0 {};
 };
 
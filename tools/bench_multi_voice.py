@@ -0,0 +1,175 @@
+"""Time the multi-voice player against the same voices rendered by separate players.
+
+Usage:
+  python bench_multi_voice.py [--dll path/to/speechPlayer.dll] [--voices 4] [--rate 22050] [--repeat 5]
+
+Queues the frames of test_speakIpa.py (sampleIpa.txt) into every voice, each voice a few
+hertz higher than the one before so that the lanes do not carry identical data. It renders
+them once with speechPlayer_multiInitialize and once with one speechPlayer_initialize
+player per voice. It then prints the best of --repeat times for each, the speed of the
+multi-voice player relative to the separate players (above 1 means faster) and the SNR of
+each voice against its separate player.
+
+The separate players take their noise from the C runtime's rand() and the lanes from
+private generators, so aspiration and frication always differ and the SNR is a lower bound.
+Pass --no-noise to zero the noise amplitudes and compare the deterministic part alone.
+"""
+
+import argparse
+import ctypes
+import math
+import os
+import sys
+import time
+from ctypes import POINTER, byref, c_int, c_short, c_uint, c_void_p
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, REPO_ROOT)
+
+import speechPlayer  # noqa: E402
+import ipa  # noqa: E402
+
+BLOCK = 4096
+PITCH_STEP = 3.0
+
+
+def loadFrames(noNoise):
+    with open(os.path.join(REPO_ROOT, "sampleIpa.txt"), encoding="utf-8-sig") as f:
+        text = f.read()
+    frames = []
+    for line in text.splitlines():
+        for frame, minFrameDuration, fadeDuration in ipa.generateFramesAndTiming(line.strip(), speed=0.6):
+            if frame:
+                copy = speechPlayer.Frame()
+                ctypes.pointer(copy)[0] = frame
+                if noNoise:
+                    copy.aspirationAmplitude = 0
+                    copy.voiceTurbulenceAmplitude = 0
+                    copy.fricationAmplitude = 0
+                frame = copy
+            frames.append((frame, minFrameDuration, fadeDuration))
+        frames.append((None, 150, 0))
+    return frames
+
+
+def voiceFrames(frames, voice):
+    """Yields the frames for one voice, its pitch raised by voice*PITCH_STEP hertz."""
+    for frame, minFrameDuration, fadeDuration in frames:
+        if frame:
+            copy = speechPlayer.Frame()
+            ctypes.pointer(copy)[0] = frame
+            for name in ("voicePitch", "endVoicePitch", "midVoicePitch1", "midVoicePitch2"):
+                value = getattr(copy, name)
+                if value > 0:
+                    setattr(copy, name, value + voice * PITCH_STEP)
+            frame = copy
+        yield frame, minFrameDuration, fadeDuration
+
+
+def setupMulti(dll):
+    dll.speechPlayer_multiInitialize.argtypes = (c_int, c_int)
+    dll.speechPlayer_multiInitialize.restype = c_void_p
+    dll.speechPlayer_multiQueueFrame.argtypes = (c_void_p, c_int, POINTER(speechPlayer.Frame), c_uint, c_uint, c_int, ctypes.c_bool)
+    dll.speechPlayer_multiQueueFrame.restype = None
+    dll.speechPlayer_multiSynthesize.argtypes = (c_void_p, c_uint, POINTER(c_short), POINTER(c_int))
+    dll.speechPlayer_multiSynthesize.restype = c_int
+    dll.speechPlayer_multiTerminate.argtypes = (c_void_p,)
+    dll.speechPlayer_multiTerminate.restype = None
+
+
+def renderMulti(dll, frames, voices, rate):
+    handle = dll.speechPlayer_multiInitialize(rate, voices)
+    try:
+        for voice in range(voices):
+            for frame, minFrameDuration, fadeDuration in voiceFrames(frames, voice):
+                dll.speechPlayer_multiQueueFrame(
+                    handle,
+                    voice,
+                    byref(frame) if frame else None,
+                    int(minFrameDuration * rate / 1000.0),
+                    int(fadeDuration * rate / 1000.0),
+                    -1,
+                    False,
+                )
+        outputs = [[] for _ in range(voices)]
+        buf = (c_short * (BLOCK * voices))()
+        counts = (c_int * voices)()
+        elapsed = 0.0
+        while True:
+            start = time.perf_counter()
+            produced = dll.speechPlayer_multiSynthesize(handle, BLOCK, buf, counts)
+            elapsed += time.perf_counter() - start
+            if produced <= 0:
+                break
+            for voice in range(voices):
+                outputs[voice].extend(buf[voice * BLOCK:voice * BLOCK + counts[voice]])
+        return outputs, elapsed
+    finally:
+        dll.speechPlayer_multiTerminate(handle)
+
+
+def renderSeparate(frames, voices, rate):
+    players = [speechPlayer.SpeechPlayer(rate) for _ in range(voices)]
+    try:
+        for voice, player in enumerate(players):
+            for args in voiceFrames(frames, voice):
+                player.queueFrame(*args)
+        outputs = []
+        elapsed = 0.0
+        for player in players:
+            samples = []
+            while True:
+                start = time.perf_counter()
+                buf = player.synthesize(BLOCK)
+                elapsed += time.perf_counter() - start
+                if not buf:
+                    break
+                samples.extend(buf[:buf.length])
+            outputs.append(samples)
+        return outputs, elapsed
+    finally:
+        for player in players:
+            player.terminate()
+
+
+def snr(reference, candidate):
+    n = min(len(reference), len(candidate))
+    signal = sum(x * x for x in reference[:n])
+    noise = sum((x - y) ** 2 for x, y in zip(reference[:n], candidate[:n]))
+    if noise == 0:
+        return math.inf
+    return 10 * math.log10(signal / noise)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--dll", help="speechPlayer library to load (default: next to speechPlayer.py)")
+    parser.add_argument("--voices", type=int, default=4)
+    parser.add_argument("--rate", type=int, default=22050)
+    parser.add_argument("--repeat", type=int, default=5, help="renders per player; the fastest one is reported")
+    parser.add_argument("--no-noise", action="store_true", help="zero the noise amplitudes of every frame")
+    args = parser.parse_args()
+    if args.dll:
+        speechPlayer.dllPath = os.path.abspath(args.dll)
+    dll = ctypes.cdll.LoadLibrary(speechPlayer.dllPath)
+    setupMulti(dll)
+    frames = loadFrames(args.no_noise)
+    multiTime = separateTime = math.inf
+    # Alternate the players so that a slow patch on the machine hits both.
+    for _ in range(max(1, args.repeat)):
+        separate, elapsed = renderSeparate(frames, args.voices, args.rate)
+        separateTime = min(separateTime, elapsed)
+        multi, elapsed = renderMulti(dll, frames, args.voices, args.rate)
+        multiTime = min(multiTime, elapsed)
+    audioSeconds = sum(len(samples) for samples in separate) / args.rate
+    print(f"{args.voices} voices, {args.rate} Hz, {audioSeconds:.1f} s of audio in total")
+    print(
+        f"separate players {separateTime * 1000:8.1f} ms, multi-voice {multiTime * 1000:8.1f} ms,"
+        f" speed={separateTime / multiTime:5.2f}x"
+    )
+    ratios = " ".join(f"{snr(s, m):6.2f}" for s, m in zip(separate, multi))
+    print(f"SNR per voice (dB): {ratios}")
+
+
+if __name__ == "__main__":
+    main()
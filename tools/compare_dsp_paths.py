@@ -0,0 +1,164 @@
+"""Compare speechPlayer DSP engine variants against the double precision reference.
+
+Usage:
+  python compare_dsp_paths.py [--dll path/to/speechPlayer.dll] [--flags 0x2] [--reference 0x0] [--rate 22050] [--repeat 5]
+
+Renders the frame sequences of the repository's test scripts (test_sayHannah.py,
+test_playVowelchart.py and test_speakIpa.py with sampleIpa.txt) once with the reference
+engine (flags=0 unless --reference is given) and once with the given init flags, then prints
+the SNR of the candidate against the reference for each script. It also prints the time
+each render took, the best of --repeat renders, and the speed of the candidate relative to
+the reference (above 1 means faster). The default engine runs the cascade one sample at a time; compare the block
+cascade with --flags 0x8.
+
+Noise sources use the C runtime's rand(). The script reseeds it before each render when
+it can reach the runtime the DLL links against (ucrtbase on Windows, libc elsewhere).
+If it cannot, noisy segments will differ and the SNR is only a lower bound.
+"""
+
+import argparse
+import ctypes
+import ctypes.util
+import itertools
+import math
+import os
+import sys
+import time
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, REPO_ROOT)
+
+import speechPlayer  # noqa: E402
+import ipa  # noqa: E402
+
+
+def _findSrand():
+    names = ["ucrtbase", "msvcrt"] if sys.platform == "win32" else [ctypes.util.find_library("c")]
+    for name in names:
+        if not name:
+            continue
+        try:
+            return ctypes.CDLL(name).srand
+        except (OSError, AttributeError):
+            continue
+    return None
+
+
+def queueSayHannah(player):
+    frame = speechPlayer.Frame()
+    frame.outputGain = 1.0
+    frame.preFormantGain = 1.0
+    frame.vibratoPitchOffset = 0.1
+    frame.vibratoSpeed = 5.5
+    frame.voicePitch = 150
+    ipa.setFrame(frame, 'æ')
+    frame.voiceAmplitude = 0
+    player.queueFrame(frame, 120, 100)
+    frame.voiceAmplitude = 1
+    player.queueFrame(frame, 120, 40)
+    ipa.setFrame(frame, 'n')
+    frame.voicePitch = 100
+    player.queueFrame(frame, 120, 40)
+    ipa.setFrame(frame, 'ɑ')
+    frame.voicePitch = 90
+    player.queueFrame(frame, 80, 40)
+    player.queueFrame(None, 40, 40)
+
+
+def queueVowelChart(player, maxVowels=6):
+    frame = speechPlayer.Frame()
+    frame.preFormantGain = 1.0
+    frame.voiceAmplitude = 1.0
+    frame.outputGain = 1.0
+    vowels = list(ipa.iterPhonemes(_isVoiced=True))[:maxVowels]
+    for firstVowel, lastVowel in itertools.product(vowels, vowels):
+        frame.voicePitch = 40
+        frame.endVoicePitch = 300
+        ipa.setFrame(frame, firstVowel)
+        player.queueFrame(frame, 300, 50)
+        frame.voicePitch = 300
+        frame.endVoicePitch = 40
+        ipa.setFrame(frame, lastVowel)
+        player.queueFrame(frame, 500, 400)
+        player.queueFrame(None, 50, 50)
+
+
+def queueSpeakIpa(player):
+    with open(os.path.join(REPO_ROOT, "sampleIpa.txt"), encoding="utf-8-sig") as f:
+        text = f.read()
+    for line in text.splitlines():
+        for args in ipa.generateFramesAndTiming(line.strip(), speed=0.6):
+            player.queueFrame(*args)
+        player.queueFrame(None, 150, 0)
+
+
+SCRIPTS = [
+    ("test_sayHannah", queueSayHannah),
+    ("test_playVowelchart", queueVowelChart),
+    ("test_speakIpa", queueSpeakIpa),
+]
+
+
+def render(queueFunc, rate, flags, srand):
+    """Returns the rendered samples and the seconds spent inside synthesize."""
+    if srand:
+        srand(1)
+    player = speechPlayer.SpeechPlayer(rate, flags)
+    try:
+        queueFunc(player)
+        samples = []
+        elapsed = 0.0
+        while True:
+            start = time.perf_counter()
+            buf = player.synthesize(4096)
+            elapsed += time.perf_counter() - start
+            if not buf:
+                break
+            samples.extend(buf[:buf.length])
+        return samples, elapsed
+    finally:
+        player.terminate()
+
+
+def snr(reference, candidate):
+    n = min(len(reference), len(candidate))
+    signal = sum(x * x for x in reference[:n])
+    noise = sum((x - y) ** 2 for x, y in zip(reference[:n], candidate[:n]))
+    maxDiff = max((abs(x - y) for x, y in zip(reference[:n], candidate[:n])), default=0)
+    if noise == 0:
+        return math.inf, maxDiff
+    return 10 * math.log10(signal / noise), maxDiff
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--dll", help="speechPlayer library to load (default: next to speechPlayer.py)")
+    parser.add_argument("--flags", type=lambda s: int(s, 0), default=speechPlayer.INIT_FLOAT32)
+    parser.add_argument("--reference", type=lambda s: int(s, 0), default=0, help="init flags of the reference render")
+    parser.add_argument("--rate", type=int, default=22050)
+    parser.add_argument("--repeat", type=int, default=5, help="renders per engine; the fastest one is reported")
+    args = parser.parse_args()
+    if args.dll:
+        speechPlayer.dllPath = os.path.abspath(args.dll)
+    srand = _findSrand()
+    if not srand:
+        print("warning: could not reach the C runtime's srand; noise will differ between renders")
+    print(f"flags=0x{args.flags:x} vs reference flags=0x{args.reference:x}, {args.rate} Hz")
+    for name, queueFunc in SCRIPTS:
+        referenceTime = candidateTime = math.inf
+        # Alternate the engines so that a slow patch on the machine hits both.
+        for _ in range(max(1, args.repeat)):
+            reference, elapsed = render(queueFunc, args.rate, args.reference, srand)
+            referenceTime = min(referenceTime, elapsed)
+            candidate, elapsed = render(queueFunc, args.rate, args.flags, srand)
+            candidateTime = min(candidateTime, elapsed)
+        ratio, maxDiff = snr(reference, candidate)
+        print(
+            f"{name:22} samples={len(reference):8} SNR={ratio:7.2f} dB maxDiff={maxDiff}"
+            f" time={referenceTime * 1000:8.1f} ms -> {candidateTime * 1000:8.1f} ms"
+            f" speed={referenceTime / candidateTime:5.2f}x"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -582,6 +582,19 @@ static void onPlaySelectedPhoneme(AppController& app, bool fromLanguageList) {
 // -------------------------
 // Mapping operations
 // -------------------------
+// Mirror an in-memory edit into the loaded frontend pack, so Speak hears it
+// before the YAML is saved. Does nothing if the DLL predates overrides or the
+// edited language isn't the one loaded for speech.
+template <class Fn>
+static void previewEdit(AppController& app, Fn&& fn) {
+  if (!app.runtime.overridesSupported()) return;
+  if (!app.runtime.languageLoaded(selectedLangTagUtf8(app))) return;
+  std::string err;
+  if (!fn(err)) {
+    app.setStatus(L"Preview not updated: " + utf8ToWide(err));
+  }
+}
+
 static void onAddMapping(AppController& app, const std::string& defaultTo = {}) {
   if (!app.language.isLoaded()) {
     msgBox(app.wnd, L"Load a language first.", L"NVSP Phoneme Editor", MB_ICONINFORMATION);
@@ -598,6 +611,7 @@ static void onAddMapping(AppController& app, const std::string& defaultTo = {})
   app.repls.push_back(st.rule);
   app.language.setReplacements(app.repls);
   refreshLanguageDerivedLists(app);
+  previewEdit(app, [&](std::string& err) { return app.runtime.overrideReplacement(st.rule, false, err); });
 }
 
 static void onEditSelectedMapping(AppController& app) {
@@ -614,9 +628,13 @@ static void onEditSelectedMapping(AppController& app) {
   ShowAddMappingDialog(app.hInst, app.wnd, st);
   if (!st.ok) return;
 
+  const ReplacementRule before = app.repls[static_cast<size_t>(sel)];
   app.repls[static_cast<size_t>(sel)] = st.rule;
   app.language.setReplacements(app.repls);
   refreshLanguageDerivedLists(app);
+  previewEdit(app, [&](std::string& err) {
+    return app.runtime.overrideReplacement(before, true, err) && app.runtime.overrideReplacement(st.rule, false, err);
+  });
 }
 
 static void onRemoveSelectedMapping(AppController& app) {
@@ -626,9 +644,11 @@ static void onRemoveSelectedMapping(AppController& app) {
     return;
   }
 
+  const ReplacementRule removed = app.repls[static_cast<size_t>(sel)];
   app.repls.erase(app.repls.begin() + sel);
   app.language.setReplacements(app.repls);
   refreshLanguageDerivedLists(app);
+  previewEdit(app, [&](std::string& err) { return app.runtime.overrideReplacement(removed, true, err); });
 }
 
 // -------------------------
@@ -705,6 +725,12 @@ static void onEditLanguageSettings(AppController& app) {
 
   app.language.setSettings(st.settings);
   app.setStatus(L"Edited language settings in memory. Use File > Save language YAML (Ctrl+S) to write it.");
+  previewEdit(app, [&](std::string& err) {
+    for (const auto& kv : st.settings) {
+      if (!app.runtime.overrideSetting(kv.first, kv.second, err)) return false;
+    }
+    return true;
+  });
 }
 
 // -------------------------
@@ -760,6 +786,7 @@ static void onEditSelectedPhoneme(AppController& app, bool fromLanguageList) {
   if (!st.ok) return;
 
   *node = st.working;
+  previewEdit(app, [&](std::string& err) { return app.runtime.overridePhoneme(key, *node, err); });
   msgBox(app.wnd, L"Phoneme updated. Remember to save phonemes YAML.", L"NVSP Phoneme Editor", MB_ICONINFORMATION);
 }
 
@@ -841,6 +868,17 @@ static bool convertTextToIpaViaPhonemizer(AppController& app, const std::wstring
   cfg.argsStdinTemplate = readIni(L"phonemizer", L"argsStdin", L"");
   cfg.argsCliTemplate = readIni(L"phonemizer", L"argsCli", L"");
 
+  // Optional persistent workers (ini-only). Each worker speaks the framed
+  // protocol described in phonemizer_pool.h.
+  cfg.argsWorkerTemplate = readIni(L"phonemizer", L"argsWorker", L"");
+  int workers = readIniInt(L"phonemizer", L"workers", 2);
+  if (workers < 1) workers = 1;
+  if (workers > 16) workers = 16;
+  cfg.workerCount = static_cast<size_t>(workers);
+  int workerTimeoutMs = readIniInt(L"phonemizer", L"workerTimeoutMs", 10000);
+  if (workerTimeoutMs < 100) workerTimeoutMs = 100;
+  cfg.workerTimeoutMs = static_cast<unsigned>(workerTimeoutMs);
+
   // Default: use eSpeak NG CLI.
   if (cfg.exePath.empty()) {
     if (!ensureEspeakDir(app)) {
@@ -903,10 +941,13 @@ static bool synthIpaFromUi(AppController& app, std::vector<sample>& outSamples,
   }
 
   // Ensure runtime pack root and language.
+  // If the language is already loaded and the DLL supports overrides, keep it:
+  // unsaved edits are mirrored into it (see previewEdit), so re-reading the
+  // YAML would only drop them.
   std::string tmp;
   app.runtime.setPackRoot(runtimePackDir(app), tmp);
   std::string langTag = selectedLangTagUtf8(app);
-  if (!langTag.empty()) {
+  if (!langTag.empty() && !(app.runtime.overridesSupported() && app.runtime.languageLoaded(langTag))) {
     std::string errLang;
     app.runtime.setLanguage(langTag, errLang);
   }
@@ -1490,6 +1531,7 @@ LRESULT AppController::HandleMessage(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
       return 0;
 
     case WM_DESTROY:
+      nvsp_editor::shutdownPhonemizerWorkers();
       PostQuitMessage(0);
       return 0;
   }
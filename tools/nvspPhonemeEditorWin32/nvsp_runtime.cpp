@@ -110,6 +110,12 @@ static const FieldMap kFieldMap[] = {
   {"preFormantGain", &speechPlayer_frame_t::preFormantGain},
   {"outputGain", &speechPlayer_frame_t::outputGain},
   {"endVoicePitch", &speechPlayer_frame_t::endVoicePitch},
+  {"trillRate", &speechPlayer_frame_t::trillRate},
+  {"trillDepth", &speechPlayer_frame_t::trillDepth},
+  {"trillClosureFraction", &speechPlayer_frame_t::trillClosureFraction},
+  {"trillFricationFloor", &speechPlayer_frame_t::trillFricationFloor},
+  {"midVoicePitch1", &speechPlayer_frame_t::midVoicePitch1},
+  {"midVoicePitch2", &speechPlayer_frame_t::midVoicePitch2},
 };
 
 static size_t kFieldCount() {
@@ -234,6 +240,8 @@ void NvspRuntime::applySpeechSettingsToFrame(speechPlayer_frame_t& frame) const
   } else if (voice == "David") {
     mulByName("voicePitch", 0.75);
     mulByName("endVoicePitch", 0.75);
+    mulByName("midVoicePitch1", 0.75);
+    mulByName("midVoicePitch2", 0.75);
     mulByName("cf1", 0.75);
     mulByName("cf2", 0.85);
     mulByName("cf3", 0.85);
@@ -263,6 +271,7 @@ void NvspRuntime::unload() {
     m_feDestroy(m_feHandle);
     m_feHandle = nullptr;
   }
+  m_loadedLangTag.clear();
 
   m_spInitialize = nullptr;
   m_spQueueFrame = nullptr;
@@ -274,6 +283,11 @@ void NvspRuntime::unload() {
   m_feSetLanguage = nullptr;
   m_feQueueIPA = nullptr;
   m_feGetLastError = nullptr;
+  m_feOverridePhonemeField = nullptr;
+  m_feOverrideSetting = nullptr;
+  m_feOverrideReplacement = nullptr;
+  m_feOverrideRemoveReplacement = nullptr;
+  m_feRevertAllOverrides = nullptr;
 
   if (m_frontend) {
     FreeLibrary(m_frontend);
@@ -338,11 +352,20 @@ bool NvspRuntime::setDllDirectory(const std::wstring& dllDir, std::string& outEr
     return false;
   }
 
+  // Optional: live-edit overrides.
+  m_feOverridePhonemeField = reinterpret_cast<fe_overridePhonemeField_fn>(GetProcAddress(m_frontend, "nvspFrontend_overridePhonemeField"));
+  m_feOverrideSetting = reinterpret_cast<fe_overrideSetting_fn>(GetProcAddress(m_frontend, "nvspFrontend_overrideSetting"));
+  m_feOverrideReplacement = reinterpret_cast<fe_overrideReplacement_fn>(GetProcAddress(m_frontend, "nvspFrontend_overrideReplacement"));
+  m_feOverrideRemoveReplacement = reinterpret_cast<fe_overrideReplacement_fn>(GetProcAddress(m_frontend, "nvspFrontend_overrideRemoveReplacement"));
+  m_feRevertAllOverrides = reinterpret_cast<fe_revertAllOverrides_fn>(GetProcAddress(m_frontend, "nvspFrontend_revertAllOverrides"));
+
   return true;
 }
 
 bool NvspRuntime::setPackRoot(const std::wstring& packRootDir, std::string& outError) {
   outError.clear();
+  // Keep the handle (and any live-edit overrides) if nothing changed.
+  if (m_feHandle && packRootDir == m_packRoot) return true;
   m_packRoot = packRootDir;
 
   // Reset the frontend handle; it is tied to packDir.
@@ -350,6 +373,7 @@ bool NvspRuntime::setPackRoot(const std::wstring& packRootDir, std::string& outE
     m_feDestroy(m_feHandle);
     m_feHandle = nullptr;
   }
+  m_loadedLangTag.clear();
 
   return true;
 }
@@ -357,6 +381,7 @@ bool NvspRuntime::setPackRoot(const std::wstring& packRootDir, std::string& outE
 bool NvspRuntime::setLanguage(const std::string& langTagUtf8, std::string& outError) {
   outError.clear();
   m_langTag = langTagUtf8;
+  m_loadedLangTag.clear();
 
   if (!dllsLoaded()) {
     outError = "DLLs are not loaded";
@@ -384,11 +409,91 @@ bool NvspRuntime::setLanguage(const std::string& langTagUtf8, std::string& outEr
       outError = m_lastFrontendError.empty() ? "nvspFrontend_setLanguage failed" : m_lastFrontendError;
       return false;
     }
+    m_loadedLangTag = langTagUtf8;
   }
 
   return true;
 }
 
+bool NvspRuntime::overridesSupported() const {
+  return m_feHandle && m_feOverridePhonemeField && m_feOverrideSetting && m_feOverrideReplacement &&
+    m_feOverrideRemoveReplacement && m_feRevertAllOverrides;
+}
+
+bool NvspRuntime::overridePhoneme(const std::string& keyUtf8, const Node& phonemeMap, std::string& outError) {
+  outError.clear();
+  if (!overridesSupported()) {
+    outError = "nvspFrontend.dll does not support live-edit overrides";
+    return false;
+  }
+  if (!phonemeMap.isMap()) {
+    outError = "Phoneme is not a map";
+    return false;
+  }
+
+  static const char* const kFlagNames[] = {
+    "_isAfricate", "_isLiquid", "_isNasal", "_isSemivowel", "_isStop",
+    "_isTap", "_isTrill", "_isVoiced", "_isVowel", "_copyAdjacent",
+  };
+
+  auto apply = [&](const std::string& name) -> bool {
+    const Node* v = phonemeMap.get(name);
+    const char* value = (v && v->isScalar()) ? v->scalar.c_str() : nullptr;
+    if (m_feOverridePhonemeField(m_feHandle, keyUtf8.c_str(), name.c_str(), value)) return true;
+    const char* msg = m_feGetLastError(m_feHandle);
+    outError = name + ": " + (msg ? msg : "override failed");
+    return false;
+  };
+
+  for (const std::string& name : frameParamNames()) {
+    if (!apply(name)) return false;
+  }
+  for (const char* name : kFlagNames) {
+    if (!apply(name)) return false;
+  }
+  return true;
+}
+
+bool NvspRuntime::overrideSetting(const std::string& keyUtf8, const std::string& valueUtf8, std::string& outError) {
+  outError.clear();
+  if (!overridesSupported()) {
+    outError = "nvspFrontend.dll does not support live-edit overrides";
+    return false;
+  }
+  if (m_feOverrideSetting(m_feHandle, keyUtf8.c_str(), valueUtf8.c_str())) return true;
+  const char* msg = m_feGetLastError(m_feHandle);
+  outError = msg ? msg : "nvspFrontend_overrideSetting failed";
+  return false;
+}
+
+bool NvspRuntime::overrideReplacement(const ReplacementRule& rule, bool remove, std::string& outError) {
+  outError.clear();
+  if (!overridesSupported()) {
+    outError = "nvspFrontend.dll does not support live-edit overrides";
+    return false;
+  }
+
+  const char* to = rule.to.c_str();
+  nvspFrontend_ReplacementRule r{};
+  r.fromUtf8 = rule.from.c_str();
+  r.toUtf8 = &to;
+  r.toCount = 1;
+  r.atWordStart = rule.when.atWordStart ? 1 : 0;
+  r.atWordEnd = rule.when.atWordEnd ? 1 : 0;
+  r.beforeClassUtf8 = rule.when.beforeClass.c_str();
+  r.afterClassUtf8 = rule.when.afterClass.c_str();
+
+  fe_overrideReplacement_fn fn = remove ? m_feOverrideRemoveReplacement : m_feOverrideReplacement;
+  if (fn(m_feHandle, 0, &r)) return true;
+  const char* msg = m_feGetLastError(m_feHandle);
+  outError = msg ? msg : "nvspFrontend_overrideReplacement failed";
+  return false;
+}
+
+void NvspRuntime::revertAllOverrides() {
+  if (m_feHandle && m_feRevertAllOverrides) m_feRevertAllOverrides(m_feHandle);
+}
+
 bool NvspRuntime::dllsLoaded() const {
   return m_speechPlayer && m_frontend && m_spInitialize && m_spQueueFrame && m_spSynthesize && m_spTerminate && m_feCreate;
 }
@@ -656,6 +761,12 @@ static void __cdecl frameCallback(
     f.preFormantGain = frameOrNull->preFormantGain;
     f.outputGain = frameOrNull->outputGain;
     f.endVoicePitch = frameOrNull->endVoicePitch;
+    f.trillRate = frameOrNull->trillRate;
+    f.trillDepth = frameOrNull->trillDepth;
+    f.trillClosureFraction = frameOrNull->trillClosureFraction;
+    f.trillFricationFloor = frameOrNull->trillFricationFloor;
+    f.midVoicePitch1 = frameOrNull->midVoicePitch1;
+    f.midVoicePitch2 = frameOrNull->midVoicePitch2;
 
     if (ctx->runtime) {
       ctx->runtime->applySpeechSettingsToFrame(f);
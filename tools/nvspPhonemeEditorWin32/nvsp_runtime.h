@@ -55,6 +55,11 @@ using fe_queueIPA_fn = int(*)(
   void*
 );
 using fe_getLastError_fn = const char*(*)(nvspFrontend_handle_t);
+// Live-edit overrides (optional; older DLLs don't export them).
+using fe_overridePhonemeField_fn = int(*)(nvspFrontend_handle_t, const char*, const char*, const char*);
+using fe_overrideSetting_fn = int(*)(nvspFrontend_handle_t, const char*, const char*);
+using fe_overrideReplacement_fn = int(*)(nvspFrontend_handle_t, int, const nvspFrontend_ReplacementRule*);
+using fe_revertAllOverrides_fn = void(*)(nvspFrontend_handle_t);
 
 class NvspRuntime {
 public:
@@ -95,6 +100,23 @@ public:
     std::string& outError
   );
 
+  // Live-edit preview. These patch the loaded language in nvspFrontend.dll so
+  // the next synthIpa() hears unsaved edits, without writing or re-reading YAML.
+  // All overrides are dropped when the pack root or language is (re)loaded.
+  bool overridesSupported() const;
+  // Make the phoneme match phonemeMap: its fields and flags are set, and any
+  // field or flag it doesn't have is removed.
+  bool overridePhoneme(const std::string& keyUtf8, const Node& phonemeMap, std::string& outError);
+  bool overrideSetting(const std::string& keyUtf8, const std::string& valueUtf8, std::string& outError);
+  // Add/change (or remove) a normalization.replacements rule.
+  bool overrideReplacement(const ReplacementRule& rule, bool remove, std::string& outError);
+  void revertAllOverrides();
+
+  // True if langTagUtf8 is currently loaded (and possibly carries overrides).
+  bool languageLoaded(const std::string& langTagUtf8) const {
+    return m_feHandle && !m_loadedLangTag.empty() && m_loadedLangTag == langTagUtf8;
+  }
+
   // Last frontend error (if available).
   std::string lastFrontendError() const { return m_lastFrontendError; }
 
@@ -119,12 +141,19 @@ private:
   fe_setLanguage_fn m_feSetLanguage = nullptr;
   fe_queueIPA_fn m_feQueueIPA = nullptr;
   fe_getLastError_fn m_feGetLastError = nullptr;
+  fe_overridePhonemeField_fn m_feOverridePhonemeField = nullptr;
+  fe_overrideSetting_fn m_feOverrideSetting = nullptr;
+  fe_overrideReplacement_fn m_feOverrideReplacement = nullptr;
+  fe_overrideReplacement_fn m_feOverrideRemoveReplacement = nullptr;
+  fe_revertAllOverrides_fn m_feRevertAllOverrides = nullptr;
 
   // Runtime state
   nvspFrontend_handle_t m_feHandle = nullptr;
   std::string m_lastFrontendError;
   std::wstring m_packRoot;
   std::string m_langTag;
+  // Set once setLanguage() succeeded for m_langTag on the current handle.
+  std::string m_loadedLangTag;
 
   SpeechSettings m_speech;
 };
@@ -1,10 +1,13 @@
 #include "phonemizer_cli.h"
 
 #include "chunking.h"
+#include "phonemizer_pool.h"
 #include "process_util.h"
 #include "WinUtils.h" // wideToUtf8 / utf8ToWide
 
 #include <cwchar>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <vector>
 
@@ -182,6 +185,58 @@ static std::string trimAscii(const std::string& s) {
   return s.substr(a, b - a);
 }
 
+// Workers started for argsWorkerTemplate stay running between calls. The pool
+// is replaced when the executable, expanded arguments or limits change (for
+// example when the language changes).
+static std::mutex g_poolMu;
+static std::unique_ptr<PhonemizerPool> g_pool;
+
+static bool phonemizeChunksWithWorkers(
+  const CliPhonemizerConfig& cfg,
+  const std::wstring& langW,
+  const std::vector<TextChunk>& chunks,
+  std::vector<std::string>& outIpaUtf8,
+  std::string& outError
+) {
+  PhonemizerPoolConfig poolCfg;
+  poolCfg.exePath = cfg.exePath;
+  poolCfg.args = buildArgsFromTemplate(cfg, cfg.argsWorkerTemplate, langW, L"");
+  poolCfg.workerCount = cfg.workerCount;
+  poolCfg.requestTimeoutMs = cfg.workerTimeoutMs;
+
+  std::vector<std::string> texts;
+  texts.reserve(chunks.size());
+  for (const TextChunk& c : chunks) texts.push_back(wideToUtf8(c.text));
+
+  std::lock_guard<std::mutex> lock(g_poolMu);
+  if (!g_pool ||
+      g_pool->config().exePath != poolCfg.exePath ||
+      g_pool->config().args != poolCfg.args ||
+      g_pool->config().workerCount != poolCfg.workerCount ||
+      g_pool->config().requestTimeoutMs != poolCfg.requestTimeoutMs) {
+    g_pool.reset();
+    g_pool = std::make_unique<PhonemizerPool>(poolCfg);
+  }
+
+  if (!g_pool->phonemize(texts, outIpaUtf8, outError)) return false;
+
+  for (size_t i = 0; i < outIpaUtf8.size(); ++i) {
+    outIpaUtf8[i] = trimAscii(outIpaUtf8[i]);
+    if (outIpaUtf8[i].empty()) {
+      std::ostringstream oss;
+      oss << "Phonemizer worker produced empty output for chunk " << (i + 1) << " of " << outIpaUtf8.size() << ".";
+      outError = oss.str();
+      return false;
+    }
+  }
+  return true;
+}
+
+void shutdownPhonemizerWorkers() {
+  std::lock_guard<std::mutex> lock(g_poolMu);
+  g_pool.reset();
+}
+
 bool phonemizeTextToIpa(
   const CliPhonemizerConfig& cfg,
   const std::string& langTagUtf8,
@@ -206,6 +261,15 @@ bool phonemizeTextToIpa(
 
   const std::wstring langW = utf8ToWide(langTagUtf8);
 
+  // Persistent workers handle all chunks at once; the per-chunk process
+  // templates below remain the fallback.
+  std::vector<std::string> workerIpa;
+  std::string workerError;
+  bool haveWorkerIpa = false;
+  if (!cfg.argsWorkerTemplate.empty()) {
+    haveWorkerIpa = phonemizeChunksWithWorkers(cfg, langW, chunks, workerIpa, workerError);
+  }
+
   std::string joined;
   bool first = true;
 
@@ -274,7 +338,10 @@ bool phonemizeTextToIpa(
     };
 
     bool ok = false;
-    if (tryStdin()) {
+    if (haveWorkerIpa) {
+      chunkOut = std::move(workerIpa[i]);
+      ok = true;
+    } else if (tryStdin()) {
       ok = true;
     } else if (tryCli()) {
       ok = true;
@@ -284,6 +351,9 @@ bool phonemizeTextToIpa(
       std::ostringstream oss;
       oss << "Phonemizer failed on chunk " << (i + 1) << " of " << chunks.size() << ".";
 
+      if (!workerError.empty()) {
+        oss << "\n\nWorker attempt:\n" << workerError;
+      }
       if (!chunkErrStdin.empty()) {
         oss << "\n\nSTDIN attempt:\n" << chunkErrStdin;
       }
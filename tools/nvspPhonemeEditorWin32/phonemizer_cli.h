@@ -29,6 +29,16 @@ struct CliPhonemizerConfig {
   bool preferStdin = true;
   size_t maxChunkChars = 420;
 
+  // Optional persistent worker mode (see phonemizer_pool.h). When set, exePath
+  // is started with these arguments as a long-lived worker that speaks the
+  // framed stdin/stdout protocol. Chunks then go to workerCount workers
+  // concurrently instead of starting one process per chunk. {text}/{qtext}
+  // expand to nothing here. If the workers fail, the per-chunk templates
+  // above are used instead.
+  std::wstring argsWorkerTemplate;
+  size_t workerCount = 2;
+  unsigned workerTimeoutMs = 10000;
+
   // Optional context for placeholder expansion.
   std::wstring espeakDir;
   std::wstring espeakDataDir;
@@ -39,6 +49,7 @@ struct CliPhonemizerConfig {
 // - chunks text to keep invocations sane
 // - prefers stdin, but can fall back to args
 // - concatenates per-chunk results into one IPA string
+// - reuses running workers between calls when argsWorkerTemplate is set
 bool phonemizeTextToIpa(
   const CliPhonemizerConfig& cfg,
   const std::string& langTagUtf8,
@@ -47,4 +58,7 @@ bool phonemizeTextToIpa(
   std::string& outError
 );
 
+// Stop the worker processes kept by phonemizeTextToIpa (e.g. on exit).
+void shutdownPhonemizerWorkers();
+
 } // namespace nvsp_editor
@@ -0,0 +1,190 @@
+#include "phonemizer_pool.h"
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+#include "phonemizer_worker.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include "utf8.h"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace nvsp_editor {
+
+using nvsp_frontend::PhonemizerWorker;
+
+namespace {
+
+#ifdef _WIN32
+
+std::wstring quoteArg(const std::wstring& s) {
+  // Same simple quoting as process_util.cpp.
+  if (s.empty()) return L"\"\"";
+  bool needs = false;
+  for (wchar_t c : s) {
+    if (c == L' ' || c == L'\t' || c == L'\n' || c == L'\v' || c == L'\"') {
+      needs = true;
+      break;
+    }
+  }
+  if (!needs) return s;
+
+  std::wstring out = L"\"";
+  for (wchar_t c : s) {
+    if (c == L'\"') out += L"\\\"";
+    else out.push_back(c);
+  }
+  out += L"\"";
+  return out;
+}
+
+std::string toUtf8(const std::wstring& w) {
+  if (w.empty()) return std::string();
+  const int n = WideCharToMultiByte(CP_UTF8, 0, w.data(), static_cast<int>(w.size()), nullptr, 0, nullptr, nullptr);
+  std::string out(static_cast<size_t>(n > 0 ? n : 0), '\0');
+  if (n > 0) WideCharToMultiByte(CP_UTF8, 0, w.data(), static_cast<int>(w.size()), &out[0], n, nullptr, nullptr);
+  return out;
+}
+
+#else
+
+std::string toUtf8(const std::wstring& w) {
+  // wchar_t holds UTF-32 code points on POSIX systems.
+  return nvsp_frontend::u32ToUtf8(std::u32string(w.begin(), w.end()));
+}
+
+std::string shellQuote(const std::string& s) {
+  std::string out = "'";
+  for (char c : s) {
+    if (c == '\'') out += "'\\''";
+    else out.push_back(c);
+  }
+  out += "'";
+  return out;
+}
+
+#endif
+
+// The worker command line for cfg, with the executable quoted for the
+// platform's parser (CreateProcess or /bin/sh) and the argument templates as is.
+std::string commandLine(const PhonemizerPoolConfig& cfg) {
+#ifdef _WIN32
+  std::wstring cmd = quoteArg(cfg.exePath);
+  if (!cfg.args.empty()) {
+    cmd += L" ";
+    cmd += cfg.args;
+  }
+  return toUtf8(cmd);
+#else
+  std::string cmd = shellQuote(toUtf8(cfg.exePath));
+  if (!cfg.args.empty()) {
+    cmd += " ";
+    cmd += toUtf8(cfg.args);
+  }
+  return cmd;
+#endif
+}
+
+bool startWorker(PhonemizerWorker& w, const PhonemizerPoolConfig& cfg, std::string& outError) {
+  // Workers run in the executable's folder, where wrapper scripts tend to keep their data.
+  std::string cwd;
+  try {
+    cwd = toUtf8(fs::path(cfg.exePath).parent_path().wstring());
+  } catch (...) {
+    cwd.clear();
+  }
+  return w.start(commandLine(cfg), cwd, outError);
+}
+
+} // namespace
+
+PhonemizerPool::PhonemizerPool(const PhonemizerPoolConfig& cfg) : m_cfg(cfg) {
+  if (m_cfg.workerCount < 1) m_cfg.workerCount = 1;
+  if (m_cfg.requestTimeoutMs < 1) m_cfg.requestTimeoutMs = 1;
+  for (size_t i = 0; i < m_cfg.workerCount; ++i) {
+    m_workers.push_back(std::make_unique<PhonemizerWorker>());
+  }
+}
+
+PhonemizerPool::~PhonemizerPool() {
+  shutdown();
+}
+
+void PhonemizerPool::shutdown() {
+  std::lock_guard<std::mutex> lock(m_mu);
+  for (auto& w : m_workers) w->stop();
+}
+
+bool PhonemizerPool::phonemize(
+  const std::vector<std::string>& chunksUtf8,
+  std::vector<std::string>& outIpaUtf8,
+  std::string& outError
+) {
+  outError.clear();
+  outIpaUtf8.assign(chunksUtf8.size(), std::string());
+  if (chunksUtf8.empty()) return true;
+
+  std::lock_guard<std::mutex> lock(m_mu);
+
+  std::vector<std::string> errors(chunksUtf8.size());
+  std::atomic<size_t> next{0};
+  std::atomic<bool> failed{false};
+
+  // Each thread owns one worker and takes the next unclaimed chunk, so the
+  // results land in order regardless of which worker finishes first.
+  auto serve = [&](PhonemizerWorker& w) {
+    while (!failed.load()) {
+      const size_t i = next.fetch_add(1);
+      if (i >= chunksUtf8.size()) break;
+
+      bool ok = false;
+      for (int attempt = 0; attempt < 2 && !ok; ++attempt) {
+        std::string err;
+        if (!w.running() && !startWorker(w, m_cfg, err)) {
+          errors[i] = err;
+          break;
+        }
+        bool protocolOk = false;
+        ok = w.request(chunksUtf8[i], m_cfg.requestTimeoutMs, outIpaUtf8[i], err, protocolOk);
+        if (!ok) {
+          errors[i] = err;
+          // The worker answered with an error: retrying won't help.
+          if (protocolOk) break;
+          w.stop();
+        }
+      }
+      if (ok) errors[i].clear();
+      else failed.store(true);
+    }
+  };
+
+  const size_t active = (chunksUtf8.size() < m_workers.size()) ? chunksUtf8.size() : m_workers.size();
+  std::vector<std::thread> threads;
+  threads.reserve(active - 1);
+  for (size_t t = 1; t < active; ++t) {
+    threads.emplace_back(serve, std::ref(*m_workers[t]));
+  }
+  serve(*m_workers[0]);
+  for (auto& th : threads) th.join();
+
+  if (failed.load()) {
+    for (size_t i = 0; i < errors.size(); ++i) {
+      if (errors[i].empty()) continue;
+      std::ostringstream oss;
+      oss << "Phonemizer worker failed on chunk " << (i + 1) << " of " << chunksUtf8.size() << ".\n\n" << errors[i];
+      outError = oss.str();
+      break;
+    }
+    return false;
+  }
+  return true;
+}
+
+} // namespace nvsp_editor
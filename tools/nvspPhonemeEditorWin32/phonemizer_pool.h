@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nvsp_frontend {
+class PhonemizerWorker;
+}
+
+namespace nvsp_editor {
+
+// A pool of long-lived phonemizer processes.
+//
+// Starting a phonemizer process for every chunk costs far more than the
+// phonemization itself, so "speak window" latency is dominated by process
+// startup. A worker instead stays running and handles one request after
+// another over its stdin/stdout pipes, and several workers handle the chunks
+// of one text concurrently.
+//
+// Each worker is an nvsp_frontend::PhonemizerWorker (src/frontend), which
+// documents the protocol. Any executable that implements it can be used, for
+// example a small wrapper script around a phonemizer library. Worker stderr is
+// discarded on Windows and inherited elsewhere.
+//
+// The pool does not depend on the Win32 GUI code, so it also builds on POSIX
+// systems, where it can be exercised with a stub worker script.
+struct PhonemizerPoolConfig {
+  std::wstring exePath;
+  // Command-line arguments (without the exe name), already expanded.
+  std::wstring args;
+
+  size_t workerCount = 2;
+
+  // A worker that takes longer than this for one request is killed and restarted.
+  unsigned requestTimeoutMs = 10000;
+};
+
+class PhonemizerPool {
+public:
+  explicit PhonemizerPool(const PhonemizerPoolConfig& cfg);
+  ~PhonemizerPool();
+
+  PhonemizerPool(const PhonemizerPool&) = delete;
+  PhonemizerPool& operator=(const PhonemizerPool&) = delete;
+
+  const PhonemizerPoolConfig& config() const { return m_cfg; }
+
+  // Phonemize each chunk. Chunks are spread over the workers and run
+  // concurrently; outIpaUtf8[i] always holds the result for chunksUtf8[i].
+  //
+  // Workers are started on first use. A worker that exits, breaks the
+  // protocol or times out is restarted and the chunk is tried once more.
+  bool phonemize(
+    const std::vector<std::string>& chunksUtf8,
+    std::vector<std::string>& outIpaUtf8,
+    std::string& outError
+  );
+
+  // Stop all worker processes. They are restarted by the next phonemize().
+  void shutdown();
+
+private:
+  PhonemizerPoolConfig m_cfg;
+  std::vector<std::unique_ptr<nvsp_frontend::PhonemizerWorker>> m_workers;
+  // One batch at a time: each worker serves a single chunk at once.
+  std::mutex m_mu;
+};
+
+} // namespace nvsp_editor
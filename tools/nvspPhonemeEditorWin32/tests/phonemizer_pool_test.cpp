@@ -0,0 +1,175 @@
+// Exercises PhonemizerPool against stub_worker.py: in-order reassembly across
+// workers, recovery from a worker that dies or hangs, and error reporting.
+//
+// Usage: phonemizer_pool_test PYTHON STUB_WORKER_SCRIPT
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "phonemizer_pool.h"
+
+namespace fs = std::filesystem;
+using nvsp_editor::PhonemizerPool;
+using nvsp_editor::PhonemizerPoolConfig;
+
+static int g_failures = 0;
+
+#define CHECK(cond, what)                                        \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      std::fprintf(stderr, "FAIL %s: %s\n", (what), #cond);      \
+      ++g_failures;                                              \
+    }                                                            \
+  } while (0)
+
+static std::wstring widen(const std::string& s) {
+  // Test paths are ASCII.
+  return std::wstring(s.begin(), s.end());
+}
+
+static std::string shellQuote(const std::string& s) {
+  std::string out = "'";
+  for (char c : s) {
+    if (c == '\'') out += "'\\''";
+    else out.push_back(c);
+  }
+  out += "'";
+  return out;
+}
+
+// What the stub worker answers for a request it handles normally.
+static std::string expectedIpa(const std::string& text) {
+  std::string out;
+  size_t i = 0;
+  while (i < text.size()) {
+    while (i < text.size() && text[i] == ' ') ++i;
+    if (i >= text.size()) break;
+    size_t j = text.find(' ', i);
+    if (j == std::string::npos) j = text.size();
+    if (!out.empty()) out += " ";
+    out += "\xCB\x88"; // ˈ
+    out += text.substr(i, j - i);
+    i = j;
+  }
+  return out;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::fprintf(stderr, "usage: %s PYTHON STUB_WORKER_SCRIPT\n", argv[0]);
+    return 2;
+  }
+
+  const fs::path stateDir = fs::temp_directory_path() / ("nvsp_pool_test_" + std::to_string(
+    std::chrono::steady_clock::now().time_since_epoch().count()));
+  fs::create_directories(stateDir);
+
+  PhonemizerPoolConfig cfg;
+  cfg.exePath = widen(argv[1]);
+  cfg.args = widen(shellQuote(argv[2]) + " " + shellQuote(stateDir.string()));
+  cfg.workerCount = 3;
+  cfg.requestTimeoutMs = 2000;
+  PhonemizerPool pool(cfg);
+
+  std::vector<std::string> out;
+  std::string err;
+
+  // Results come back in chunk order even though slow chunks finish last.
+  {
+    std::vector<std::string> chunks;
+    for (int i = 0; i < 24; ++i) {
+      std::string c = "chunk" + std::to_string(i) + " text";
+      if (i % 3 == 0) c += " slow";
+      chunks.push_back(c);
+    }
+    const bool ok = pool.phonemize(chunks, out, err);
+    CHECK(ok, "ordering");
+    CHECK(out.size() == chunks.size(), "ordering");
+    for (size_t i = 0; ok && i < chunks.size(); ++i) {
+      CHECK(out[i] == expectedIpa(chunks[i]), "ordering");
+    }
+  }
+
+  // A worker that dies mid-request is restarted and the chunk retried.
+  {
+    const std::vector<std::string> chunks = {"before", "then die-once here", "after"};
+    const bool ok = pool.phonemize(chunks, out, err);
+    CHECK(ok, "killed worker");
+    for (size_t i = 0; ok && i < chunks.size(); ++i) {
+      CHECK(out[i] == expectedIpa(chunks[i]), "killed worker");
+    }
+  }
+
+  // A hung worker is killed after the timeout, restarted and retried.
+  {
+    const std::vector<std::string> chunks = {"one", "two hang-once", "three"};
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = pool.phonemize(chunks, out, err);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(ok, "hung worker");
+    for (size_t i = 0; ok && i < chunks.size(); ++i) {
+      CHECK(out[i] == expectedIpa(chunks[i]), "hung worker");
+    }
+    CHECK(elapsed >= std::chrono::milliseconds(cfg.requestTimeoutMs), "hung worker");
+    CHECK(elapsed < std::chrono::seconds(30), "hung worker");
+  }
+
+  // Writing to a worker that has closed its stdin fails with EPIPE instead of
+  // raising SIGPIPE, which would kill this process. The worker is restarted,
+  // and the signal mask is left as it was with no SIGPIPE pending.
+  {
+    bool ok = pool.phonemize({"hang-up"}, out, err);
+    CHECK(ok, "closed pipe");
+    ok = pool.phonemize({"after the hang-up"}, out, err);
+    CHECK(ok, "closed pipe");
+    CHECK(ok && out[0] == expectedIpa("after the hang-up"), "closed pipe");
+    sigset_t pending;
+    sigset_t mask;
+    sigpending(&pending);
+    pthread_sigmask(SIG_BLOCK, nullptr, &mask);
+    CHECK(!sigismember(&pending, SIGPIPE), "closed pipe");
+    CHECK(!sigismember(&mask, SIGPIPE), "closed pipe");
+  }
+
+  // A worker that dies again on the retry fails the batch, naming the chunk.
+  {
+    const std::vector<std::string> chunks = {"fine", "always die"};
+    const bool ok = pool.phonemize(chunks, out, err);
+    CHECK(!ok, "dead worker");
+    CHECK(err.find("chunk 2 of 2") != std::string::npos, "dead worker");
+  }
+
+  // An error response is reported as is and is not retried.
+  {
+    const std::vector<std::string> chunks = {"boom"};
+    const bool ok = pool.phonemize(chunks, out, err);
+    CHECK(!ok, "error response");
+    CHECK(err.find("stub worker: boom") != std::string::npos, "error response");
+  }
+
+  // The pool is still usable after failures and after a shutdown.
+  {
+    pool.shutdown();
+    const std::vector<std::string> chunks = {"back again", "and again"};
+    const bool ok = pool.phonemize(chunks, out, err);
+    CHECK(ok, "after failures");
+    for (size_t i = 0; ok && i < chunks.size(); ++i) {
+      CHECK(out[i] == expectedIpa(chunks[i]), "after failures");
+    }
+  }
+
+  pool.shutdown();
+  std::error_code ec;
+  fs::remove_all(stateDir, ec);
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+    return 1;
+  }
+  std::printf("phonemizer pool: all checks passed\n");
+  return 0;
+}
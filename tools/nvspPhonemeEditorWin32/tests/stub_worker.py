@@ -0,0 +1,65 @@
+"""Stub phonemizer worker for testing PhonemizerPool (see phonemizer_pool.h).
+
+Usage: stub_worker.py STATE_DIR
+
+Speaks the pool's length-prefixed protocol on stdin/stdout. Each word of the
+request becomes "ˈ" + the lowercased word, so results are easy to predict.
+Some words change the worker's behaviour:
+  slow       sleep 0.2 s before answering, so workers finish out of order
+  boom       answer with an error response
+  die        exit without answering
+  die-once   exit without answering the first time this request is seen
+  hang-once  stop responding the first time this request is seen
+  hang-up    close stdin, answer, then exit shortly after, so the next
+             request is written to a closed pipe
+"Seen" is tracked with marker files in STATE_DIR, so it survives restarts.
+"""
+
+import hashlib
+import os
+import sys
+import time
+
+
+def seenBefore(stateDir, text):
+    marker = os.path.join(stateDir, hashlib.sha1(text.encode("utf-8")).hexdigest())
+    if os.path.exists(marker):
+        return True
+    open(marker, "w").close()
+    return False
+
+
+def main():
+    stateDir = sys.argv[1]
+    inp = sys.stdin.buffer
+    out = sys.stdout.buffer
+    while True:
+        line = inp.readline()
+        if not line:
+            break
+        text = inp.read(int(line)).decode("utf-8")
+        words = text.split()
+        if "die" in words:
+            sys.exit(1)
+        if ("die-once" in words or "hang-once" in words) and not seenBefore(stateDir, text):
+            if "die-once" in words:
+                sys.exit(1)
+            time.sleep(60)
+        if "hang-up" in words:
+            os.close(0)
+        if "slow" in words:
+            time.sleep(0.2)
+        if "boom" in words:
+            msg = b"stub worker: boom"
+            out.write(b"!%d\n" % len(msg) + msg)
+        else:
+            ipa = " ".join("ˈ" + w.lower() for w in words).encode("utf-8")
+            out.write(b"%d\n" % len(ipa) + ipa)
+        out.flush()
+        if "hang-up" in words:
+            time.sleep(0.5)
+            break
+
+
+if __name__ == "__main__":
+    main()